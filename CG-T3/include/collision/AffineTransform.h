@@ -0,0 +1,45 @@
+#ifndef AFFINETRANSFORM_H_INCLUDED
+#define AFFINETRANSFORM_H_INCLUDED
+
+/*
+*   Classe que representa uma transformação afim 3D (matriz 3x4)
+*
+*   Cada operação é composta à esquerda da transformação atual, ou seja,
+*   acompanha na mesma ordem as operações aplicadas nos vértices de um objeto
+*/
+class AffineTransform
+{
+    private:
+        // Linhas da matriz (3x3 de rotação/escala e a coluna de translação)
+        double m[3][4];
+    public:
+        // Cria uma transformação identidade
+        AffineTransform();
+
+        // Redefine a transformação como identidade
+        void setIdentity();
+
+        // Compõe uma escala em cada eixo
+        void scale(double sx, double sy, double sz);
+        // Compõe uma translação
+        void translate(double dx, double dy, double dz);
+        // Compõe uma rotação em torno dos eixos X, Y e Z (ângulo em radianos)
+        void rotateX(double angle);
+        void rotateY(double angle);
+        void rotateZ(double angle);
+
+        // Aplica a transformação em um ponto
+        void transformPoint(const double in[3], double out[3]) const;
+        // Aplica apenas a parte linear da transformação em um vetor
+        void transformVector(const double in[3], double out[3]) const;
+        // Aplica a transposta da parte linear em um vetor
+        void transformVectorTransposed(const double in[3], double out[3]) const;
+
+        // Obtém a transformação inversa. Retorna false se a matriz for singular
+        bool inverse(AffineTransform &out) const;
+
+        // Obtém a matriz 4x4 no formato do OpenGL (por colunas)
+        void getMatrix(double matrix[16]) const;
+};
+
+#endif // AFFINETRANSFORM_H_INCLUDED
@@ -16,8 +16,22 @@ class BoundingBox
         BoundingBox(Vertex3D center, double width, double length, double height);
         // Atualiza a bounding box
         void updateBox(Vertex3D c0, double width, double length, double height);
+
+        // Obtm o centro e as dimenses da bounding box
+        Vertex3D getCenter();
+        double getWidth();
+        double getLength();
+        double getHeight();
+
+        // Obtm os valores mnimo e mximo em cada eixo
+        void getMinMax(double min[3], double max[3]);
+
         // Verifica se a bounding box colide com outra bounding box
         bool hit(BoundingBox *otherBox);
+
+        // Obtm o instante de impacto (entre 0 e 1) da bounding box deslocada por displacement contra
+        // outra bounding box parada. Retorna 1 se no houver impacto ou se as caixas j se sobrepem
+        double sweep(BoundingBox *otherBox, const double displacement[3]);
 };
 
 #endif // BOUNDINGBOX_H_INCLUDED
@@ -4,6 +4,17 @@
 #include "../primitive/Vertex3D.h"
 #include "../collision/BoundingBox.h"
 
+// Nvel de detalhe usado nos testes de coliso
+enum CollisionDetail
+{
+    // Apenas a bounding box do objeto
+    BoxCollision = 0,
+    // Envoltrias convexas da malha, quando existirem
+    HullCollision = 1,
+    // Tringulos da malha, quando existir a BVH
+    MeshCollision = 2
+};
+
 class Collider
 {
     private:
@@ -16,6 +27,14 @@ class Collider
 
         // Obtm a bounding box definida pela classe filha
         virtual BoundingBox* getCollider() = 0;
+
+        // Verifica se o objeto colide com uma bounding box (por padro, apenas pela bounding box do objeto)
+        virtual bool collide(BoundingBox *box, CollisionDetail detail);
+
+        // Obtm o instante de impacto (entre 0 e 1) da bounding box deslocada por displacement.
+        // A bounding box do objeto d o primeiro contato possvel, refinado com collide
+        // em amostras que no pulam paredes finas. Retorna 1 se no houver impacto
+        virtual double sweep(BoundingBox *box, const double displacement[3], CollisionDetail detail);
 };
 
 #endif // COLLIDER_H_INCLUDED
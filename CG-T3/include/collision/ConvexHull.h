@@ -0,0 +1,52 @@
+#ifndef CONVEXHULL_H_INCLUDED
+#define CONVEXHULL_H_INCLUDED
+
+#include <vector>
+#include <functional>
+
+#include "BoundingBox.h"
+#include "AffineTransform.h"
+
+/*
+*   Envoltória convexa simplificada usada como aproximação de colisão de uma malha
+*
+*   É gerada pelo algoritmo quickhull, que adiciona primeiro os pontos mais
+*   distantes da envoltória atual e para quando atinge o limite de vértices
+*/
+class ConvexHull
+{
+    private:
+        // Vértices da envoltória no espaço local da malha (3 valores por vértice)
+        std::vector<double> vertexList;
+
+        // Obtém o vértice mais distante na direção informada (espaço local)
+        void support(const double dir[3], double out[3]);
+    public:
+        // Gera a envoltória de um conjunto de pontos (3 valores por ponto) limitada a maxVertices vértices
+        ConvexHull(const std::vector<double> &pointList, int maxVertices);
+
+        // Gera hullCount envoltórias de uma malha (9 valores por triângulo), dividindo os
+        // triângulos em fatias ao longo do eixo de maior extensão
+        static std::vector<ConvexHull*> fromTriangles(const std::vector<double> &triangleList, int maxVertices, int hullCount);
+        // Gera hullCount envoltórias de uma malha indexada (3 índices por triângulo) como fromTriangles,
+        // obtendo cada vértice de getVertex e sem repetir os vértices compartilhados entre triângulos
+        static std::vector<ConvexHull*> fromIndexedTriangles(const std::function<void(unsigned int, double*)> &getVertex, unsigned int vertexCount,
+                                                             const unsigned int *indexList, int triangleCount, int maxVertices, int hullCount);
+
+        // Obtém a quantidade de vértices da envoltória
+        int getVertexCount();
+        // Obtém a lista de vértices da envoltória
+        std::vector<double>* getVertexList();
+
+        // Aplica uma escala seguida de uma translação nos vértices da envoltória
+        void scale(double sx, double sy, double sz);
+        void translate(double dx, double dy, double dz);
+
+        // Obtém a caixa envolvente da envoltória no espaço do mundo
+        void getBounds(const AffineTransform &transform, double min[3], double max[3]);
+
+        // Verifica (GJK) se a envoltória, com a transformação da instância, colide com a bounding box
+        bool hit(BoundingBox *box, const AffineTransform &transform);
+};
+
+#endif // CONVEXHULL_H_INCLUDED
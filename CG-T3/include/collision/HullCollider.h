@@ -0,0 +1,38 @@
+#ifndef HULLCOLLIDER_H_INCLUDED
+#define HULLCOLLIDER_H_INCLUDED
+
+#include <vector>
+
+#include "Collider.h"
+#include "ConvexHull.h"
+#include "AffineTransform.h"
+
+/*
+*   Colisor formado por envoltórias convexas posicionadas por uma transformação
+*
+*   Usado pelos modelos que são desenhados com transformações do OpenGL
+*   (e não possuem vértices no espaço do mundo), como as estátuas OBJ
+*/
+class HullCollider : public Collider
+{
+    private:
+        // Envoltórias no espaço local do modelo (não pertencem ao colisor)
+        std::vector<ConvexHull*> hullList;
+        // Transformação do espaço local do modelo para o espaço do mundo
+        AffineTransform transform;
+    public:
+        HullCollider();
+
+        // Adiciona uma envoltória ao colisor
+        void addConvexHull(ConvexHull *hull);
+        int getConvexHullCount();
+
+        // Obtém a transformação do modelo, que deve acompanhar a usada no desenho
+        AffineTransform* getTransform();
+
+        // Obtém a caixa envolvente das envoltórias no espaço do mundo
+        BoundingBox* getCollider();
+        bool collide(BoundingBox *box, CollisionDetail detail);
+};
+
+#endif // HULLCOLLIDER_H_INCLUDED
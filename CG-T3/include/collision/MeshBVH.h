@@ -0,0 +1,71 @@
+#ifndef MESHBVH_H_INCLUDED
+#define MESHBVH_H_INCLUDED
+
+#include <vector>
+
+#include "BoundingBox.h"
+#include "AffineTransform.h"
+
+#include "../primitive/Primitive.h"
+
+// Quantidade máxima de triângulos em uma folha da BVH
+#define MESH_BVH_LEAF_SIZE 4
+
+// Nó da BVH. Em nós internos, leftFirst é o filho da esquerda (o da direita é leftFirst + 1).
+// Em folhas, leftFirst é o primeiro triângulo e triangleCount é a quantidade de triângulos
+struct MeshBVHNode
+{
+    float bmin[3], bmax[3];
+    int leftFirst;
+    int triangleCount;
+};
+
+/*
+*   Hierarquia de volumes envolventes (BVH) dos triângulos de uma malha
+*
+*   É construída uma única vez no espaço local da malha e compartilhada pelas
+*   instâncias do objeto, que informam a sua transformação nas consultas
+*/
+class MeshBVH
+{
+    private:
+        // Coordenadas dos três vértices de cada triângulo (9 valores por triângulo)
+        std::vector<float> triangleVertexList;
+        // Centróide de cada triângulo
+        std::vector<float> centroidList;
+        // Face da malha de origem de cada triângulo
+        std::vector<int> triangleFaceList;
+        // Ordem dos triângulos referenciada pelas folhas
+        std::vector<int> triangleIndexList;
+        // Nós da árvore (o nó 0 é a raiz)
+        std::vector<MeshBVHNode> nodeList;
+
+        void updateNodeBounds(int nodeIndex);
+        void subdivide(int nodeIndex);
+
+        // Obtém os vértices de um triângulo transformados pela transformação da instância
+        void getTriangle(int triangleIndex, const AffineTransform &transform, double v[3][3]);
+    public:
+        // Constrói a BVH a partir das faces da malha (polígonos são divididos em leque),
+        // levando os vértices para o espaço local pela transformação toLocal
+        MeshBVH(std::vector<Primitive*> *faceList, const AffineTransform &toLocal);
+
+        // Obtém a quantidade de triângulos e de nós da BVH
+        int getTriangleCount();
+        int getNodeCount();
+
+        // Obtém a caixa envolvente da malha no espaço do mundo
+        void getBounds(const AffineTransform &transform, double min[3], double max[3]);
+
+        // Verifica se alguma face da malha (com a transformação da instância) colide com a bounding box
+        bool hit(BoundingBox *box, const AffineTransform &transform);
+
+        // Lança um raio (no espaço do mundo) contra a malha. Se houver uma interseção mais próxima que
+        // distance, atualiza distance (em unidades da direção) e a face atingida
+        bool raycast(const double origin[3], const double direction[3], const AffineTransform &transform, double &distance, int &faceIndex);
+
+        // Interseção de um raio com um triângulo (Möller-Trumbore)
+        static bool intersectRayTriangle(const double origin[3], const double direction[3], double v[3][3], double &distance);
+};
+
+#endif // MESHBVH_H_INCLUDED
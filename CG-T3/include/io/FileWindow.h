@@ -0,0 +1,54 @@
+#ifndef FILEWINDOW_H_INCLUDED
+#define FILEWINDOW_H_INCLUDED
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+/*
+*   Janela de leitura de tamanho fixo sobre um arquivo
+*
+*   O arquivo é lido sequencialmente em blocos do tamanho da janela, de modo que a
+*   memória usada não depende do tamanho do arquivo. Os bytes ainda não consumidos
+*   são levados para o início da janela antes de cada nova leitura
+*/
+class FileWindow
+{
+    private:
+        int fileDescriptor;
+        std::vector<char> buffer;
+
+        // Bytes disponíveis na janela ([begin, end)) e indicação de fim do arquivo
+        size_t begin, end;
+        bool endOfFile;
+
+        FileWindow(const FileWindow&);
+        FileWindow& operator=(const FileWindow&);
+
+        // Move os bytes não consumidos para o início e completa a janela com o arquivo
+        void fill();
+    public:
+        // Abre o arquivo informado (lança exceção se não for possível abri-lo)
+        FileWindow(std::string filePath, size_t windowSize);
+        ~FileWindow();
+
+        // Descarta a janela e continua a leitura a partir da posição informada do arquivo
+        void seek(size_t offset);
+
+        // Garante que size bytes estejam disponíveis a partir da posição atual. Retorna falso
+        // se o arquivo terminar antes; lança exceção se size for maior que a janela
+        bool require(size_t size);
+
+        // Obtém a posição atual e a quantidade de bytes disponíveis na janela
+        const char* getData();
+        size_t getAvailable();
+
+        // Avança a posição atual
+        void consume(size_t size);
+
+        // Obtém a próxima linha (sem a quebra de linha) e avança para a linha seguinte.
+        // Retorna falso no fim do arquivo; lança exceção se a linha for maior que a janela
+        bool nextLine(const char *&line, const char *&lineEnd);
+};
+
+#endif // FILEWINDOW_H_INCLUDED
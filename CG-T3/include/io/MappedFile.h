@@ -0,0 +1,32 @@
+#ifndef MAPPEDFILE_H_INCLUDED
+#define MAPPEDFILE_H_INCLUDED
+
+#include <string>
+#include <stdexcept>
+
+/*
+*   Arquivo mapeado em memória somente para leitura
+*
+*   O conteúdo é acessado diretamente pelas páginas do arquivo, sem cópias
+*   para buffers intermediários; o mapeamento é desfeito no destrutor
+*/
+class MappedFile
+{
+    private:
+        const char *data;
+        size_t size;
+
+        MappedFile(const MappedFile&);
+        MappedFile& operator=(const MappedFile&);
+    public:
+        // Mapeia o arquivo informado (lança exceção se não for possível abri-lo)
+        MappedFile(std::string filePath);
+        ~MappedFile();
+
+        // Obtém o início do conteúdo do arquivo (NULL se o arquivo estiver vazio)
+        const char* getData();
+        // Obtém o tamanho do arquivo em bytes
+        size_t getSize();
+};
+
+#endif // MAPPEDFILE_H_INCLUDED
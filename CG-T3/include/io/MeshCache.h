@@ -0,0 +1,136 @@
+#ifndef MESHCACHE_H_INCLUDED
+#define MESHCACHE_H_INCLUDED
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <stdint.h>
+
+#include "MappedFile.h"
+
+// Blocos de dados que podem ser guardados no cache de uma malha
+enum MeshCacheBlock
+{
+    // Cabeçalho original do arquivo do modelo
+    MESH_CACHE_HEADER,
+    // Atributos por vértice
+    MESH_CACHE_POSITION,
+    MESH_CACHE_NORMAL,
+    MESH_CACHE_COLOR,
+    MESH_CACHE_TEXCOORD,
+    // Índices dos vértices dos triângulos
+    MESH_CACHE_INDEX,
+    // Normais das faces, triângulos, grupos e materiais de um modelo Wavefront
+    MESH_CACHE_FACET_NORMAL,
+    MESH_CACHE_TRIANGLE,
+    MESH_CACHE_GROUP,
+    MESH_CACHE_GROUP_TRIANGLE,
+    MESH_CACHE_MATERIAL,
+    // Nomes referenciados pelos outros blocos
+    MESH_CACHE_NAME,
+    // Limites da malha
+    MESH_CACHE_BOUNDS,
+    // Quantidade de vértices de cada envoltória convexa e os vértices de todas elas
+    MESH_CACHE_HULL_SIZE,
+    MESH_CACHE_HULL_VERTEX,
+    // Agrupamentos de triângulos (meshlets) com as esferas e os cones de normais usados no descarte
+    MESH_CACHE_CLUSTER,
+    // ACMR da malha antes e depois da otimização da ordem dos triângulos
+    MESH_CACHE_ACMR,
+    // Quantidade de vértices removidos pela solda dos vértices coincidentes
+    MESH_CACHE_WELD
+};
+
+// Estrutura que identifica uma versão de um arquivo do qual a malha foi gerada
+struct MeshCacheSource
+{
+    std::string path;
+    uint64_t size;
+    int64_t modificationTime;
+    uint64_t contentHash;
+
+    MeshCacheSource()
+    {
+        this->path = "";
+        this->size = 0;
+        this->modificationTime = 0;
+        this->contentHash = 0;
+    }
+};
+
+/*
+*   Cache binário de uma malha já processada
+*
+*   O arquivo de cache guarda os buffers finais da malha em blocos alinhados, lidos
+*   diretamente do arquivo mapeado em memória. Ele é identificado pelo caminho do
+*   modelo e pelas opções de processamento, e só é aceito se a versão do formato e
+*   todos os arquivos de origem (tamanho, data de modificação ou hash do conteúdo)
+*   forem os mesmos de quando foi gravado
+*/
+class MeshCache
+{
+    private:
+        // Caminho do modelo e descrição das opções usadas no processamento da malha
+        std::string sourcePath;
+        std::string settings;
+
+        // Arquivos de origem adicionais (ex.: biblioteca de materiais)
+        std::vector<std::string> dependencyList;
+
+        // Blocos a gravar (os dados pertencem a quem os adicionou)
+        std::vector<MeshCacheBlock> blockIdList;
+        std::vector<const void*> blockDataList;
+        std::vector<size_t> blockSizeList;
+
+        // Cache carregado e a posição e o tamanho de cada bloco encontrado nele
+        std::unique_ptr<MappedFile> mappedFile;
+        std::vector<MeshCacheBlock> loadedIdList;
+        std::vector<const char*> loadedDataList;
+        std::vector<size_t> loadedSizeList;
+
+        // Obtém o caminho do arquivo de cache
+        std::string getCachePath();
+
+        // Obtém o tamanho, a data de modificação e, se computeHash for verdadeiro, o hash do
+        // conteúdo de um arquivo. Retorna falso se o arquivo não puder ser lido
+        static bool getSourceInfo(std::string path, bool computeHash, MeshCacheSource &source);
+        // Obtém o hash do conteúdo de um bloco de memória
+        static uint64_t hashData(const char *data, size_t size);
+    public:
+        MeshCache(std::string sourcePath, std::string settings);
+
+        // Carrega o cache do modelo. Retorna falso se ele não existir, for de outra versão
+        // ou opção de processamento ou se algum arquivo de origem tiver sido alterado
+        bool load();
+
+        // Obtém um bloco do cache carregado (NULL se o bloco não existir)
+        const void* getBlock(MeshCacheBlock block, size_t &size);
+
+        // Obtém um bloco do cache carregado como um vetor de itens do tipo T
+        template<typename T>
+        const T* getBlock(MeshCacheBlock block, size_t &count)
+        {
+            size_t size;
+            const T *data = (const T*)getBlock(block, size);
+            count = size / sizeof(T);
+            return data;
+        }
+
+        // Adiciona um arquivo de origem além do modelo, cuja alteração também invalida o cache
+        void addDependency(std::string path);
+
+        // Adiciona um bloco a gravar. Os dados devem continuar válidos até a chamada de save()
+        void addBlock(MeshCacheBlock block, const void *data, size_t size);
+
+        template<typename T>
+        void addBlock(MeshCacheBlock block, const std::vector<T> &itemList)
+        {
+            addBlock(block, itemList.data(), itemList.size() * sizeof(T));
+        }
+
+        // Grava o cache com os blocos adicionados. Retorna falso se não for possível gravá-lo,
+        // o que não impede o uso da malha (ela apenas é processada de novo na próxima leitura)
+        bool save();
+};
+
+#endif // MESHCACHE_H_INCLUDED
@@ -0,0 +1,21 @@
+#ifndef NUMBERPARSER_H_INCLUDED
+#define NUMBERPARSER_H_INCLUDED
+
+/*
+*   Conversão de números de arquivos de texto (OBJ, PLY) sem cópias
+*
+*   Os números no formato comum (sinal, dígitos, ponto e expoente) com até 15 dígitos
+*   significativos são montados diretamente a partir do texto, com o mesmo resultado
+*   de strtod; os demais (inf, nan, hexadecimal, mantissas longas, ...) são
+*   convertidos pela biblioteca padrão
+*/
+class NumberParser
+{
+    public:
+        // Converte o número real que começa em data (sem espaços antes dele) e termina em um
+        // espaço, tabulação, quebra de linha ou em end. Retorna a posição após o número, ou
+        // NULL se não houver um número válido
+        static const char* parseDouble(const char *data, const char *end, double &value);
+};
+
+#endif // NUMBERPARSER_H_INCLUDED
@@ -9,67 +9,65 @@ enum MaterialType { PolishedBronze = 0, PolishedCopper = 1, PolishedGold = 2, Po
 class Material
 {
     private:
-        // Definio dos materiais disponveis
-        GLfloat *polished_bronze_ambient = new GLfloat[4]{0.250000, 0.148000, 0.064750, 1.000000};
-        GLfloat *polished_bronze_diffuse = new GLfloat[4]{0.400000, 0.236800, 0.103600, 1.000000};
-        GLfloat *polished_bronze_specular = new GLfloat[4]{0.774597, 0.458561, 0.200621, 1.000000};
-        GLfloat *polished_bronze_shininess = new GLfloat[1]{76.800003};
-
-        GLfloat *polished_copper_ambient = new GLfloat[4]{0.229500, 0.088250, 0.027500, 1.000000};
-        GLfloat *polished_copper_diffuse = new GLfloat[4]{0.550800, 0.211800, 0.066000, 1.000000};
-        GLfloat *polished_copper_specular = new GLfloat[4]{0.580594, 0.223257, 0.069570, 1.000000};
-        GLfloat *polished_copper_shininess = new GLfloat[1]{51.200001};
-
-        GLfloat *polished_gold_ambient = new GLfloat[4]{0.247250, 0.224500, 0.064500, 1.000000};
-        GLfloat *polished_gold_diffuse = new GLfloat[4]{0.346150, 0.314300, 0.090300, 1.000000};
-        GLfloat *polished_gold_specular = new GLfloat[4]{0.797357, 0.723991, 0.208006, 1.000000};
-        GLfloat *polished_gold_shininess = new GLfloat[1]{83.199997};
-
-        GLfloat *pewter_ambient = new GLfloat[4]{0.105882, 0.058824, 0.113725, 1.000000};
-        GLfloat *pewter_diffuse = new GLfloat[4]{0.427451, 0.470588, 0.541176, 1.000000};
-        GLfloat *pewter_specular = new GLfloat[4]{0.333333, 0.333333, 0.521569, 1.000000};
-        GLfloat *pewter_shininess = new GLfloat[1]{9.846150};
-
-        GLfloat *polished_silver_ambient = new GLfloat[4]{0.231250, 0.231250, 0.231250, 1.000000};
-        GLfloat *polished_silver_diffuse = new GLfloat[4]{0.277500, 0.277500, 0.277500, 1.000000};
-        GLfloat *polished_silver_specular = new GLfloat[4]{0.773911, 0.773911, 0.773911, 1.000000};
-        GLfloat *polished_silver_shininess = new GLfloat[1]{89.599998};
-
-        GLfloat *emerald_ambient = new GLfloat[4]{0.021500, 0.174500, 0.021500, 0.550000};
-        GLfloat *emerald_diffuse = new GLfloat[4]{0.075680, 0.614240, 0.075680, 0.550000};
-        GLfloat *emerald_specular = new GLfloat[4]{0.633000, 0.727811, 0.633000, 0.550000};
-        GLfloat *emerald_shininess = new GLfloat[1]{76.800003};
-
-        GLfloat *ruby_ambient = new GLfloat[4]{0.174500, 0.011750, 0.011750, 0.550000};
-        GLfloat *ruby_diffuse = new GLfloat[4]{0.614240, 0.041360, 0.041360, 0.550000};
-        GLfloat *ruby_specular = new GLfloat[4]{0.1, 0.1, 0.1, 0.0};
-        GLfloat *ruby_shininess = new GLfloat[1]{76.0};
-
-        GLfloat *turquoise_ambient = new GLfloat[4]{0.100000, 0.187250, 0.174500, 0.800000};
-        GLfloat *turquoise_diffuse = new GLfloat[4]{0.396000, 0.741510, 0.691020, 0.800000};
-        GLfloat *turquoise_specular = new GLfloat[4]{0.297254, 0.308290, 0.306678, 0.800000};
-        GLfloat *turquoise_shininess = new GLfloat[1]{12.800000};
-
-        GLfloat *black_rubber_ambient = new GLfloat[4]{0.020000, 0.020000, 0.020000, 1.000000};
-        GLfloat *black_rubber_diffuse = new GLfloat[4]{0.010000, 0.010000, 0.010000, 1.000000};
-        GLfloat *black_rubber_specular = new GLfloat[4]{0.400000, 0.400000, 0.400000, 1.000000};
-        GLfloat *black_rubber_shininess = new GLfloat[1]{10.000000};
-
-        GLfloat *grass_ambient = new GLfloat[4]{0.021500, 0.174500, 0.021500, 0.550000};
-        GLfloat *grass_diffuse = new GLfloat[4]{0.075680, 0.614240, 0.075680, 0.550000};
-        GLfloat *grass_specular = new GLfloat[4]{0.0, 0.0, 0.0, 0.0};
-        GLfloat *grass_shininess = new GLfloat[1]{50.0};
-
-        GLfloat *white_ambient = new GLfloat[4]{1.0, 1.0, 1.0, 1.0};
-        GLfloat *white_diffuse = new GLfloat[4]{1.0, 1.0, 1.0, 1.0};
-        GLfloat *white_specular = new GLfloat[4]{0.0, 0.0, 0.0, 0.0};
-        GLfloat *white_shininess = new GLfloat[1]{0.0};
+        // Definio dos materiais disponveis (compartilhada por todos os objetos)
+        static const GLfloat polished_bronze_ambient[4];
+        static const GLfloat polished_bronze_diffuse[4];
+        static const GLfloat polished_bronze_specular[4];
+        static const GLfloat polished_bronze_shininess[1];
+
+        static const GLfloat polished_copper_ambient[4];
+        static const GLfloat polished_copper_diffuse[4];
+        static const GLfloat polished_copper_specular[4];
+        static const GLfloat polished_copper_shininess[1];
+
+        static const GLfloat polished_gold_ambient[4];
+        static const GLfloat polished_gold_diffuse[4];
+        static const GLfloat polished_gold_specular[4];
+        static const GLfloat polished_gold_shininess[1];
+
+        static const GLfloat pewter_ambient[4];
+        static const GLfloat pewter_diffuse[4];
+        static const GLfloat pewter_specular[4];
+        static const GLfloat pewter_shininess[1];
+
+        static const GLfloat polished_silver_ambient[4];
+        static const GLfloat polished_silver_diffuse[4];
+        static const GLfloat polished_silver_specular[4];
+        static const GLfloat polished_silver_shininess[1];
+
+        static const GLfloat emerald_ambient[4];
+        static const GLfloat emerald_diffuse[4];
+        static const GLfloat emerald_specular[4];
+        static const GLfloat emerald_shininess[1];
+
+        static const GLfloat ruby_ambient[4];
+        static const GLfloat ruby_diffuse[4];
+        static const GLfloat ruby_specular[4];
+        static const GLfloat ruby_shininess[1];
+
+        static const GLfloat turquoise_ambient[4];
+        static const GLfloat turquoise_diffuse[4];
+        static const GLfloat turquoise_specular[4];
+        static const GLfloat turquoise_shininess[1];
+
+        static const GLfloat black_rubber_ambient[4];
+        static const GLfloat black_rubber_diffuse[4];
+        static const GLfloat black_rubber_specular[4];
+        static const GLfloat black_rubber_shininess[1];
+
+        static const GLfloat grass_ambient[4];
+        static const GLfloat grass_diffuse[4];
+        static const GLfloat grass_specular[4];
+        static const GLfloat grass_shininess[1];
+
+        static const GLfloat white_ambient[4];
+        static const GLfloat white_diffuse[4];
+        static const GLfloat white_specular[4];
+        static const GLfloat white_shininess[1];
 
         // Define o material do objeto
-        void setObjectMaterial(GLfloat* obj_front_ambient, GLfloat* obj_front_diffuse, GLfloat* obj_specular, GLfloat* obj_shininess);
+        void setObjectMaterial(const GLfloat* obj_front_ambient, const GLfloat* obj_front_diffuse, const GLfloat* obj_specular, const GLfloat* obj_shininess);
     public:
-        ~Material();
-
         // Define cada tipo de material de objeto
         void setPolishedBronzeMaterial();
         void setPolishedCopperMaterial();
@@ -82,6 +80,9 @@ class Material
         void setBlackRubberMaterial();
         void setGrassMaterial();
         void setWhiteMaterial();
+
+        // Define o material do objeto a partir do tipo (branco se o tipo for desconhecido)
+        void setMaterial(MaterialType materialType);
 };
 
 #endif // MATERIALS_H_INCLUDED
@@ -17,10 +17,12 @@ class NavigatorCamera
 
 		void Init();
 		void Refresh();
+		void Refresh(float x, float y, float z); // Refresh using another eye position (e.g. interpolated)
 		Vertex3D GetPos();
 		void SetPos(float x, float y, float z);
 		void GetPos(float &x, float &y, float &z);
 		void GetDirectionVector(float &x, float &y, float &z);
+		void GetStrafeVector(float &x, float &z);
 		void SetYaw(float angle);
 		void SetPitch(float angle);
 
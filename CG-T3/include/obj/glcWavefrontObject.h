@@ -15,6 +15,12 @@
 #include <GL/gl.h>
 
 #include <iostream>
+#include <vector>
+#include <memory>
+#include <mutex>
+
+#include "../collision/ConvexHull.h"
+#include "../io/MeshCache.h"
 
 using namespace std;
 
@@ -31,61 +37,167 @@ using namespace std;
 typedef struct _GLMaterial  GLMmaterial;
 typedef struct _GLMtriangle GLMtriangle;
 typedef struct _GLMgroup    GLMgroup;
+typedef struct _GLMcluster  GLMcluster;
 typedef struct _GLMmodel    GLMmodel;
-typedef struct _GLMnode     GLMnode;
+typedef struct _GLMprocessing GLMprocessing;
 
+/*
+  Objects are referenced by the handle returned when they are loaded. Loads may
+  run from several threads at once (the settings below are read by them, so they
+  should be changed while no load is running), and the operations on different
+  objects are independent of each other.
+*/
 class glcWavefrontObject
 {
     public:
         glcWavefrontObject();
         ~glcWavefrontObject();
-        void  SetNumberOfObjects(int );
-        int   GetNumberOfObjects();
-        void  SelectObject(int);
         void  SetShadingMode(int);  // Possible values: FLAT_SHADING e SMOOTH_SHADING
         void  SetRenderMode(int);   // Possible values: USE_COLOR, USE_MATERIAL, USE_TEXTURE
         void  SetColor(float, float, float, float a = 1.0);
-        void Draw();
-        void DrawBoundingBox();
-        void ReadObject(const char *filename);
-        int GetNumberOfVertices();
-        int GetNumberOfTriangles();
-
-        void GetDimensions(GLfloat* dimensions);
-
-        float Unitize();
-        void FacetNormal();
-        void VertexNormals(GLfloat angle);
-        void Scale(GLfloat scale);
+        // In the texture render modes, the diffuse maps (map_Kd) of the materials are
+        // bound per group, loaded through glcTextureCache::GetSharedCache()
+        void  SetCacheEnabled(bool enabled);
+        // Skips the clusters outside the view frustum and, while GL_CULL_FACE culls the back
+        // faces, the clusters facing away from the camera (enabled by default)
+        void  SetClusterCulling(bool enabled);
+        // Convex hulls generated at import as collision proxies (maxVertices = 0 disables)
+        void  SetConvexHullGeneration(int maxVertices, int hullCount = 1);
+        // Merges the vertices closer than epsilon (relative to half the model's largest
+        // dimension, i.e. measured in the unitized space; 0 merges equal positions only)
+        // at import. The normal and texture coordinate indices are kept (disabled by default)
+        void  SetVertexWelding(bool enabled, GLfloat epsilon = 0.0);
+        // Keeps the loaded objects in compact formats: 16-bit positions and texture coordinates,
+        // decoded by the modelview and texture matrices, and octahedral normals in two 16-bit
+        // components (disabled by default). The processing functions below work on a decoded copy
+        void  SetVertexQuantization(bool enabled);
+
+        // Reads an object and returns its handle.
+        // Throws std::runtime_error if the file can't be read or is malformed
+        int  LoadObject(const char *filename);
+        // Reads the object and applies the processing (see GLMprocessing). The processed mesh
+        // is kept in a binary cache and reused while the OBJ/MTL files are unchanged
+        int  LoadProcessedObject(const char *filename, const GLMprocessing& processing);
+        // Unitizes and scales the object, and generates its vertex normals with the given crease angle
+        int  LoadProcessedObject(const char *filename, GLfloat angle, GLfloat scale);
+        // Loads count objects concurrently (filenames[i] and scales[i] give handles[i]).
+        // If any of them fails, none is kept loaded and the first error is thrown
+        void LoadProcessedObjects(int count, const char **filenames, GLfloat angle, const GLfloat *scales, int *handles);
+        // Releases the object (and its convex hulls); the handle may be reused by a later load
+        void UnloadObject(int handle);
+        int  GetNumberOfObjects();
+
+        // The functions below throw std::invalid_argument if the handle isn't loaded
+        void Draw(int handle);
+        void DrawBoundingBox(int handle);
+        int  GetNumberOfVertices(int handle);
+        int  GetNumberOfTriangles(int handle);
+        // Triangles submitted by the last Draw of the object (after the cluster culling)
+        int  GetNumberOfDrawnTriangles(int handle);
+        void GetDimensions(int handle, GLfloat* dimensions);
+        // Average vertices transformed per triangle (FIFO cache) before and after the vertex cache optimization
+        void GetACMR(int handle, GLfloat* acmr);
+        // Vertices removed by the vertex welding
+        int  GetNumberOfWeldedVertices(int handle);
+        // Bytes used by the vertex positions, normals, texture coordinates and facet normals
+        GLuint GetVertexDataSize(int handle);
+
+        float Unitize(int handle);
+        void  FacetNormal(int handle);
+        void  VertexNormals(int handle, GLfloat angle);
+        void  Scale(int handle, GLfloat scale);
+
+        int         GetNumberOfConvexHulls(int handle);
+        // The hull belongs to the object and is valid until the object is unloaded
+        ConvexHull* GetConvexHull(int handle, int index);
 
     private:
-        GLMgroup* FindGroup(char* name);
-        GLMgroup* AddGroup(char* name);
-        GLuint FindMaterial(char* name);
+        int       AddModel(GLMmodel* model);
+        // The returned reference keeps the model alive during the call even if another thread unloads it
+        std::shared_ptr<GLMmodel> GetModel(int handle);
+        static GLMmodel* NewModel(const char* filename);
+        static void      DeleteModel(GLMmodel* model);
+
+        GLMgroup* FindGroup(GLMmodel* model, const char* name);
+        GLMgroup* AddGroup(GLMmodel* model, const char* name);
+        GLuint FindMaterial(GLMmodel* model, const char* name);
 
         float Dot(GLfloat* u, GLfloat* v);
         float Max(GLfloat a, GLfloat b);
         float Abs(GLfloat f);
         void  Cross(GLfloat* u, GLfloat* v, GLfloat* n);
 
-        void FirstPass(FILE *file);
-        void SecondPass(FILE *file);
+        void  ReadObject(GLMmodel* model, const char* filename);
+        void  ReadProcessedObject(GLMmodel* model, const char* filename, const GLMprocessing& processing);
+        void  ProcessObject(GLMmodel* model, const GLMprocessing& processing);
+        void  ParseOBJ(GLMmodel* model, const char* data, size_t size);
+        void  ParseError(GLMmodel* model, GLuint line, const char* message);
         char* DirName(char* path);
-        void  ReadMTL(char* name);
+        void  ReadMTL(GLMmodel* model, const char* name);
         void  Normalize(GLfloat* v);
-        void  ComputeBoundingBox();
+        float Unitize(GLMmodel* model);
+        void  FacetNormal(GLMmodel* model);
+        void  VertexNormals(GLMmodel* model, GLfloat angle);
+        void  Scale(GLMmodel* model, GLfloat scale);
+        GLuint AverageNormals(GLMmodel* model, GLfloat cos_angle, const GLuint* first, const GLuint* corners,
+                              GLuint firstvertex, GLuint lastvertex, GLuint numnormals, GLuint* orphans);
+        static int    ParallelRanges(GLuint count);
+        static GLuint RangeStart(GLuint count, int numranges, int range);
+        void  BuildConvexHulls(GLMmodel* model);
+        void  WeldVertices(GLMmodel* model);
+        void  QuantizeModel(GLMmodel* model);
+        void  DequantizeModel(GLMmodel* model);
+        void  BuildClusters(GLMmodel* model);
+        void  ComputeClusterBounds(GLMmodel* model, GLMgroup* group, GLMcluster* cluster);
+        void  OptimizeClusterOrder(GLMmodel* model, GLMgroup* group, GLMcluster* cluster, std::vector<GLuint>& local);
+        void  OptimizeVertexFetch(GLMmodel* model);
+        static void DrawOrderIndices(GLMmodel* model, std::vector<GLuint>& indices);
+        void  TransformClusters(GLMmodel* model, const GLfloat* center, GLfloat unitscale, GLfloat scale);
+        static bool GetViewVolume(GLfloat planes[6][4], GLfloat eye[4]);
+        static bool ClusterCulled(const GLMcluster* cluster, GLfloat planes[6][4], const GLfloat* eye);
+        bool  ReadCachedObject(GLMmodel* model, MeshCache &cache);
+        void  SaveCachedObject(GLMmodel* model, MeshCache &cache);
 
         // Attributes
         int shading;    // shading mode
         int render;     // rendering mode
         float color[4];
-
-        GLMmodel* modelList;
-        GLMmodel* model; // Current Object
-        int numberOfObjects;
+        int hullMaxVertices;
+        int hullCount;
+        bool cacheEnabled;
+        bool clusterCulling;
+        bool weldEnabled;
+        GLfloat weldEpsilon;
+        bool quantizeEnabled;
+
+        // Loaded objects, indexed by handle (empty for unloaded ones, whose handles are kept in freeHandles)
+        std::vector<std::shared_ptr<GLMmodel> > modelList;
+        std::vector<int> freeHandles;
+        std::mutex modelMutex;
 };
 
 // Auxiliary structures
+
+// GLMprocessing: processing applied after an object is read. The vertices are
+// unitized and scaled in a single pass, and the normals are generated afterwards
+struct _GLMprocessing
+{
+    bool    unitize;              /* center at the origin and fit in a unit cube */
+    GLfloat scale;                /* uniform scale applied after unitize */
+    bool    facetnormals;         /* generate the facet normals */
+    bool    vertexnormals;        /* generate the vertex normals (implies facetnormals) */
+    GLfloat angle;                /* crease angle of the vertex normals, in degrees */
+
+    _GLMprocessing(GLfloat scale = 1.0, GLfloat angle = 90.0)
+    {
+        this->unitize = true;
+        this->scale = scale;
+        this->facetnormals = true;
+        this->vertexnormals = true;
+        this->angle = angle;
+    }
+};
+
 struct _GLMaterial
 {
     char* name;                   /* name of material */
@@ -94,6 +206,8 @@ struct _GLMaterial
     GLfloat specular[4];          /* specular component */
     GLfloat emmissive[4];         /* emmissive component */
     GLfloat shininess;            /* specular exponent */
+    char*   map_diffuse;          /* path of the diffuse texture map (NULL if none) */
+    GLuint  texture;              /* texture object of map_diffuse (0 until the material is first drawn) */
 };
 
 // GLMtriangle: Structure that defines a triangle in a model.
@@ -112,14 +226,27 @@ struct _GLMgroup
     GLuint            numtriangles;   /* number of triangles in this group */
     GLuint*           triangles;      /* array of triangle indices */
     GLuint            material;       /* index to material for group */
+    GLuint            firstcluster;   /* first cluster of this group in the model's clusters */
+    GLuint            numclusters;    /* number of clusters in this group */
     struct _GLMgroup* next;           /* pointer to next group in model */
 };
 
+// GLMcluster: Spatially coherent run of a group's triangles, culled as a whole by Draw.
+struct _GLMcluster
+{
+    GLuint  first;                /* first triangle in the group's triangle array */
+    GLuint  count;                /* number of triangles */
+    GLfloat center[3];            /* bounding sphere */
+    GLfloat radius;
+    GLfloat axis[3];              /* normal cone: average facet direction */
+    GLfloat cutoff;               /* sine of the cone's half angle (1 if the cluster can't be backface culled) */
+};
+
 // GLMmodel: Structure that defines a model.
 struct _GLMmodel
 {
     char*    pathname;            /* path to this model */
-    char*    mtllibname;          /* name of the material library */
+    char*    mtllibname;          /* names of the material libraries (separated by spaces) */
 
     GLuint   numvertices;         /* number of vertices in model */
     GLfloat* vertices;            /* array of vertices  */
@@ -142,15 +269,27 @@ struct _GLMmodel
     GLuint       numgroups;       /* number of groups in model */
     GLMgroup*    groups;          /* linked list of groups */
 
+    GLuint       numclusters;     /* number of clusters in model */
+    GLMcluster*  clusters;        /* array of clusters, grouped by group */
+
+    GLuint       numhulls;        /* number of convex hulls in model */
+    ConvexHull** hulls;           /* array of convex hulls (collision proxies) */
+
     GLfloat position[3];          /* position of the model */
     GLfloat boundingbox[6];       /* [minx, miny, minz, maxx, maxy, maxz] */
-};
-
-struct _GLMnode
-{
-    GLuint         index;
-    GLboolean      averaged;
-    struct _GLMnode* next;
+    GLuint  drawwarnings;         /* Draw fallbacks already reported */
+    GLuint  numdrawntriangles;    /* triangles submitted by the last Draw */
+    GLfloat acmr[2];              /* ACMR of the file's order and of the optimized order */
+    GLuint  numweldedvertices;    /* vertices removed by the welding */
+
+    GLshort* qvertices;           /* quantized vertices (replace vertices, NULL if not quantized) */
+    GLshort* qnormals;            /* octahedral normals (replace normals) */
+    GLshort* qtexcoords;          /* quantized texcoords (replace texcoords) */
+    GLshort* qfacetnorms;         /* octahedral facetnorms (replace facetnorms) */
+    GLfloat  qoffset[3];          /* vertex = qoffset + qvertex * qscale */
+    GLfloat  qscale[3];
+    GLfloat  qtexoffset[2];       /* texcoord = qtexoffset + qtexcoord * qtexscale */
+    GLfloat  qtexscale[2];
 };
 
 #endif
@@ -2,14 +2,20 @@
 #define OBJECT_H_INCLUDED
 
 #include <vector>
+#include <memory>
+#include <atomic>
 #include <cmath>
 
 #include "../drawable/Drawable.h"
 #include "../collision/Collider.h"
+#include "../collision/MeshBVH.h"
+#include "../collision/ConvexHull.h"
+#include "../collision/AffineTransform.h"
 
 #include "../primitive/Vertex3D.h"
 #include "../primitive/Primitive.h"
 #include "../primitive/RGBColor.h"
+#include "../primitive/QuantizedMesh.h"
 
 class Object : public Drawable, public Collider
 {
@@ -17,6 +23,12 @@ class Object : public Drawable, public Collider
         std::vector<Vertex3D*> vertexList;
         std::vector<Primitive*> faceList;
 
+        // Atributos por vértice lidos do arquivo do modelo, indexados pelo id do vértice
+        // (normais e cores com 3 valores, coordenadas de textura com 2; vazios se ausentes)
+        std::vector<float> vertexNormalList;
+        std::vector<float> vertexColorList;
+        std::vector<float> vertexTexCoordList;
+
         double minX, maxX, minY, maxY, minZ, maxZ;
         double width, length, height;
 
@@ -26,15 +38,45 @@ class Object : public Drawable, public Collider
 
         bool objIsDrawable, objIsCollisible;
 
+        // Indica se todas as faces são triângulos sem textura
+        bool triangleMesh;
+
+        // BVH dos triângulos da malha, compartilhada entre as cópias do objeto
+        std::shared_ptr<MeshBVH> meshBVH;
+        // Envoltórias convexas da malha, compartilhadas entre as cópias do objeto
+        std::vector< std::shared_ptr<ConvexHull> > convexHullList;
+        // Malha compacta usada no desenho, no mesmo espaço local da BVH e das envoltórias e
+        // compartilhada entre as cópias do objeto (objetos lidos em fluxo só têm essa malha)
+        std::shared_ptr<QuantizedMesh> quantizedMesh;
+        // Transformação do espaço em que a BVH, as envoltórias e a malha compacta foram construídas para o espaço atual dos vértices
+        AffineTransform meshTransform;
+
+        // Contador de alterações na geometria de qualquer objeto (invalida as estruturas de consulta da cena).
+        // É atômico porque objetos também são criados e processados pelas threads de leitura
+        static std::atomic<unsigned long> revision;
+
+        // Obtém a transformação que leva os vértices atuais para o espaço local das estruturas de colisão
+        void getMeshLocalTransform(AffineTransform &toLocal);
+
+        // Rotaciona as normais dos vértices no plano dos eixos a e b
+        void rotateVertexNormals(int a, int b, double sinVal, double cosVal);
+        // Desenha todas as faces em um único bloco de triângulos, com os atributos por vértice se houver
+        void drawTriangleBatch();
+        // Desenha a malha compacta com a transformação do objeto
+        void drawQuantizedMesh();
+
         void getMinMaxAxis();
         double convertDegreeToRadians(double degree);
     public:
         Object();
-        ~Object();
+        virtual ~Object();
 
         Object* clone();
 
         void rescaling();
+        // Reescala o objeto para o intervalo [-1, 1] a partir dos limites já conhecidos dos vértices,
+        // centralizando-o na origem em uma única passada
+        void rescaling(const double min[3], const double max[3]);
         void rescaling(double scaleX, double scaleY, double scaleZ);
 
         void centralize();
@@ -44,6 +86,9 @@ class Object : public Drawable, public Collider
         void rotateYAxis(double angle);
         void rotateZAxis(double angle);
 
+        // Reserva espaço nas listas de vértices e faces antes de uma importação
+        void reserve(int vertexCount, int faceCount);
+
         void addFace(Primitive *face);
         Primitive* getFace(int idFace);
         std::vector<Primitive*>* getFaceList();
@@ -54,6 +99,11 @@ class Object : public Drawable, public Collider
         std::vector<Vertex3D*>* getVertexList();
         int getVertexCount();
 
+        // Obtém os atributos por vértice (normais, cores RGB em [0, 1] e coordenadas de textura)
+        std::vector<float>* getVertexNormalList();
+        std::vector<float>* getVertexColorList();
+        std::vector<float>* getVertexTexCoordList();
+
         Vertex3D getCenter();
         double getWidth();
         double getLength();
@@ -71,12 +121,65 @@ class Object : public Drawable, public Collider
         double getTranslationY();
         double getTranslationZ();
 
+        // Obtém e define os limites guardados do objeto (usados ao restaurar uma malha já processada)
+        void getExtents(double min[3], double max[3]);
+        void setExtents(const double min[3], const double max[3]);
+
         void setCenter(Vertex3D center);
         void setWidth(double width);
         void setLength(double length);
         void setHeight(double height);
 
         BoundingBox* getCollider();
+        bool collide(BoundingBox *box, CollisionDetail detail);
+
+        // Solda os vértices que distam no máximo epsilon de outro e têm as mesmas normais, cores e
+        // coordenadas de textura (dentro de uma tolerância), mantendo os atributos do primeiro e
+        // removendo os triângulos que se degeneram. Retorna a quantidade de vértices removidos
+        int weldVertices(double epsilon);
+
+        // Reordena os triângulos pela cache de vértices transformados e os vértices pela ordem de uso,
+        // obtendo o ACMR antes e depois. Retorna falso, sem alterar o objeto, se houver faces que
+        // não sejam triângulos
+        bool optimizeVertexCache(double &acmrBefore, double &acmrAfter);
+
+        // Constrói a BVH dos triângulos da malha para colisão exata
+        void buildMeshBVH();
+        MeshBVH* getMeshBVH();
+
+        // Constrói hullCount envoltórias convexas da malha com no máximo maxVertices vértices cada
+        void buildConvexHulls(int maxVertices, int hullCount);
+        ConvexHull* getConvexHull(int idHull);
+        int getConvexHullCount();
+        // Obtém os vértices de uma envoltória no espaço atual dos vértices do objeto
+        void getConvexHullVertexList(int idHull, std::vector<double> &hullVertexList);
+        // Adiciona uma envoltória já gerada, com os vértices no espaço atual dos vértices do objeto
+        void addConvexHull(const std::vector<double> &hullVertexList);
+
+        // Define a malha compacta de um objeto sem vértices próprios (ex.: lido em fluxo), com as posições
+        // no espaço atual do objeto. O desenho, os limites e as envoltórias passam a usá-la, e as
+        // estruturas de colisão anteriores são descartadas
+        void setQuantizedMesh(std::shared_ptr<QuantizedMesh> quantizedMesh);
+        QuantizedMesh* getQuantizedMesh();
+        // Obtém os vértices da malha compacta no espaço atual dos vértices do objeto
+        void getQuantizedVertexList(std::vector<double> &vertexList);
+        // Constrói a malha compacta a partir das faces e dos atributos dos vértices, no espaço local da
+        // BVH e das envoltórias, e passa a desenhá-la. Retorna falso, sem alterar o objeto, se não houver
+        // faces ou se alguma tiver textura
+        bool buildQuantizedMesh();
+        // Libera os vértices, as faces e os atributos depois que a malha compacta, a BVH e as
+        // envoltórias foram construídas, que passam a responder pelo desenho e pelas consultas
+        void releaseVertexData();
+
+        // Lança um raio contra as faces do objeto. Se houver uma interseção mais próxima que
+        // distance, atualiza distance (em unidades da direção) e a face atingida
+        bool raycast(const double origin[3], const double direction[3], double &distance, int &faceIndex);
+        // Obtém a caixa envolvente dos vértices do objeto
+        void getBounds(double min[3], double max[3]);
+
+        // Obtém e incrementa o contador de alterações na geometria dos objetos
+        static unsigned long getRevision();
+        static void notifyChange();
 
         void setMaterialType(MaterialType materialType);
         void setColor(RGBColor color);
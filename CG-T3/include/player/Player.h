@@ -10,22 +10,33 @@
 class Player : public Object
 {
     private:
-        double nav_cam_speed = 0.03;
+        // Velocidade de navegação em unidades por segundo
+        double nav_cam_speed = 1.8;
         double nav_cam_rot_speed = M_PI / 180 * 0.2;
         bool flyMode = false;
         bool inverseMouse = true;
         bool releaseMouse = false;
 
         NavigatorCamera nav_cam;
+
+        // Posição da câmera no início do passo de simulação atual
+        float prevX, prevY, prevZ;
     public:
         Player(double x, double y, double z);
 
-        void refresh();
+        // Posiciona a câmera interpolando entre o passo anterior e o atual (alpha em [0, 1])
+        void refresh(double alpha);
+
+        // Guarda a posição atual como início de um novo passo de simulação
+        void storePreviousPosition();
+        // Verifica se a posição mudou desde o início do passo
+        bool isMoving();
 
-        void forward();
-        void backward();
-        void left();
-        void right();
+        // Obtém o deslocamento de deltaTime segundos de navegação. forwardAxis e strafeAxis
+        // valem 1 (frente/esquerda), -1 (trás/direita) ou 0, e speedFactor multiplica a velocidade
+        void getDisplacement(int forwardAxis, int strafeAxis, double speedFactor, double deltaTime, double displacement[3]);
+        // Desloca o jogador
+        void move(const double displacement[3]);
         void rotate(int x, int y, int currMiddleWindowWidth, int currMiddleWindowHeight);
 };
 
@@ -0,0 +1,126 @@
+#ifndef PLYLOADER_H_INCLUDED
+#define PLYLOADER_H_INCLUDED
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
+#include "PLYReader.h"
+
+// Estrutura que guarda um arquivo PLY a ser lido em segundo plano
+struct PLYLoadRequest
+{
+    std::string path;
+    std::string name;
+
+    PLYLoadRequest(std::string path, std::string name)
+    {
+        this->path = path;
+        this->name = name;
+    }
+};
+
+// Estrutura que guarda o resultado da leitura de um arquivo PLY em segundo plano
+struct PLYLoadResult
+{
+    std::string path;
+    std::string name;
+    // Objeto lido e processado (NULL se a leitura falhou) e a mensagem de erro
+    PLYObject *plyObject;
+    std::string error;
+
+    PLYLoadResult()
+    {
+        this->path = "";
+        this->name = "";
+        this->plyObject = NULL;
+        this->error = "";
+    }
+};
+
+/*
+*   Leitor de arquivos PLY em segundo plano
+*
+*   A leitura e o processamento da malha (reescala, envoltórias convexas, BVH e malha compacta
+*   do desenho, que substitui os vértices em double) são feitos por um conjunto de threads de
+*   trabalho, cada uma com seu próprio leitor. Os objetos prontos são colocados em uma fila e
+*   entregues à thread do OpenGL em popResult(), que deve ser chamada a cada passo do laço
+*   principal; a cena não é bloqueada durante a leitura
+*/
+class PLYLoader
+{
+    private:
+        // Quantidade de threads de trabalho e opções dos leitores criados por elas
+        int workerCount;
+        int hullMaxVertices;
+        int hullCount;
+        bool weldEnabled;
+        double weldEpsilon;
+        // Tamanho (em bytes) a partir do qual os arquivos são lidos em fluxo (0 desabilita)
+        size_t streamThreshold;
+
+        std::vector<std::thread> workerList;
+        std::mutex loaderMutex;
+        std::condition_variable requestCondition;
+
+        // Solicitações ainda não iniciadas e resultados ainda não entregues (os objetos lidos
+        // pertencem ao leitor até a entrega e são liberados na sua destruição)
+        std::deque<PLYLoadRequest> requestQueue;
+        std::deque<PLYLoadResult> resultQueue;
+        // Solicitações ainda não entregues (na fila, em leitura ou prontas)
+        int pendingCount;
+        // Solicitações feitas e leituras terminadas desde que não havia nenhuma pendente
+        int requestedCount;
+        int finishedCount;
+        bool stopWorker;
+
+        // Progresso (em milésimos) do arquivo em leitura por cada thread
+        std::unique_ptr< std::atomic<int>[] > workerProgress;
+
+        // Laço de uma thread de trabalho
+        void run(int workerIndex);
+        // Indica se um arquivo é maior que o limite da leitura em fluxo
+        bool isStreamed(std::string path);
+        // Coloca um resultado na fila de entrega (loaderMutex deve estar bloqueado)
+        void pushResult(const PLYLoadResult &result);
+        // Obtém os caminhos dos arquivos PLY de um diretório e de seus subdiretórios, em ordem alfabética
+        static void findPLYFiles(std::string directory, std::vector<std::string> &pathList);
+    public:
+        PLYLoader();
+        ~PLYLoader();
+
+        // Define a quantidade de threads de trabalho (padrão: 1). As opções devem ser
+        // definidas antes da primeira solicitação
+        void setWorkerCount(int workerCount);
+        // Habilita a geração de envoltórias convexas nos objetos lidos
+        void setConvexHullGeneration(int maxVertices, int hullCount = 1);
+        // Habilita a solda dos vértices coincidentes nos objetos lidos
+        void setVertexWelding(bool enabled, double epsilon = 0.0);
+        // Lê em fluxo (PLYReader::stream_ply_object) os arquivos com mais de streamThreshold bytes,
+        // que passam a ter apenas a malha compacta e as envoltórias (padrão: 0, desabilitado)
+        void setStreamThreshold(size_t streamThreshold);
+
+        // Solicita a leitura de um arquivo PLY, identificado no resultado por name
+        void requestLoad(std::string path, std::string name);
+
+        // Solicita a leitura de todos os arquivos PLY de um diretório e de seus subdiretórios, cada
+        // um identificado pelo nome do arquivo sem a extensão. Os arquivos cuja memória estimada
+        // ultrapassaria memoryBudget (em bytes) somados aos anteriores não são lidos e geram
+        // resultados com erro. Retorna a quantidade de arquivos solicitados
+        int requestDirectory(std::string directory, size_t memoryBudget);
+
+        // Obtém o próximo resultado pronto. Retorna falso se nenhuma leitura terminou desde a última chamada
+        bool popResult(PLYLoadResult &result);
+
+        // Obtém a quantidade de leituras ainda não entregues
+        int getPendingCount();
+        // Obtém o progresso (entre 0 e 1) do conjunto de leituras pendentes
+        double getProgress();
+};
+
+#endif // PLYLOADER_H_INCLUDED
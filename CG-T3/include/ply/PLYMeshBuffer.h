@@ -0,0 +1,50 @@
+#ifndef PLYMESHBUFFER_H_INCLUDED
+#define PLYMESHBUFFER_H_INCLUDED
+
+#include <vector>
+#include <memory>
+
+#include "PLYStreamHandler.h"
+
+#include "../primitive/QuantizedMesh.h"
+
+/*
+*   Destino da leitura em fluxo de um arquivo PLY
+*
+*   Acumula as posições em 16 bits e os índices dos lotes recebidos e, no fim da malha,
+*   reordena-os para a cache de vértices e calcula as normais, entregando uma malha
+*   compacta que pode ser atribuída a um objeto (Object::setQuantizedMesh)
+*/
+class PLYMeshBuffer : public PLYStreamHandler
+{
+    private:
+        std::vector<short> positionList;
+        std::vector<unsigned int> indexList;
+
+        // Malha compacta criada no fim da leitura
+        std::shared_ptr<QuantizedMesh> quantizedMesh;
+
+        // Limites originais dos vértices
+        double min[3], max[3];
+        // ACMR dos triângulos antes e depois da reordenação
+        double acmrBefore, acmrAfter;
+    public:
+        PLYMeshBuffer();
+
+        void beginMesh(int vertexCount, int faceCount, const double min[3], const double max[3]);
+        void addVertexBatch(const short *positionList, int vertexCount);
+        void addTriangleBatch(const unsigned int *indexList, int triangleCount);
+        // Reordena os triângulos e os vértices, calcula as normais e cria a malha compacta
+        void endMesh();
+
+        // Obtém a malha compacta (vazia antes do fim da leitura)
+        std::shared_ptr<QuantizedMesh> getQuantizedMesh();
+
+        // Obtém os limites originais dos vértices
+        void getOriginalBounds(double min[3], double max[3]);
+
+        // Obtém o ACMR dos triângulos antes e depois da reordenação
+        void getVertexCacheStats(double &acmrBefore, double &acmrAfter);
+};
+
+#endif // PLYMESHBUFFER_H_INCLUDED
@@ -3,6 +3,7 @@
 
 #include <string>
 #include <list>
+#include <vector>
 
 #include "../object/Object.h"
 
@@ -10,7 +11,56 @@
 enum PLYType
 {
     ASCII,
-    BINARY
+    BINARY_LITTLE_ENDIAN,
+    BINARY_BIG_ENDIAN
+};
+
+// Enumeração dos tipos de dado das propriedades de um arquivo PLY
+enum PLYPropertyType
+{
+    PLY_CHAR,
+    PLY_UCHAR,
+    PLY_SHORT,
+    PLY_USHORT,
+    PLY_INT,
+    PLY_UINT,
+    PLY_FLOAT,
+    PLY_DOUBLE
+};
+
+// Estrutura que guarda uma propriedade de um elemento do arquivo PLY
+struct PLYProperty
+{
+    std::string propertyName;
+    // Tipo do valor (ou dos itens, no caso de uma lista)
+    PLYPropertyType propertyType;
+    // Indica se a propriedade é uma lista e o tipo do contador de itens da lista
+    bool isList;
+    PLYPropertyType countType;
+
+    PLYProperty()
+    {
+        this->propertyName = "";
+        this->propertyType = PLY_FLOAT;
+        this->isList = false;
+        this->countType = PLY_UCHAR;
+    }
+
+    PLYProperty(std::string propertyName, PLYPropertyType propertyType)
+    {
+        this->propertyName = propertyName;
+        this->propertyType = propertyType;
+        this->isList = false;
+        this->countType = PLY_UCHAR;
+    }
+
+    PLYProperty(std::string propertyName, PLYPropertyType countType, PLYPropertyType propertyType)
+    {
+        this->propertyName = propertyName;
+        this->propertyType = propertyType;
+        this->isList = true;
+        this->countType = countType;
+    }
 };
 
 // Estrutura que guarda o tipo e a versão de um arquivo PLY
@@ -32,11 +82,12 @@ struct PLYFormatVersion
     }
 };
 
-// Estrutura que guarda um elemento e a quantidade desses elementos no arquivo PLY
+// Estrutura que guarda um elemento, a quantidade desses elementos e suas propriedades no arquivo PLY
 struct PLYElement
 {
     std::string elementName;
     int elementCount;
+    std::vector<PLYProperty> propertyList;
 
     PLYElement()
     {
@@ -63,7 +114,13 @@ class PLYObject : public Object
         std::list<std::string> commentList;
         // Lista de elementos do arquivo
         std::list<PLYElement> elementList;
+        // ACMR da malha antes e depois da otimização da ordem dos triângulos (0 se ela não foi otimizada)
+        double acmrBefore, acmrAfter;
+        // Quantidade de vértices removidos pela solda dos vértices coincidentes
+        int weldedVertexCount;
     public:
+        PLYObject();
+
         // Obtém o formato e a versão do arquivo
         PLYFormatVersion getFileFormat();
         // Define o formato e a versão do arquivo
@@ -78,6 +135,14 @@ class PLYObject : public Object
         void addElement(PLYElement element);
         // Obtém a lista de elementos do arquivo
         std::list<PLYElement> getElementList();
+
+        // Define e obtém o ACMR da malha antes e depois da otimização da ordem dos triângulos
+        void setVertexCacheStats(double acmrBefore, double acmrAfter);
+        void getVertexCacheStats(double &acmrBefore, double &acmrAfter);
+
+        // Define e obtém a quantidade de vértices removidos pela solda
+        void setWeldedVertexCount(int weldedVertexCount);
+        int getWeldedVertexCount();
 };
 
 #endif // PLYFILE_H_INCLUDED
@@ -6,19 +6,246 @@
 #include <sstream>
 #include <stdexcept>
 #include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <climits>
+#include <memory>
 #include <string>
 #include <vector>
+#include <functional>
 
 #include "PLYObject.h"
+#include "PLYStreamHandler.h"
+
+#include "../io/MappedFile.h"
+#include "../io/MeshCache.h"
+#include "../io/FileWindow.h"
 
 #include "../primitive/Triangle.h"
-#include "../primitive/Quad.h"
+#include "../primitive/Triangulator.h"
+
+// Atributos de vértice reconhecidos, na ordem em que são guardados em um registro lido
+enum PLYVertexAttribute
+{
+    PLY_VERTEX_X,
+    PLY_VERTEX_Y,
+    PLY_VERTEX_Z,
+    PLY_VERTEX_NX,
+    PLY_VERTEX_NY,
+    PLY_VERTEX_NZ,
+    PLY_VERTEX_RED,
+    PLY_VERTEX_GREEN,
+    PLY_VERTEX_BLUE,
+    PLY_VERTEX_U,
+    PLY_VERTEX_V,
+    PLY_VERTEX_ATTRIBUTE_COUNT
+};
+
+// Estrutura que guarda a disposição dos atributos nas propriedades do elemento de vértice
+struct PLYVertexLayout
+{
+    // Atributo guardado por cada propriedade (ou -1, se for ignorada) e fator aplicado ao valor
+    // lido (as cores inteiras são levadas para o intervalo [0, 1])
+    std::vector<int> attributeIndexList;
+    std::vector<double> attributeScaleList;
+    // Indica quais grupos de atributos estão completos no arquivo
+    bool hasNormal, hasColor, hasTexCoord;
+
+    PLYVertexLayout()
+    {
+        this->hasNormal = false;
+        this->hasColor = false;
+        this->hasTexCoord = false;
+    }
+};
+
+// Estrutura que acumula os limites dos vértices durante a leitura
+struct PLYBounds
+{
+    double min[3], max[3];
+    bool empty;
+
+    PLYBounds()
+    {
+        for(int k = 0; k < 3; k++)
+        {
+            this->min[k] = 0.0;
+            this->max[k] = 0.0;
+        }
+
+        this->empty = true;
+    }
+
+    // Inclui um ponto nos limites
+    void add(double x, double y, double z)
+    {
+        if(empty)
+        {
+            min[0] = max[0] = x;
+            min[1] = max[1] = y;
+            min[2] = max[2] = z;
+            empty = false;
+            return;
+        }
+
+        if(x < min[0]) min[0] = x;
+        if(x > max[0]) max[0] = x;
+        if(y < min[1]) min[1] = y;
+        if(y > max[1]) max[1] = y;
+        if(z < min[2]) min[2] = z;
+        if(z > max[2]) max[2] = z;
+    }
+
+    // Inclui os limites de outro bloco de vértices
+    void merge(const PLYBounds &bounds)
+    {
+        if(!bounds.empty)
+        {
+            add(bounds.min[0], bounds.min[1], bounds.min[2]);
+            add(bounds.max[0], bounds.max[1], bounds.max[2]);
+        }
+    }
+};
 
 class PLYReader
 {
+    private:
+        // Limite de vértices e quantidade de envoltórias convexas geradas na importação (0 desabilita)
+        int hullMaxVertices;
+        int hullCount;
+        // Quantidade de threads usadas na leitura do corpo ASCII
+        int threadCount;
+        // Indica se as malhas lidas são guardadas e recuperadas do cache binário
+        bool cacheEnabled;
+        // Indica se os vértices coincidentes são soldados e a distância máxima entre eles (no espaço [-1, 1])
+        bool weldEnabled;
+        double weldEpsilon;
+        // Tamanho da janela de leitura (em bytes) da leitura em fluxo
+        size_t streamWindowSize;
+        // Função que recebe o progresso (entre 0 e 1) da leitura de um arquivo
+        std::function<void(double)> progressCallback;
+
+        // Informa o progresso da leitura, se houver uma função registrada
+        void reportProgress(double progress);
+        // Informa o progresso da leitura do corpo a partir da quantidade de bytes já lida
+        void reportParseProgress(size_t offset, size_t dataSize);
+
+        // Obtém o tipo de propriedade a partir do nome usado no cabeçalho (ex.: "float", "uint8")
+        static PLYPropertyType parsePropertyType(std::string typeName);
+        // Obtém o tamanho em bytes de um tipo de propriedade
+        static int getPropertyTypeSize(PLYPropertyType type);
+        // Lê um valor binário do tipo informado, invertendo a ordem dos bytes se necessário
+        static double readBinaryValue(const char *data, PLYPropertyType type, bool swapBytes);
+        // Inverte a ordem dos bytes de cada valor de 4 bytes de um bloco
+        static void swapBytes4(char *data, int valueCount);
+        // Verifica se ainda há size bytes no bloco binário a partir de offset
+        static void checkBinarySize(size_t offset, size_t size, size_t dataSize);
+        // Lê o tamanho de uma lista binária. Lança exceção se ele for negativo ou inválido
+        static int readListCount(const char *data, PLYPropertyType countType, bool swapBytes);
+        // Verifica se a ordem dos bytes de um arquivo binário difere da ordem da máquina
+        static bool isByteSwapped(PLYType plyType);
+
+        // Cria os triângulos da face formada pelos vértices informados, acrescentando-os em faceList
+        static void createFaces(std::vector<Vertex3D*> *vertexList, const int *vertexIdList, int vertexCount, std::vector<Primitive*> &faceList);
+        // Adiciona ao objeto os triângulos da face formada pelos vértices informados
+        void addFace(PLYObject *plyObject, const int *vertexIdList, int vertexCount);
+
+        // Obtém a disposição dos atributos nas propriedades do vértice (as coordenadas x, y e z são obrigatórias)
+        static PLYVertexLayout getVertexLayout(const std::vector<PLYProperty> &propertyList);
+        // Obtém a posição no registro binário do grupo de atributos que começa em firstAttribute,
+        // se o grupo for formado por três propriedades float seguidas (ou -1, caso contrário)
+        static int getFloatTripleOffset(const std::vector<PLYProperty> &propertyList, const PLYVertexLayout &layout, const std::vector<int> &propertyOffsetList, int firstAttribute);
+        // Aloca no objeto as listas dos atributos presentes no arquivo
+        static void prepareVertexAttributes(PLYObject *plyObject, int vertexCount, const PLYVertexLayout &layout);
+        // Guarda no objeto os atributos (exceto as coordenadas) de um registro de vértice lido
+        static void storeVertexAttributes(PLYObject *plyObject, int idVertex, const double *record, const PLYVertexLayout &layout);
+        // Obtém a posição da lista de índices dos vértices entre as propriedades da face
+        static int getIndexListIndex(const std::vector<PLYProperty> &propertyList);
+
+        // Pula espaços e quebras de linha; lança exceção se o conteúdo terminar antes de um valor
+        static const char* skipWhitespace(const char *data, const char *end);
+        // Pula um valor ASCII sem convertê-lo
+        static const char* skipToken(const char *data, const char *end);
+        // Converte um valor ASCII real ou inteiro sem cópias, retornando a posição após o valor
+        // (inteiros fora do intervalo de int lançam exceção)
+        static const char* parseDouble(const char *data, const char *end, double &value);
+        static const char* parseInt(const char *data, const char *end, int &value);
+        // Converte o tamanho ASCII de uma lista. Lança exceção se ele for negativo
+        static const char* parseListCount(const char *data, const char *end, int &count);
+
+        // Lê um registro ASCII de vértice (guardando os atributos em record, na ordem de PLYVertexAttribute)
+        // ou de face (acrescentando os índices em vertexIdList), ou pula um registro de outro elemento
+        static const char* parseVertexRecord(const char *data, const char *end, const std::vector<PLYProperty> &propertyList, const PLYVertexLayout &layout, double *record);
+        static const char* parseFaceRecord(const char *data, const char *end, const std::vector<PLYProperty> &propertyList, int indexListIndex, std::vector<int> &vertexIdList);
+        static const char* skipRecord(const char *data, const char *end, const std::vector<PLYProperty> &propertyList);
+
+        // Executa as tarefas 0 a taskCount - 1 no conjunto de threads compartilhado, relançando a primeira exceção
+        static void runParallel(int taskCount, const std::function<void(int)> &task);
+
+        // Lê os elementos do corpo (já mapeado em memória) de um arquivo ASCII, acumulando em bounds os limites dos vértices
+        void readAsciiElements(const char *data, size_t dataSize, PLYObject *plyObject, PLYBounds &bounds);
+        // Lê os elementos ASCII dividindo as linhas em blocos lidos em paralelo. Retorna falso, sem
+        // alterar o objeto, se o corpo não estiver no formato de um registro por linha
+        bool readAsciiElementsParallel(const char *data, size_t dataSize, PLYObject *plyObject, PLYBounds &bounds);
+        // Lê os elementos do corpo (já mapeado em memória) de um arquivo binário a partir dos tipos declarados no cabeçalho
+        void readBinaryElements(const char *data, size_t dataSize, PLYObject *plyObject, bool swapBytes, PLYBounds &bounds);
+
+        // Lê o cabeçalho de um arquivo PLY, criando o objeto com o formato, os comentários e os elementos declarados
+        static PLYObject* readHeader(std::istream &plyStream);
+
+        // Percorre pela janela de leitura os registros dos elementos declarados em plyObject, entregando
+        // os atributos de cada vértice (na ordem de PLYVertexAttribute) e os índices de cada face.
+        // Se verticesOnly for verdadeiro, para logo após o elemento de vértice
+        static void streamElements(FileWindow &window, PLYObject *plyObject, bool verticesOnly,
+                                   const std::function<void(const double*)> &vertexCallback,
+                                   const std::function<void(const int*, int)> &faceCallback);
+
+        // Obtém a descrição das opções de processamento que alteram a malha guardada no cache
+        std::string getCacheSettings();
+        // Cria o objeto a partir de um cache carregado (NULL se os blocos forem inconsistentes)
+        static PLYObject* readCachedObject(MeshCache &meshCache);
+        // Grava no cache a malha processada e o cabeçalho original do arquivo
+        static void saveCachedObject(MeshCache &meshCache, PLYObject *plyObject, const char *headerData, size_t headerSize);
     public:
+        PLYReader();
+
+        // Habilita a geração de hullCount envoltórias convexas com até maxVertices vértices
+        // para cada objeto lido (maxVertices igual a 0 desabilita a geração)
+        void setConvexHullGeneration(int maxVertices, int hullCount = 1);
+
+        // Define a quantidade de threads da leitura de arquivos ASCII (padrão: núcleos disponíveis; 1 desabilita)
+        void setThreadCount(int threadCount);
+
+        // Habilita o cache binário das malhas lidas (padrão: habilitado)
+        void setCacheEnabled(bool cacheEnabled);
+        // Habilita a solda dos vértices que distam no máximo epsilon (medida depois da reescala para
+        // o intervalo [-1, 1]; 0 solda apenas as posições idênticas) e têm os mesmos atributos nos objetos
+        // lidos (padrão: desabilitada)
+        void setVertexWelding(bool enabled, double epsilon = 0.0);
+
+        // Define o tamanho da janela de leitura em fluxo (padrão: 1 MB)
+        void setStreamWindowSize(size_t streamWindowSize);
+
+        // Define a função chamada com o progresso (entre 0 e 1) das próximas leituras, na thread que chamou a leitura
+        void setProgressCallback(const std::function<void(double)> &progressCallback);
+
         // Lê um arquivo PLY
         PLYObject* read_ply_file(std::string ply_filepath);
+
+        // Estima a memória (em bytes) ocupada pelo objeto lido de um arquivo PLY, a partir
+        // das quantidades de vértices e faces declaradas no cabeçalho (com compact verdadeiro,
+        // a memória do objeto lido em fluxo por stream_ply_object)
+        static size_t estimateMemorySize(std::string ply_filepath, bool compact = false);
+
+        // Lê um arquivo PLY em fluxo, com a memória limitada pela janela de leitura: uma primeira
+        // passada pelos vértices calcula os limites e a segunda entrega ao handler, em lotes, os
+        // vértices normalizados e quantizados e os triângulos (faces maiores divididas em leque).
+        // Nos arquivos ASCII, cada registro deve ocupar uma linha
+        void stream_ply_file(std::string ply_filepath, PLYStreamHandler *handler);
+
+        // Lê um arquivo PLY em fluxo para um objeto sem vértices em precisão dupla, apenas com a malha
+        // compacta de PLYMeshBuffer e as envoltórias convexas configuradas (sem solda dos vértices)
+        PLYObject* stream_ply_object(std::string ply_filepath);
 };
 
 #endif // PLYREADER_H_INCLUDED
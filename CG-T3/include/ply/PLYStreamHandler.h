@@ -0,0 +1,28 @@
+#ifndef PLYSTREAMHANDLER_H_INCLUDED
+#define PLYSTREAMHANDLER_H_INCLUDED
+
+#include "../primitive/VertexQuantizer.h"
+
+/*
+*   Destino dos lotes entregues pela leitura em fluxo de um arquivo PLY
+*
+*   Os vértices chegam normalizados (centralizados na origem, com o maior eixo em
+*   [-1, 1]) e quantizados em 16 bits (cada coordenada vezes VERTEX_QUANTIZATION_SCALE);
+*   os triângulos referenciam os vértices pela ordem em que aparecem no arquivo
+*/
+class PLYStreamHandler
+{
+    public:
+        virtual ~PLYStreamHandler() {}
+
+        // Início da malha, com as quantidades declaradas no cabeçalho e os limites originais dos vértices
+        virtual void beginMesh(int vertexCount, int faceCount, const double min[3], const double max[3]) = 0;
+        // Lote de vértices (3 coordenadas quantizadas por vértice)
+        virtual void addVertexBatch(const short *positionList, int vertexCount) = 0;
+        // Lote de triângulos (3 índices por triângulo)
+        virtual void addTriangleBatch(const unsigned int *indexList, int triangleCount) = 0;
+        // Fim da malha
+        virtual void endMesh() = 0;
+};
+
+#endif // PLYSTREAMHANDLER_H_INCLUDED
@@ -36,6 +36,8 @@ class Primitive : public Drawable
         std::vector<Vertex3D*>* getVertexList();
         // Obtém a quantidade de vértices da primitiva
         int getVertexCount();
+        // Obtém o vetor normal da primitiva
+        Vertex3D* getNormalVector();
 
         void addTextureVertex(Vertex3D* vertex);
         std::vector<Vertex3D*>* getTextureVertexList();
@@ -0,0 +1,94 @@
+#ifndef QUANTIZEDMESH_H_INCLUDED
+#define QUANTIZEDMESH_H_INCLUDED
+
+#include <vector>
+#include <cstddef>
+
+#include <GL/gl.h>
+
+#include "VertexQuantizer.h"
+
+#include "../collision/AffineTransform.h"
+
+/*
+*   Malha de triângulos nos formatos compactos de VertexQuantizer
+*
+*   Guarda as posições e as coordenadas de textura em 16 bits por componente, as normais
+*   (dos vértices ou dos triângulos) na forma octaédrica, as cores em 8 bits e os índices
+*   dos triângulos. É construída no espaço local de um objeto, que informa a sua
+*   transformação nas consultas, e as posições e coordenadas de textura voltam aos valores
+*   originais pelas matrizes de modelo e de textura no próprio desenho
+*/
+class QuantizedMesh
+{
+    private:
+        // Posições (3 componentes), normais octaédricas (2 componentes) e índices (3 por triângulo)
+        std::vector<short> positionList;
+        std::vector<short> normalList;
+        std::vector<unsigned int> indexList;
+
+        // Normais octaédricas dos triângulos, usadas quando não há normais nos vértices
+        std::vector<short> faceNormalList;
+        // Cores RGB dos vértices (3 componentes) e coordenadas de textura (2 componentes)
+        std::vector<unsigned char> colorList;
+        std::vector<short> texCoordList;
+
+        // Cada posição original é positionOffset + quantizada * positionScale
+        float positionOffset[3], positionScale[3];
+        // Cada coordenada de textura original é texCoordOffset + quantizada * texCoordScale
+        float texCoordOffset[2], texCoordScale[2];
+        // Limites das posições reconstruídas
+        double min[3], max[3];
+
+        // Calcula os limites das posições reconstruídas
+        void updateBounds();
+        // Calcula a normal (não normalizada, proporcional à área) de um triângulo
+        void getTriangleNormal(int idTriangle, float normal[3]);
+        // Descarta os atributos dos vértices e dos triângulos
+        void clearAttributes();
+    public:
+        QuantizedMesh();
+
+        // Quantiza as posições (3 valores por vértice) e guarda os índices dos triângulos
+        void setGeometry(const float *positionList, size_t vertexCount, const std::vector<unsigned int> &indexList);
+        // Guarda posições já quantizadas (cada posição original é offset + quantizada * scale) e os
+        // índices dos triângulos, sem copiá-los (as listas informadas ficam vazias)
+        void setQuantizedGeometry(std::vector<short> &positionList, const float offset[3], const float scale[3], std::vector<unsigned int> &indexList);
+
+        // Codifica as normais dos vértices (3 valores por vértice, normalizadas na codificação)
+        void setNormals(const float *normalList);
+        // Calcula as normais dos vértices pela soma das normais dos seus triângulos (ponderadas pela área)
+        void computeNormals();
+        // Codifica as normais dos triângulos (3 valores por triângulo), usadas no desenho facetado das
+        // malhas sem normais nos vértices
+        void setFaceNormals(const float *faceNormalList);
+
+        // Guarda as cores dos vértices (3 valores em [0, 1] por vértice) em 8 bits por componente
+        void setColors(const float *colorList);
+        // Quantiza as coordenadas de textura dos vértices (2 valores por vértice)
+        void setTexCoords(const float *texCoordList);
+
+        // Obtém a quantidade de vértices e de triângulos
+        int getVertexCount();
+        int getTriangleCount();
+
+        // Obtém a posição reconstruída de um vértice
+        void getVertex(int idVertex, double vertex[3]);
+        // Obtém os índices dos três vértices de um triângulo
+        const unsigned int* getTriangle(int idTriangle);
+
+        // Obtém a caixa envolvente da malha transformada
+        void getBounds(const AffineTransform &transform, double min[3], double max[3]);
+
+        // Lança um raio contra os triângulos da malha transformada. Se houver uma interseção mais
+        // próxima que distance, atualiza distance (em unidades da direção) e o triângulo atingido
+        bool raycast(const double origin[3], const double direction[3], const AffineTransform &transform, double &distance, int &triangleIndex);
+
+        // Obtém a memória ocupada pelos atributos e índices, em bytes
+        size_t getMemorySize();
+
+        // Desenha os triângulos com o material atual e a cor atual (se não houver cores nos vértices)
+        void draw();
+};
+
+#endif // QUANTIZEDMESH_H_INCLUDED
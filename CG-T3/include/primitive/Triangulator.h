@@ -0,0 +1,27 @@
+#ifndef TRIANGULATOR_H_INCLUDED
+#define TRIANGULATOR_H_INCLUDED
+
+#include <vector>
+#include <cmath>
+
+/*
+*   Divisão de polígonos planares (ou quase planares) em triângulos
+*
+*   Polígonos convexos são divididos em leque a partir do primeiro vértice e
+*   os côncavos por remoção de orelhas na projeção sobre o plano do polígono
+*/
+class Triangulator
+{
+    private:
+        // Verifica se o ponto p está dentro (ou na borda) do triângulo abc no plano de projeção
+        static bool pointInTriangle(const double *p, const double *a, const double *b, const double *c);
+        // Produto vetorial 2D das arestas ab e ac
+        static double cross2D(const double *a, const double *b, const double *c);
+    public:
+        // Divide o polígono de vertexCount vértices (3 coordenadas por vértice em positionList) em
+        // vertexCount - 2 triângulos, acrescentando em triangleList os índices locais (0 a vertexCount - 1)
+        // de cada triângulo, na mesma orientação do polígono
+        static void triangulate(const double *positionList, int vertexCount, std::vector<int> &triangleList);
+};
+
+#endif // TRIANGULATOR_H_INCLUDED
@@ -16,8 +16,9 @@ class Vertex3D
         // Cria um vértice nas coordenadas (x, y, z)
         Vertex3D(int id, double x, double y, double z);
 
-        // Obtém o Id do vértice
+        // Obtém e define o Id do vértice
         int getId();
+        void setId(int id);
 
         // Obtém as coordenadas do vértice
         double getX();
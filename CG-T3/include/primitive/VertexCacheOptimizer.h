@@ -0,0 +1,52 @@
+#ifndef VERTEXCACHEOPTIMIZER_H_INCLUDED
+#define VERTEXCACHEOPTIMIZER_H_INCLUDED
+
+#include <vector>
+#include <cstddef>
+
+/*
+*   Otimização da ordem dos triângulos e dos vértices de uma malha indexada
+*
+*   Os triângulos são reordenados pelo algoritmo de Tom Forsyth, que escolhe a cada
+*   passo o triângulo cujos vértices estão mais bem posicionados em uma cache LRU
+*   simulada, aproveitando melhor a cache de vértices transformados da GPU. Depois,
+*   os vértices são renumerados na ordem do primeiro uso, para que a leitura dos
+*   atributos percorra a memória quase sequencialmente
+*/
+class VertexCacheOptimizer
+{
+    private:
+        // Pontuação de um vértice pela posição na cache simulada (-1 se estiver fora) e
+        // pela quantidade de triângulos ainda não emitidos que o usam
+        static float getVertexScore(int cachePosition, unsigned int remainingTriangles);
+    public:
+        // Reordena os triângulos de indexList (3 índices por triângulo, menores que vertexCount).
+        // triangleOrderList recebe, para cada posição da nova ordem, o índice original do triângulo
+        static void optimizeTriangleOrder(unsigned int *indexList, size_t indexCount, unsigned int vertexCount, std::vector<unsigned int> &triangleOrderList);
+
+        // Renumera os vértices na ordem do primeiro uso em indexList, atualizando os índices.
+        // remapList recebe o novo índice de cada vértice antigo (os vértices não usados vão
+        // para o final, na ordem original)
+        static void optimizeVertexOrder(unsigned int *indexList, size_t indexCount, unsigned int vertexCount, std::vector<unsigned int> &remapList);
+
+        // Obtém a quantidade média de vértices transformados por triângulo (ACMR) em uma cache FIFO
+        // como a das GPUs (entre 0.5 e 3, quanto menor melhor)
+        static double getACMR(const unsigned int *indexList, size_t indexCount, unsigned int vertexCount);
+
+        // Reordena um atributo com components valores por vértice segundo remapList
+        template<typename T>
+        static void remapAttribute(T *attributeList, const std::vector<unsigned int> &remapList, int components)
+        {
+            std::vector<T> oldList(attributeList, attributeList + remapList.size() * components);
+
+            for(size_t i = 0; i < remapList.size(); i++)
+            {
+                for(int k = 0; k < components; k++)
+                {
+                    attributeList[(size_t)remapList[i] * components + k] = oldList[i * components + k];
+                }
+            }
+        }
+};
+
+#endif // VERTEXCACHEOPTIMIZER_H_INCLUDED
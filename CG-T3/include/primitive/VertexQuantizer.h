@@ -0,0 +1,58 @@
+#ifndef VERTEXQUANTIZER_H_INCLUDED
+#define VERTEXQUANTIZER_H_INCLUDED
+
+#include <cstddef>
+#include <cmath>
+
+// Maior valor de uma componente quantizada em 16 bits (os valores ficam em [-32767, 32767])
+#define VERTEX_QUANTIZATION_SCALE 32767.0f
+
+/*
+*   Formatos compactos dos atributos dos vértices
+*
+*   Posições e coordenadas de textura são guardadas como inteiros de 16 bits em torno
+*   do centro dos seus limites, e voltam aos valores originais por uma translação e uma
+*   escala (as matrizes de modelo e de textura fazem isso no próprio desenho). As normais
+*   unitárias são projetadas no octaedro |x| + |y| + |z| = 1 e desdobradas no quadrado
+*   [-1, 1]², ocupando apenas duas componentes de 16 bits
+*/
+class VertexQuantizer
+{
+    public:
+        // Quantiza count valores com components componentes cada (no máximo 4). Cada valor original é
+        // offset + quantizado * scale (com uniform verdadeiro, todas as componentes usam a
+        // mesma escala, o que preserva as proporções e, portanto, as normais da malha)
+        static void quantize(const float *valueList, size_t count, int components, bool uniform, short *quantizedList, float *offset, float *scale);
+
+        // Reconstrói os valores quantizados por quantize()
+        static void dequantize(const short *quantizedList, size_t count, int components, const float *offset, const float *scale, float *valueList);
+
+        // Codifica uma normal unitária nas duas componentes octaédricas que a reconstroem com o menor erro
+        static void encodeOctahedral(const float *normal, short *encoded);
+
+        // Decodifica uma normal octaédrica (o resultado é unitário)
+        static void decodeOctahedral(const short *encoded, float *normal)
+        {
+            float x = encoded[0] / VERTEX_QUANTIZATION_SCALE;
+            float y = encoded[1] / VERTEX_QUANTIZATION_SCALE;
+            float z = 1.0f - fabsf(x) - fabsf(y);
+
+            // O hemisfério negativo foi dobrado sobre os cantos do quadrado
+            if(z < 0.0f)
+            {
+                float foldedX = (1.0f - fabsf(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+                float foldedY = (1.0f - fabsf(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+
+                x = foldedX;
+                y = foldedY;
+            }
+
+            float length = sqrtf(x * x + y * y + z * z);
+
+            normal[0] = x / length;
+            normal[1] = y / length;
+            normal[2] = z / length;
+        }
+};
+
+#endif // VERTEXQUANTIZER_H_INCLUDED
@@ -0,0 +1,33 @@
+#ifndef VERTEXWELDER_H_INCLUDED
+#define VERTEXWELDER_H_INCLUDED
+
+#include <vector>
+#include <functional>
+
+/*
+*   Solda de vértices coincidentes de uma malha indexada
+*
+*   Os vértices são distribuídos em um hash espacial com células de lado igual ao
+*   dobro da tolerância, e cada vértice só é comparado com os já mantidos nas 8
+*   células que a sua vizinhança alcança, o que torna a solda linear no tempo esperado
+*/
+class VertexWelder
+{
+    private:
+        template<typename T>
+        static unsigned int weldPositions(const T *positionList, unsigned int vertexCount, double epsilon,
+                                          const std::function<bool(unsigned int, unsigned int)> *compatible, std::vector<unsigned int> &remapList);
+    public:
+        // Agrupa os vértices (3 coordenadas cada em positionList) que distam no máximo epsilon de um
+        // vértice mantido (com epsilon igual a 0, apenas as posições idênticas). remapList recebe o novo
+        // índice de cada vértice, com os mantidos numerados na ordem original. Retorna a quantidade
+        // de vértices mantidos
+        static unsigned int weld(const double *positionList, unsigned int vertexCount, double epsilon, std::vector<unsigned int> &remapList);
+        static unsigned int weld(const float *positionList, unsigned int vertexCount, double epsilon, std::vector<unsigned int> &remapList);
+        // Como acima, mas o vértice i só é soldado ao mantido j se compatible(i, j) for verdadeiro
+        // (atributos diferentes, como as normais de uma aresta viva, mantêm vértices separados)
+        static unsigned int weld(const double *positionList, unsigned int vertexCount, double epsilon,
+                                 const std::function<bool(unsigned int, unsigned int)> &compatible, std::vector<unsigned int> &remapList);
+};
+
+#endif // VERTEXWELDER_H_INCLUDED
@@ -9,13 +9,24 @@
 #include <vector>
 
 #include "../object/ObjectGroup.h"
+#include "SceneBVH.h"
 
 class Scene
 {
     private:
         // Lista de grupos de objetos da cena
         std::vector<ObjectGroup*> objectGroupList;
+
+        // BVH usada nas consultas e a reviso dos objetos em que foi construda
+        SceneBVH *sceneBVH;
+        unsigned long sceneBVHRevision;
+
+        // Obtm a BVH da cena, reconstruindo-a se algum objeto mudou
+        SceneBVH* getSceneBVH();
     public:
+        Scene();
+        ~Scene();
+
         // Adiciona um novo grupo de objetos na cena
         void addNewObjectGroup(std::string groupName);
         void addObjectGroup(ObjectGroup *group);
@@ -30,6 +41,13 @@ class Scene
         // Obtm o tamanho da lista de grupos de objetos da cena
         int objectGroupListSize();
 
+        // Lana um raio e obtm o objeto, a face e o ponto atingidos mais prximos da origem
+        bool raycast(const double origin[3], const double direction[3], SceneRayHit &hit);
+        // Obtm o objeto mais prximo de um ponto
+        bool nearestObject(const double point[3], SceneObjectRef &objectRef);
+        // Obtm os objetos a at radius de um ponto
+        std::vector<SceneObjectRef> objectsWithinRadius(const double point[3], double radius);
+
         // Salva a cena em arquivo
         void saveScene(std::string filePath);
         // Carrega a cena a partir de arquivo
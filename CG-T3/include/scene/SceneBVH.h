@@ -0,0 +1,73 @@
+#ifndef SCENEBVH_H_INCLUDED
+#define SCENEBVH_H_INCLUDED
+
+#include <vector>
+
+#include "../object/ObjectGroup.h"
+
+// Referência a um objeto da cena (grupo e posição do objeto no grupo)
+struct SceneObjectRef
+{
+    int groupIndex;
+    int objectIndex;
+    Object *object;
+};
+
+// Resultado de um raio lançado na cena
+struct SceneRayHit
+{
+    SceneObjectRef objectRef;
+    // Face atingida do objeto
+    int faceIndex;
+    // Ponto atingido e distância a partir da origem do raio
+    double point[3];
+    double distance;
+};
+
+// Nó da BVH da cena. Em nós internos, leftFirst é o filho da esquerda (o da direita é leftFirst + 1).
+// Em folhas, leftFirst é o primeiro objeto e objectCount é a quantidade de objetos
+struct SceneBVHNode
+{
+    double bmin[3], bmax[3];
+    int leftFirst;
+    int objectCount;
+};
+
+/*
+*   Hierarquia de volumes envolventes (BVH) dos objetos da cena
+*
+*   Os objetos são organizados pelas suas caixas envolventes no espaço do mundo.
+*   As paredes (primeiro objeto de cada grupo) não participam das consultas
+*/
+class SceneBVH
+{
+    private:
+        // Objetos referenciados e as suas caixas envolventes (6 valores por objeto)
+        std::vector<SceneObjectRef> objectRefList;
+        std::vector<double> boundsList;
+        // Ordem dos objetos referenciada pelas folhas
+        std::vector<int> objectIndexList;
+        // Nós da árvore (o nó 0 é a raiz)
+        std::vector<SceneBVHNode> nodeList;
+
+        void updateNodeBounds(int nodeIndex);
+        void subdivide(int nodeIndex);
+
+        // Obtém o quadrado da distância de um ponto até uma caixa (0 se estiver dentro)
+        static double squaredDistance(const double point[3], const double bmin[3], const double bmax[3]);
+    public:
+        // Constrói a BVH a partir dos grupos de objetos da cena
+        SceneBVH(std::vector<ObjectGroup*> *objectGroupList);
+
+        // Obtém a quantidade de objetos da BVH
+        int getObjectCount();
+
+        // Lança um raio (direção normalizada) e obtém a interseção mais próxima com as faces dos objetos
+        bool raycast(const double origin[3], const double direction[3], SceneRayHit &hit);
+        // Obtém o objeto cuja caixa envolvente está mais próxima do ponto
+        bool nearestObject(const double point[3], SceneObjectRef &objectRef);
+        // Obtém os objetos cuja caixa envolvente está a até radius do ponto
+        void objectsWithinRadius(const double point[3], double radius, std::vector<SceneObjectRef> &objectRefList);
+};
+
+#endif // SCENEBVH_H_INCLUDED
@@ -0,0 +1,38 @@
+/*
+  Name:        glcTextureCache.h
+  Date:        19/10/2026
+  Description: Textures shared by path. Each image is loaded once, on the first
+               request, and its texture object is returned to every later request.
+*/
+
+#ifndef _GLC_TEXTURE_CACHE_H
+#define _GLC_TEXTURE_CACHE_H
+
+#include <GL/gl.h>
+
+#include <map>
+#include <string>
+
+#include "glcTexture.h"
+
+class glcTextureCache : public glcTexture
+{
+    public:
+        glcTextureCache();
+
+        // Cache shared by the whole application (used by glcWavefrontObject)
+        static glcTextureCache* GetSharedCache();
+
+        // Returns the texture object of an image, loading it on the first request (0 if
+        // it can't be loaded). Only PNG is supported, so other formats fall back to a PNG
+        // with the same base name. Must be called from the thread that owns the GL context
+        GLuint GetTexture(const std::string& path);
+        int    GetNumberOfLoadedTextures();
+
+    private:
+        std::map<std::string, GLuint> textureMap;   // requested and resolved paths -> texture object
+
+        std::string ResolvePath(const std::string& path);
+};
+
+#endif
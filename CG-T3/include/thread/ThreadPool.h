@@ -0,0 +1,78 @@
+#ifndef THREADPOOL_H_INCLUDED
+#define THREADPOOL_H_INCLUDED
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+
+// Estrutura que guarda um conjunto de tarefas submetido ao conjunto de threads
+struct ThreadPoolBatch
+{
+    const std::function<void(int)> *task;
+    int taskCount;
+    // Próxima tarefa a iniciar (protegida pelo bloqueio do conjunto de threads)
+    int nextTask;
+    // Tarefas terminadas e a primeira exceção lançada por elas
+    int finishedCount;
+    std::exception_ptr error;
+
+    std::mutex batchMutex;
+    std::condition_variable finishedCondition;
+
+    ThreadPoolBatch(const std::function<void(int)> *task, int taskCount)
+    {
+        this->task = task;
+        this->taskCount = taskCount;
+        this->nextTask = 0;
+        this->finishedCount = 0;
+    }
+};
+
+/*
+*   Conjunto de threads que executa tarefas em paralelo
+*
+*   As threads são criadas uma única vez e aguardam novos conjuntos de tarefas. A thread que
+*   submete um conjunto também executa tarefas dele enquanto houver alguma não iniciada, o que
+*   permite submeter conjuntos de dentro de outras tarefas sem que o conjunto de threads trave
+*/
+class ThreadPool
+{
+    private:
+        std::vector<std::thread> workerList;
+        std::mutex poolMutex;
+        std::condition_variable taskCondition;
+
+        // Conjuntos com tarefas ainda não iniciadas, na ordem de submissão
+        std::deque<ThreadPoolBatch*> batchQueue;
+        bool stopWorkers;
+
+        ThreadPool(const ThreadPool&);
+        ThreadPool& operator=(const ThreadPool&);
+
+        // Laço de cada thread do conjunto
+        void workerLoop();
+        // Obtém a próxima tarefa do conjunto, retirando-o da fila ao iniciar a última (poolMutex deve estar bloqueado)
+        int takeTask(ThreadPoolBatch *batch);
+        // Executa uma tarefa do conjunto, guardando a exceção lançada por ela
+        static void executeTask(ThreadPoolBatch *batch, int taskIndex);
+    public:
+        // Cria o conjunto com a quantidade de threads informada (0 executa as tarefas na thread que as submeteu)
+        ThreadPool(int threadCount);
+        ~ThreadPool();
+
+        // Obtém o conjunto de threads compartilhado pela aplicação, que junto com a thread que
+        // submete as tarefas ocupa todos os núcleos disponíveis
+        static ThreadPool& getSharedPool();
+
+        // Obtém a quantidade de tarefas executadas ao mesmo tempo (threads do conjunto mais a que submete)
+        int getConcurrency();
+
+        // Executa as tarefas 0 a taskCount - 1 e aguarda o término de todas, relançando a primeira exceção
+        void run(int taskCount, const std::function<void(int)> &task);
+};
+
+#endif // THREADPOOL_H_INCLUDED
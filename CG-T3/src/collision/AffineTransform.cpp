@@ -0,0 +1,158 @@
+#include "collision/AffineTransform.h"
+
+#include <cmath>
+
+AffineTransform::AffineTransform()
+{
+    setIdentity();
+}
+
+void AffineTransform::setIdentity()
+{
+    for(int i = 0; i < 3; i++)
+    {
+        for(int j = 0; j < 4; j++)
+        {
+            m[i][j] = (i == j) ? 1.0 : 0.0;
+        }
+    }
+}
+
+void AffineTransform::scale(double sx, double sy, double sz)
+{
+    for(int j = 0; j < 4; j++)
+    {
+        m[0][j] *= sx;
+        m[1][j] *= sy;
+        m[2][j] *= sz;
+    }
+}
+
+void AffineTransform::translate(double dx, double dy, double dz)
+{
+    m[0][3] += dx;
+    m[1][3] += dy;
+    m[2][3] += dz;
+}
+
+void AffineTransform::rotateX(double angle)
+{
+    double sinVal = sin(angle);
+    double cosVal = cos(angle);
+
+    // Mesma convenção de Object::rotateXAxis
+    for(int j = 0; j < 4; j++)
+    {
+        double y = m[1][j];
+        double z = m[2][j];
+
+        m[1][j] = y * cosVal - z * sinVal;
+        m[2][j] = y * sinVal + z * cosVal;
+    }
+}
+
+void AffineTransform::rotateY(double angle)
+{
+    double sinVal = sin(angle);
+    double cosVal = cos(angle);
+
+    // Mesma convenção de Object::rotateYAxis
+    for(int j = 0; j < 4; j++)
+    {
+        double x = m[0][j];
+        double z = m[2][j];
+
+        m[0][j] = z * sinVal + x * cosVal;
+        m[2][j] = z * cosVal - x * sinVal;
+    }
+}
+
+void AffineTransform::rotateZ(double angle)
+{
+    double sinVal = sin(angle);
+    double cosVal = cos(angle);
+
+    // Mesma convenção de Object::rotateZAxis
+    for(int j = 0; j < 4; j++)
+    {
+        double x = m[0][j];
+        double y = m[1][j];
+
+        m[0][j] = x * cosVal - y * sinVal;
+        m[1][j] = x * sinVal + y * cosVal;
+    }
+}
+
+void AffineTransform::transformPoint(const double in[3], double out[3]) const
+{
+    for(int i = 0; i < 3; i++)
+    {
+        out[i] = m[i][0] * in[0] + m[i][1] * in[1] + m[i][2] * in[2] + m[i][3];
+    }
+}
+
+void AffineTransform::transformVector(const double in[3], double out[3]) const
+{
+    for(int i = 0; i < 3; i++)
+    {
+        out[i] = m[i][0] * in[0] + m[i][1] * in[1] + m[i][2] * in[2];
+    }
+}
+
+void AffineTransform::transformVectorTransposed(const double in[3], double out[3]) const
+{
+    for(int i = 0; i < 3; i++)
+    {
+        out[i] = m[0][i] * in[0] + m[1][i] * in[1] + m[2][i] * in[2];
+    }
+}
+
+bool AffineTransform::inverse(AffineTransform &out) const
+{
+    // Cofatores da parte linear
+    double c00 = m[1][1] * m[2][2] - m[1][2] * m[2][1];
+    double c01 = m[1][2] * m[2][0] - m[1][0] * m[2][2];
+    double c02 = m[1][0] * m[2][1] - m[1][1] * m[2][0];
+
+    double det = m[0][0] * c00 + m[0][1] * c01 + m[0][2] * c02;
+
+    if(fabs(det) < 1e-12)
+    {
+        return false;
+    }
+
+    double invDet = 1.0 / det;
+
+    out.m[0][0] = c00 * invDet;
+    out.m[0][1] = (m[0][2] * m[2][1] - m[0][1] * m[2][2]) * invDet;
+    out.m[0][2] = (m[0][1] * m[1][2] - m[0][2] * m[1][1]) * invDet;
+
+    out.m[1][0] = c01 * invDet;
+    out.m[1][1] = (m[0][0] * m[2][2] - m[0][2] * m[2][0]) * invDet;
+    out.m[1][2] = (m[0][2] * m[1][0] - m[0][0] * m[1][2]) * invDet;
+
+    out.m[2][0] = c02 * invDet;
+    out.m[2][1] = (m[0][1] * m[2][0] - m[0][0] * m[2][1]) * invDet;
+    out.m[2][2] = (m[0][0] * m[1][1] - m[0][1] * m[1][0]) * invDet;
+
+    // Translação inversa: -A^-1 * t
+    for(int i = 0; i < 3; i++)
+    {
+        out.m[i][3] = -(out.m[i][0] * m[0][3] + out.m[i][1] * m[1][3] + out.m[i][2] * m[2][3]);
+    }
+
+    return true;
+}
+
+void AffineTransform::getMatrix(double matrix[16]) const
+{
+    for(int j = 0; j < 4; j++)
+    {
+        for(int i = 0; i < 3; i++)
+        {
+            matrix[4 * j + i] = m[i][j];
+        }
+
+        matrix[4 * j + 3] = (j == 3) ? 1.0 : 0.0;
+    }
+}
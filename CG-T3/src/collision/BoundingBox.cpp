@@ -1,5 +1,7 @@
 #include "collision/BoundingBox.h"
 
+#include <algorithm>
+
 BoundingBox::BoundingBox()
 {
     this->width = 0.0;
@@ -23,6 +25,38 @@ void BoundingBox::updateBox(Vertex3D center, double width, double length, double
     this->height = height;
 }
 
+Vertex3D BoundingBox::getCenter()
+{
+    return center;
+}
+
+double BoundingBox::getWidth()
+{
+    return width;
+}
+
+double BoundingBox::getLength()
+{
+    return length;
+}
+
+double BoundingBox::getHeight()
+{
+    return height;
+}
+
+void BoundingBox::getMinMax(double min[3], double max[3])
+{
+    min[0] = center.getX() - (width / 2.0);
+    max[0] = center.getX() + (width / 2.0);
+
+    min[1] = center.getY() - (height / 2.0);
+    max[1] = center.getY() + (height / 2.0);
+
+    min[2] = center.getZ() - (length / 2.0);
+    max[2] = center.getZ() + (length / 2.0);
+}
+
 bool BoundingBox::hit(BoundingBox *otherBox)
 {
     // Metade das dimenses em cada eixo da bounding box atual
@@ -64,3 +98,46 @@ bool BoundingBox::hit(BoundingBox *otherBox)
             && ((AminY < BmaxY) && (AmaxY > BminY))
             && ((AminZ < BmaxZ) && (AmaxZ > BminZ)));
 }
+
+double BoundingBox::sweep(BoundingBox *otherBox, const double displacement[3])
+{
+    double Amin[3], Amax[3], Bmin[3], Bmax[3];
+    getMinMax(Amin, Amax);
+    otherBox->getMinMax(Bmin, Bmax);
+
+    // Intervalo de tempo em que as projees se sobrepem em todos os eixos
+    double tEnter = -1e30;
+    double tExit = 1e30;
+
+    for(int axis = 0; axis < 3; axis++)
+    {
+        if(displacement[axis] == 0.0)
+        {
+            // Sem movimento no eixo, as projees precisam se sobrepor durante todo o deslocamento
+            if(!((Amin[axis] < Bmax[axis]) && (Amax[axis] > Bmin[axis])))
+            {
+                return 1.0;
+            }
+            continue;
+        }
+
+        double t0 = (Bmin[axis] - Amax[axis]) / displacement[axis];
+        double t1 = (Bmax[axis] - Amin[axis]) / displacement[axis];
+
+        if(t0 > t1)
+        {
+            std::swap(t0, t1);
+        }
+
+        tEnter = std::max(tEnter, t0);
+        tExit = std::min(tExit, t1);
+    }
+
+    // Sem sobreposio no intervalo [0, 1] ou caixas j sobrepostas no incio
+    if((tEnter >= tExit) || (tEnter >= 1.0) || (tExit <= 0.0) || (tEnter < 0.0))
+    {
+        return 1.0;
+    }
+
+    return tEnter;
+}
@@ -1,5 +1,8 @@
 #include "collision/Collider.h"
 
+#include <cmath>
+#include <algorithm>
+
 Collider::Collider()
 {
     // Instncia a bounding box
@@ -12,3 +15,103 @@ BoundingBox* Collider::getBoundingBox(Vertex3D center, double width, double leng
     boundingBox->updateBox(center, width, length, height);
     return boundingBox;
 }
+
+bool Collider::collide(BoundingBox *box, CollisionDetail /*detail*/)
+{
+    return getCollider()->hit(box);
+}
+
+// Obtm a bounding box deslocada pela frao t do deslocamento
+static BoundingBox moveBox(BoundingBox *box, const double displacement[3], double t)
+{
+    Vertex3D center = box->getCenter();
+
+    return BoundingBox(Vertex3D(-1, center.getX() + t * displacement[0], center.getY() + t * displacement[1], center.getZ() + t * displacement[2]),
+                       box->getWidth(), box->getLength(), box->getHeight());
+}
+
+double Collider::sweep(BoundingBox *box, const double displacement[3], CollisionDetail detail)
+{
+    // Fase ampla: impacto contra a bounding box do objeto. Se as caixas j se sobrepem,
+    // a malha ainda pode ser atravessada, e as amostras comeam no incio do deslocamento
+    double tEnter = 0.0;
+
+    if(!box->hit(getCollider()))
+    {
+        tEnter = box->sweep(getCollider(), displacement);
+
+        if(tEnter >= 1.0)
+        {
+            return 1.0;
+        }
+    }
+
+    // Passo entre as amostras (na frao do deslocamento) limitado a metade da menor dimenso da caixa,
+    // assim as caixas amostradas cobrem todo o volume varrido
+    double length = sqrt(displacement[0] * displacement[0] + displacement[1] * displacement[1] + displacement[2] * displacement[2]);
+    double minSize = std::min(box->getWidth(), std::min(box->getLength(), box->getHeight()));
+
+    // Caixa degenerada ou parada: no h como amostrar o volume varrido
+    if((minSize <= 0.0) || (length == 0.0))
+    {
+        return (tEnter > 0.0) ? tEnter : 1.0;
+    }
+
+    double step = (minSize / 2.0) / length;
+
+    // Contato j existente no incio do deslocamento no bloqueia, para que seja possvel se afastar,
+    // mas um novo contato depois de sair dele bloqueia normalmente
+    bool initialContact = (tEnter == 0.0) && collide(box, detail);
+
+    double tFree = tEnter;
+    double t = tEnter;
+
+    while(true)
+    {
+        BoundingBox sample = moveBox(box, displacement, t);
+
+        if(collide(&sample, detail))
+        {
+            if(!initialContact)
+            {
+                // Primeira amostra j em contato: o impacto  a entrada na bounding box
+                if(t == tEnter)
+                {
+                    return tEnter;
+                }
+
+                // Refina o instante de impacto por bisseo entre a ltima amostra livre e a atual
+                double tHit = t;
+
+                for(int i = 0; i < 12; i++)
+                {
+                    double tMiddle = (tFree + tHit) / 2.0;
+                    BoundingBox middle = moveBox(box, displacement, tMiddle);
+
+                    if(collide(&middle, detail))
+                    {
+                        tHit = tMiddle;
+                    }
+                    else
+                    {
+                        tFree = tMiddle;
+                    }
+                }
+
+                return tFree;
+            }
+        }
+        else
+        {
+            initialContact = false;
+            tFree = t;
+        }
+
+        if(t >= 1.0)
+        {
+            return 1.0;
+        }
+
+        t = std::min(t + step, 1.0);
+    }
+}
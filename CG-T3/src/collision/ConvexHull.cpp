@@ -0,0 +1,837 @@
+#include "collision/ConvexHull.h"
+
+#include <set>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+
+using namespace std;
+
+// Face triangular temporária usada durante a construção da envoltória
+struct HullFace
+{
+    int v[3];
+    double n[3];
+    double d;
+    vector<int> outsideList;
+    bool removed;
+};
+
+static inline void sub(const double *a, const double *b, double *out)
+{
+    out[0] = a[0] - b[0];
+    out[1] = a[1] - b[1];
+    out[2] = a[2] - b[2];
+}
+
+static inline void cross(const double *a, const double *b, double *out)
+{
+    out[0] = a[1] * b[2] - a[2] * b[1];
+    out[1] = a[2] * b[0] - a[0] * b[2];
+    out[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+static inline double dot(const double *a, const double *b)
+{
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+// Calcula o plano de uma face a partir dos seus vértices
+static void computeFacePlane(HullFace &face, const vector<double> &pointList)
+{
+    double e0[3], e1[3];
+    const double *p0 = &pointList[3 * face.v[0]];
+
+    sub(&pointList[3 * face.v[1]], p0, e0);
+    sub(&pointList[3 * face.v[2]], p0, e1);
+    cross(e0, e1, face.n);
+
+    double len = sqrt(dot(face.n, face.n));
+
+    if(len > 0.0)
+    {
+        face.n[0] /= len;
+        face.n[1] /= len;
+        face.n[2] /= len;
+    }
+
+    face.d = dot(face.n, p0);
+}
+
+static inline double faceDistance(const HullFace &face, const double *p)
+{
+    return dot(face.n, p) - face.d;
+}
+
+ConvexHull::ConvexHull(const vector<double> &pointList, int maxVertices)
+{
+    int pointCount = pointList.size() / 3;
+
+    if(maxVertices < 4)
+    {
+        maxVertices = 4;
+    }
+
+    if(pointCount <= 4)
+    {
+        vertexList = pointList;
+        return;
+    }
+
+    // Pontos extremos em cada eixo
+    int extreme[6] = { 0, 0, 0, 0, 0, 0 };
+
+    for(int i = 1; i < pointCount; i++)
+    {
+        for(int axis = 0; axis < 3; axis++)
+        {
+            if(pointList[3 * i + axis] < pointList[3 * extreme[axis] + axis])
+            {
+                extreme[axis] = i;
+            }
+
+            if(pointList[3 * i + axis] > pointList[3 * extreme[axis + 3] + axis])
+            {
+                extreme[axis + 3] = i;
+            }
+        }
+    }
+
+    double extent = 0.0;
+
+    for(int axis = 0; axis < 3; axis++)
+    {
+        extent = max(extent, pointList[3 * extreme[axis + 3] + axis] - pointList[3 * extreme[axis] + axis]);
+    }
+
+    double eps = 1e-9 * max(extent, 1.0);
+
+    // Par de extremos mais distante entre si
+    int i0 = extreme[0], i1 = extreme[3];
+    double bestDist = -1.0;
+
+    for(int a = 0; a < 6; a++)
+    {
+        for(int b = a + 1; b < 6; b++)
+        {
+            double diff[3];
+            sub(&pointList[3 * extreme[a]], &pointList[3 * extreme[b]], diff);
+
+            if(dot(diff, diff) > bestDist)
+            {
+                bestDist = dot(diff, diff);
+                i0 = extreme[a];
+                i1 = extreme[b];
+            }
+        }
+    }
+
+    if(sqrt(bestDist) <= eps)
+    {
+        vertexList.assign(pointList.begin() + 3 * i0, pointList.begin() + 3 * i0 + 3);
+        return;
+    }
+
+    // Ponto mais distante da reta (i0, i1)
+    double lineDir[3];
+    sub(&pointList[3 * i1], &pointList[3 * i0], lineDir);
+
+    int i2 = -1;
+    bestDist = eps;
+
+    for(int i = 0; i < pointCount; i++)
+    {
+        double diff[3], c[3];
+        sub(&pointList[3 * i], &pointList[3 * i0], diff);
+        cross(lineDir, diff, c);
+
+        double dist = sqrt(dot(c, c) / dot(lineDir, lineDir));
+
+        if(dist > bestDist)
+        {
+            bestDist = dist;
+            i2 = i;
+        }
+    }
+
+    // Pontos colineares: a envoltória degenera em um segmento
+    if(i2 < 0)
+    {
+        vertexList.assign(pointList.begin() + 3 * i0, pointList.begin() + 3 * i0 + 3);
+        vertexList.insert(vertexList.end(), pointList.begin() + 3 * i1, pointList.begin() + 3 * i1 + 3);
+        return;
+    }
+
+    // Ponto mais distante do plano (i0, i1, i2)
+    HullFace base;
+    base.v[0] = i0;
+    base.v[1] = i1;
+    base.v[2] = i2;
+    computeFacePlane(base, pointList);
+
+    int i3 = -1;
+    bestDist = eps;
+
+    for(int i = 0; i < pointCount; i++)
+    {
+        double dist = fabs(faceDistance(base, &pointList[3 * i]));
+
+        if(dist > bestDist)
+        {
+            bestDist = dist;
+            i3 = i;
+        }
+    }
+
+    // Pontos coplanares: usa os pontos extremos como aproximação
+    if(i3 < 0)
+    {
+        set<int> extremeSet(extreme, extreme + 6);
+        extremeSet.insert(i2);
+
+        for(auto it = extremeSet.begin(); it != extremeSet.end(); it++)
+        {
+            vertexList.insert(vertexList.end(), pointList.begin() + 3 * (*it), pointList.begin() + 3 * (*it) + 3);
+        }
+        return;
+    }
+
+    // Tetraedro inicial com as faces orientadas para fora
+    int tetra[4] = { i0, i1, i2, i3 };
+    double centroid[3] = { 0.0, 0.0, 0.0 };
+
+    for(int k = 0; k < 4; k++)
+    {
+        centroid[0] += pointList[3 * tetra[k]] / 4.0;
+        centroid[1] += pointList[3 * tetra[k] + 1] / 4.0;
+        centroid[2] += pointList[3 * tetra[k] + 2] / 4.0;
+    }
+
+    vector<HullFace> faceList;
+    int tetraFaces[4][3] = { { 0, 1, 2 }, { 0, 3, 1 }, { 0, 2, 3 }, { 1, 3, 2 } };
+
+    for(int f = 0; f < 4; f++)
+    {
+        HullFace face;
+        face.v[0] = tetra[tetraFaces[f][0]];
+        face.v[1] = tetra[tetraFaces[f][1]];
+        face.v[2] = tetra[tetraFaces[f][2]];
+        face.removed = false;
+        computeFacePlane(face, pointList);
+
+        if(faceDistance(face, centroid) > 0.0)
+        {
+            swap(face.v[1], face.v[2]);
+            computeFacePlane(face, pointList);
+        }
+
+        faceList.push_back(face);
+    }
+
+    // Distribui os pontos externos entre as faces
+    for(int i = 0; i < pointCount; i++)
+    {
+        if((i == i0) || (i == i1) || (i == i2) || (i == i3))
+        {
+            continue;
+        }
+
+        for(int f = 0; f < 4; f++)
+        {
+            if(faceDistance(faceList[f], &pointList[3 * i]) > eps)
+            {
+                faceList[f].outsideList.push_back(i);
+                break;
+            }
+        }
+    }
+
+    int hullVertexCount = 4;
+
+    while(hullVertexCount < maxVertices)
+    {
+        // Escolhe o ponto mais distante de toda a envoltória atual
+        int eye = -1;
+        double eyeDist = eps;
+
+        for(unsigned int f = 0; f < faceList.size(); f++)
+        {
+            if(faceList[f].removed)
+            {
+                continue;
+            }
+
+            for(unsigned int k = 0; k < faceList[f].outsideList.size(); k++)
+            {
+                int p = faceList[f].outsideList[k];
+                double dist = faceDistance(faceList[f], &pointList[3 * p]);
+
+                if(dist > eyeDist)
+                {
+                    eyeDist = dist;
+                    eye = p;
+                }
+            }
+        }
+
+        // Todos os pontos estão dentro da envoltória
+        if(eye < 0)
+        {
+            break;
+        }
+
+        const double *eyePoint = &pointList[3 * eye];
+
+        // Remove as faces visíveis a partir do ponto e guarda as suas arestas
+        set< pair<int, int> > visibleEdgeSet;
+        vector<int> orphanList;
+
+        for(unsigned int f = 0; f < faceList.size(); f++)
+        {
+            if(!faceList[f].removed && (faceDistance(faceList[f], eyePoint) > eps))
+            {
+                faceList[f].removed = true;
+
+                for(int k = 0; k < 3; k++)
+                {
+                    visibleEdgeSet.insert(make_pair(faceList[f].v[k], faceList[f].v[(k + 1) % 3]));
+                }
+
+                orphanList.insert(orphanList.end(), faceList[f].outsideList.begin(), faceList[f].outsideList.end());
+                faceList[f].outsideList.clear();
+            }
+        }
+
+        // O horizonte é formado pelas arestas visíveis cuja aresta oposta não é visível
+        unsigned int firstNewFace = faceList.size();
+
+        for(auto it = visibleEdgeSet.begin(); it != visibleEdgeSet.end(); it++)
+        {
+            if(visibleEdgeSet.count(make_pair(it->second, it->first)) == 0)
+            {
+                HullFace face;
+                face.v[0] = it->first;
+                face.v[1] = it->second;
+                face.v[2] = eye;
+                face.removed = false;
+                computeFacePlane(face, pointList);
+                faceList.push_back(face);
+            }
+        }
+
+        // Redistribui os pontos das faces removidas entre as novas faces
+        for(unsigned int k = 0; k < orphanList.size(); k++)
+        {
+            int p = orphanList[k];
+
+            if(p == eye)
+            {
+                continue;
+            }
+
+            for(unsigned int f = firstNewFace; f < faceList.size(); f++)
+            {
+                if(faceDistance(faceList[f], &pointList[3 * p]) > eps)
+                {
+                    faceList[f].outsideList.push_back(p);
+                    break;
+                }
+            }
+        }
+
+        hullVertexCount++;
+    }
+
+    // Copia os vértices usados pelas faces restantes
+    set<int> hullVertexSet;
+
+    for(unsigned int f = 0; f < faceList.size(); f++)
+    {
+        if(!faceList[f].removed)
+        {
+            hullVertexSet.insert(faceList[f].v, faceList[f].v + 3);
+        }
+    }
+
+    for(auto it = hullVertexSet.begin(); it != hullVertexSet.end(); it++)
+    {
+        vertexList.insert(vertexList.end(), pointList.begin() + 3 * (*it), pointList.begin() + 3 * (*it) + 3);
+    }
+}
+
+vector<ConvexHull*> ConvexHull::fromTriangles(const vector<double> &triangleList, int maxVertices, int hullCount)
+{
+    vector<ConvexHull*> hullList;
+    int triangleCount = triangleList.size() / 9;
+
+    if((triangleCount == 0) || (hullCount < 1))
+    {
+        return hullList;
+    }
+
+    // Ordena os triângulos pelo centróide no eixo de maior extensão da malha
+    double bmin[3] = { 1e30, 1e30, 1e30 };
+    double bmax[3] = { -1e30, -1e30, -1e30 };
+
+    for(unsigned int i = 0; i < triangleList.size(); i += 3)
+    {
+        for(int axis = 0; axis < 3; axis++)
+        {
+            bmin[axis] = min(bmin[axis], triangleList[i + axis]);
+            bmax[axis] = max(bmax[axis], triangleList[i + axis]);
+        }
+    }
+
+    int axis = 0;
+
+    if((bmax[1] - bmin[1]) > (bmax[axis] - bmin[axis]))
+    {
+        axis = 1;
+    }
+
+    if((bmax[2] - bmin[2]) > (bmax[axis] - bmin[axis]))
+    {
+        axis = 2;
+    }
+
+    vector<int> triangleIndexList(triangleCount);
+
+    for(int i = 0; i < triangleCount; i++)
+    {
+        triangleIndexList[i] = i;
+    }
+
+    sort(triangleIndexList.begin(), triangleIndexList.end(), [&triangleList, axis](int a, int b)
+    {
+        const double *ta = &triangleList[9 * a];
+        const double *tb = &triangleList[9 * b];
+
+        return (ta[axis] + ta[3 + axis] + ta[6 + axis]) < (tb[axis] + tb[3 + axis] + tb[6 + axis]);
+    });
+
+    // Cada envoltória recebe todos os vértices de uma fatia de triângulos, assim
+    // as envoltórias vizinhas se sobrepõem e não deixam frestas entre elas
+    hullCount = min(hullCount, triangleCount);
+
+    for(int h = 0; h < hullCount; h++)
+    {
+        int first = (h * triangleCount) / hullCount;
+        int last = ((h + 1) * triangleCount) / hullCount;
+
+        vector<double> pointList;
+        pointList.reserve(9 * (last - first));
+
+        for(int i = first; i < last; i++)
+        {
+            const double *tri = &triangleList[9 * triangleIndexList[i]];
+            pointList.insert(pointList.end(), tri, tri + 9);
+        }
+
+        hullList.push_back(new ConvexHull(pointList, maxVertices));
+    }
+
+    return hullList;
+}
+
+vector<ConvexHull*> ConvexHull::fromIndexedTriangles(const function<void(unsigned int, double*)> &getVertex, unsigned int vertexCount,
+                                                      const unsigned int *indexList, int triangleCount, int maxVertices, int hullCount)
+{
+    vector<ConvexHull*> hullList;
+
+    if((triangleCount == 0) || (hullCount < 1))
+    {
+        return hullList;
+    }
+
+    // Eixo de maior extensão da malha
+    double bmin[3] = { 1e30, 1e30, 1e30 };
+    double bmax[3] = { -1e30, -1e30, -1e30 };
+
+    for(unsigned int i = 0; i < vertexCount; i++)
+    {
+        double v[3];
+        getVertex(i, v);
+
+        for(int axis = 0; axis < 3; axis++)
+        {
+            bmin[axis] = min(bmin[axis], v[axis]);
+            bmax[axis] = max(bmax[axis], v[axis]);
+        }
+    }
+
+    int axis = 0;
+
+    if((bmax[1] - bmin[1]) > (bmax[axis] - bmin[axis]))
+    {
+        axis = 1;
+    }
+
+    if((bmax[2] - bmin[2]) > (bmax[axis] - bmin[axis]))
+    {
+        axis = 2;
+    }
+
+    // Ordena os triângulos pelo centróide nesse eixo (a soma das coordenadas tem a mesma ordem)
+    vector<float> centroidList(triangleCount);
+    vector<int> triangleIndexList(triangleCount);
+
+    for(int i = 0; i < triangleCount; i++)
+    {
+        double sum = 0.0;
+
+        for(int k = 0; k < 3; k++)
+        {
+            double v[3];
+            getVertex(indexList[3 * i + k], v);
+            sum += v[axis];
+        }
+
+        centroidList[i] = sum;
+        triangleIndexList[i] = i;
+    }
+
+    sort(triangleIndexList.begin(), triangleIndexList.end(), [&centroidList](int a, int b)
+    {
+        return centroidList[a] < centroidList[b];
+    });
+
+    // Cada envoltória recebe os vértices (uma única vez) de uma fatia de triângulos
+    hullCount = min(hullCount, triangleCount);
+    vector<int> sliceList(vertexCount, -1);
+
+    for(int h = 0; h < hullCount; h++)
+    {
+        int first = (h * triangleCount) / hullCount;
+        int last = ((h + 1) * triangleCount) / hullCount;
+
+        vector<double> pointList;
+
+        for(int i = first; i < last; i++)
+        {
+            const unsigned int *triangle = &indexList[3 * triangleIndexList[i]];
+
+            for(int k = 0; k < 3; k++)
+            {
+                if(sliceList[triangle[k]] == h)
+                {
+                    continue;
+                }
+
+                double v[3];
+                getVertex(triangle[k], v);
+
+                sliceList[triangle[k]] = h;
+                pointList.insert(pointList.end(), v, v + 3);
+            }
+        }
+
+        hullList.push_back(new ConvexHull(pointList, maxVertices));
+    }
+
+    return hullList;
+}
+
+int ConvexHull::getVertexCount()
+{
+    return vertexList.size() / 3;
+}
+
+vector<double>* ConvexHull::getVertexList()
+{
+    return &vertexList;
+}
+
+void ConvexHull::scale(double sx, double sy, double sz)
+{
+    for(unsigned int i = 0; i < vertexList.size(); i += 3)
+    {
+        vertexList[i] *= sx;
+        vertexList[i + 1] *= sy;
+        vertexList[i + 2] *= sz;
+    }
+}
+
+void ConvexHull::translate(double dx, double dy, double dz)
+{
+    for(unsigned int i = 0; i < vertexList.size(); i += 3)
+    {
+        vertexList[i] += dx;
+        vertexList[i + 1] += dy;
+        vertexList[i + 2] += dz;
+    }
+}
+
+void ConvexHull::support(const double dir[3], double out[3])
+{
+    double best = -1e300;
+    int bestIndex = 0;
+
+    for(unsigned int i = 0; i < vertexList.size(); i += 3)
+    {
+        double proj = dot(&vertexList[i], dir);
+
+        if(proj > best)
+        {
+            best = proj;
+            bestIndex = i;
+        }
+    }
+
+    out[0] = vertexList[bestIndex];
+    out[1] = vertexList[bestIndex + 1];
+    out[2] = vertexList[bestIndex + 2];
+}
+
+void ConvexHull::getBounds(const AffineTransform &transform, double min[3], double max[3])
+{
+    for(int axis = 0; axis < 3; axis++)
+    {
+        min[axis] = 1e30;
+        max[axis] = -1e30;
+    }
+
+    for(unsigned int i = 0; i < vertexList.size(); i += 3)
+    {
+        double world[3];
+        transform.transformPoint(&vertexList[i], world);
+
+        for(int axis = 0; axis < 3; axis++)
+        {
+            min[axis] = (world[axis] < min[axis]) ? world[axis] : min[axis];
+            max[axis] = (world[axis] > max[axis]) ? world[axis] : max[axis];
+        }
+    }
+}
+
+// Reduz o simplex ao subconjunto mais próximo da origem e atualiza a direção de busca.
+// Retorna true quando o simplex (tetraedro) contém a origem
+static bool doSimplex(double simplex[4][3], int &count, double dir[3])
+{
+    // O último ponto adicionado é sempre o de índice count - 1
+    double *a = simplex[count - 1];
+    double ao[3] = { -a[0], -a[1], -a[2] };
+
+    if(count == 2)
+    {
+        double *b = simplex[0];
+        double ab[3], tmp[3];
+        sub(b, a, ab);
+
+        if(dot(ab, ao) > 0.0)
+        {
+            cross(ab, ao, tmp);
+            cross(tmp, ab, dir);
+
+            // A origem está sobre o segmento
+            if(dot(dir, dir) < 1e-24)
+            {
+                return true;
+            }
+        }
+        else
+        {
+            simplex[0][0] = a[0];
+            simplex[0][1] = a[1];
+            simplex[0][2] = a[2];
+            count = 1;
+            dir[0] = ao[0];
+            dir[1] = ao[1];
+            dir[2] = ao[2];
+        }
+
+        return false;
+    }
+
+    if(count == 3)
+    {
+        double *b = simplex[1];
+        double *c = simplex[0];
+        double ab[3], ac[3], abc[3], tmp[3];
+        sub(b, a, ab);
+        sub(c, a, ac);
+        cross(ab, ac, abc);
+
+        cross(abc, ac, tmp);
+
+        if(dot(tmp, ao) > 0.0)
+        {
+            if(dot(ac, ao) > 0.0)
+            {
+                // Região da aresta ac
+                double newSimplex[2][3] = { { c[0], c[1], c[2] }, { a[0], a[1], a[2] } };
+                for(int k = 0; k < 3; k++)
+                {
+                    simplex[0][k] = newSimplex[0][k];
+                    simplex[1][k] = newSimplex[1][k];
+                }
+                count = 2;
+                cross(ac, ao, tmp);
+                cross(tmp, ac, dir);
+                return false;
+            }
+
+            // Região da aresta ab ou do vértice a
+            double newSimplex[2][3] = { { b[0], b[1], b[2] }, { a[0], a[1], a[2] } };
+            for(int k = 0; k < 3; k++)
+            {
+                simplex[0][k] = newSimplex[0][k];
+                simplex[1][k] = newSimplex[1][k];
+            }
+            count = 2;
+            return doSimplex(simplex, count, dir);
+        }
+
+        cross(ab, abc, tmp);
+
+        if(dot(tmp, ao) > 0.0)
+        {
+            double newSimplex[2][3] = { { b[0], b[1], b[2] }, { a[0], a[1], a[2] } };
+            for(int k = 0; k < 3; k++)
+            {
+                simplex[0][k] = newSimplex[0][k];
+                simplex[1][k] = newSimplex[1][k];
+            }
+            count = 2;
+            return doSimplex(simplex, count, dir);
+        }
+
+        // A origem está acima ou abaixo do triângulo
+        double side = dot(abc, ao);
+
+        if(fabs(side) < 1e-24)
+        {
+            return true;
+        }
+
+        dir[0] = (side > 0.0) ? abc[0] : -abc[0];
+        dir[1] = (side > 0.0) ? abc[1] : -abc[1];
+        dir[2] = (side > 0.0) ? abc[2] : -abc[2];
+        return false;
+    }
+
+    // Tetraedro: verifica se a origem está fora de alguma das faces que contêm a
+    double *b = simplex[2];
+    double *c = simplex[1];
+    double *d = simplex[0];
+    double *faces[3][3] = { { b, c, d }, { c, d, b }, { d, b, c } };
+
+    for(int f = 0; f < 3; f++)
+    {
+        double *p = faces[f][0];
+        double *q = faces[f][1];
+        double *opposite = faces[f][2];
+        double ap[3], aq[3], aOpp[3], n[3];
+        sub(p, a, ap);
+        sub(q, a, aq);
+        sub(opposite, a, aOpp);
+        cross(ap, aq, n);
+
+        // Orienta a normal para fora do tetraedro
+        if(dot(n, aOpp) > 0.0)
+        {
+            n[0] = -n[0];
+            n[1] = -n[1];
+            n[2] = -n[2];
+        }
+
+        if(dot(n, ao) > 0.0)
+        {
+            double newSimplex[3][3] = { { q[0], q[1], q[2] }, { p[0], p[1], p[2] }, { a[0], a[1], a[2] } };
+            for(int k = 0; k < 3; k++)
+            {
+                simplex[0][k] = newSimplex[0][k];
+                simplex[1][k] = newSimplex[1][k];
+                simplex[2][k] = newSimplex[2][k];
+            }
+            count = 3;
+            return doSimplex(simplex, count, dir);
+        }
+    }
+
+    return true;
+}
+
+bool ConvexHull::hit(BoundingBox *box, const AffineTransform &transform)
+{
+    if(vertexList.empty())
+    {
+        return false;
+    }
+
+    double boxMin[3], boxMax[3];
+    box->getMinMax(boxMin, boxMax);
+
+    double center[3], halfSize[3];
+
+    for(int axis = 0; axis < 3; axis++)
+    {
+        center[axis] = (boxMin[axis] + boxMax[axis]) / 2.0;
+        halfSize[axis] = (boxMax[axis] - boxMin[axis]) / 2.0;
+    }
+
+    // Ponto de suporte da diferença de Minkowski (envoltória - caixa) na direção dir
+    auto minkowskiSupport = [&](const double dir[3], double out[3])
+    {
+        double localDir[3], local[3], world[3];
+        transform.transformVectorTransposed(dir, localDir);
+        support(localDir, local);
+        transform.transformPoint(local, world);
+
+        for(int axis = 0; axis < 3; axis++)
+        {
+            double boxPoint = center[axis] + ((-dir[axis] >= 0.0) ? halfSize[axis] : -halfSize[axis]);
+            out[axis] = world[axis] - boxPoint;
+        }
+    };
+
+    double simplex[4][3];
+    int count = 1;
+
+    double dir[3];
+    double first[3];
+    transform.transformPoint(&vertexList[0], first);
+    sub(first, center, dir);
+
+    if(dot(dir, dir) < 1e-24)
+    {
+        dir[0] = 1.0;
+        dir[1] = 0.0;
+        dir[2] = 0.0;
+    }
+
+    minkowskiSupport(dir, simplex[0]);
+
+    dir[0] = -simplex[0][0];
+    dir[1] = -simplex[0][1];
+    dir[2] = -simplex[0][2];
+
+    if(dot(dir, dir) < 1e-24)
+    {
+        return true;
+    }
+
+    for(int iteration = 0; iteration < 64; iteration++)
+    {
+        double point[3];
+        minkowskiSupport(dir, point);
+
+        // O novo ponto não passa da origem: os volumes estão separados
+        if(dot(point, dir) < 0.0)
+        {
+            return false;
+        }
+
+        simplex[count][0] = point[0];
+        simplex[count][1] = point[1];
+        simplex[count][2] = point[2];
+        count++;
+
+        if(doSimplex(simplex, count, dir))
+        {
+            return true;
+        }
+    }
+
+    // Sem convergência: considera o contato (caso de toque entre as superfícies)
+    return true;
+}
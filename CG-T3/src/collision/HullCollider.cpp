@@ -0,0 +1,79 @@
+#include "collision/HullCollider.h"
+
+using namespace std;
+
+HullCollider::HullCollider()
+{
+}
+
+void HullCollider::addConvexHull(ConvexHull *hull)
+{
+    hullList.push_back(hull);
+}
+
+int HullCollider::getConvexHullCount()
+{
+    return hullList.size();
+}
+
+AffineTransform* HullCollider::getTransform()
+{
+    return &transform;
+}
+
+BoundingBox* HullCollider::getCollider()
+{
+    double min[3] = { 1e30, 1e30, 1e30 };
+    double max[3] = { -1e30, -1e30, -1e30 };
+
+    for(unsigned int i = 0; i < hullList.size(); i++)
+    {
+        double hullMin[3], hullMax[3];
+        hullList[i]->getBounds(transform, hullMin, hullMax);
+
+        for(int axis = 0; axis < 3; axis++)
+        {
+            min[axis] = (hullMin[axis] < min[axis]) ? hullMin[axis] : min[axis];
+            max[axis] = (hullMax[axis] > max[axis]) ? hullMax[axis] : max[axis];
+        }
+    }
+
+    // Sem envoltórias, a bounding box fica vazia na origem
+    if(hullList.empty())
+    {
+        return getBoundingBox(Vertex3D(-1, 0.0, 0.0, 0.0), 0.0, 0.0, 0.0);
+    }
+
+    return getBoundingBox(Vertex3D(-1, (min[0] + max[0]) / 2.0, (min[1] + max[1]) / 2.0, (min[2] + max[2]) / 2.0),
+                          (max[0] - min[0]), (max[2] - min[2]), (max[1] - min[1]));
+}
+
+bool HullCollider::collide(BoundingBox *box, CollisionDetail detail)
+{
+    if(hullList.empty())
+    {
+        return false;
+    }
+
+    // Fase ampla: caixa envolvente de todas as envoltórias
+    if(!getCollider()->hit(box))
+    {
+        return false;
+    }
+
+    if(detail < HullCollision)
+    {
+        return true;
+    }
+
+    // Fase estreita: GJK entre cada envoltória e a bounding box
+    for(unsigned int i = 0; i < hullList.size(); i++)
+    {
+        if(hullList[i]->hit(box, transform))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
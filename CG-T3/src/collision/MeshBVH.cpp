@@ -0,0 +1,500 @@
+#include "collision/MeshBVH.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+// Teste de separação de eixos (SAT) entre um triângulo e uma caixa alinhada aos eixos
+// centrada na origem com meia-dimensão h (Akenine-Möller)
+static bool triangleBoxOverlap(double v[3][3], const double h[3])
+{
+    double e[3][3];
+
+    for(int i = 0; i < 3; i++)
+    {
+        e[0][i] = v[1][i] - v[0][i];
+        e[1][i] = v[2][i] - v[1][i];
+        e[2][i] = v[0][i] - v[2][i];
+    }
+
+    // Eixos formados pelo produto vetorial das arestas com os eixos da caixa
+    for(int i = 0; i < 3; i++)
+    {
+        for(int axis = 0; axis < 3; axis++)
+        {
+            double a[3] = { 0.0, 0.0, 0.0 };
+            int a1 = (axis + 1) % 3;
+            int a2 = (axis + 2) % 3;
+
+            a[a1] = -e[i][a2];
+            a[a2] = e[i][a1];
+
+            double p0 = a[0] * v[0][0] + a[1] * v[0][1] + a[2] * v[0][2];
+            double p1 = a[0] * v[1][0] + a[1] * v[1][1] + a[2] * v[1][2];
+            double p2 = a[0] * v[2][0] + a[1] * v[2][1] + a[2] * v[2][2];
+            double r = h[0] * fabs(a[0]) + h[1] * fabs(a[1]) + h[2] * fabs(a[2]);
+
+            if((min(p0, min(p1, p2)) > r) || (max(p0, max(p1, p2)) < -r))
+            {
+                return false;
+            }
+        }
+    }
+
+    // Eixos da caixa
+    for(int axis = 0; axis < 3; axis++)
+    {
+        if((min(v[0][axis], min(v[1][axis], v[2][axis])) > h[axis]) ||
+           (max(v[0][axis], max(v[1][axis], v[2][axis])) < -h[axis]))
+        {
+            return false;
+        }
+    }
+
+    // Plano do triângulo
+    double n[3];
+    n[0] = e[0][1] * e[1][2] - e[0][2] * e[1][1];
+    n[1] = e[0][2] * e[1][0] - e[0][0] * e[1][2];
+    n[2] = e[0][0] * e[1][1] - e[0][1] * e[1][0];
+
+    double d = n[0] * v[0][0] + n[1] * v[0][1] + n[2] * v[0][2];
+    double r = h[0] * fabs(n[0]) + h[1] * fabs(n[1]) + h[2] * fabs(n[2]);
+
+    return (fabs(d) <= r);
+}
+
+MeshBVH::MeshBVH(vector<Primitive*> *faceList, const AffineTransform &toLocal)
+{
+    // Divide cada face em triângulos (leque a partir do primeiro vértice)
+    for(unsigned int i = 0; i < faceList->size(); i++)
+    {
+        vector<Vertex3D*> *faceVertexList = faceList->at(i)->getVertexList();
+
+        for(unsigned int j = 2; j < faceVertexList->size(); j++)
+        {
+            Vertex3D *v[3] = { faceVertexList->at(0), faceVertexList->at(j - 1), faceVertexList->at(j) };
+
+            float cx = 0.0f, cy = 0.0f, cz = 0.0f;
+
+            for(int k = 0; k < 3; k++)
+            {
+                double current[3] = { v[k]->getX(), v[k]->getY(), v[k]->getZ() };
+                double local[3];
+                toLocal.transformPoint(current, local);
+
+                triangleVertexList.push_back(local[0]);
+                triangleVertexList.push_back(local[1]);
+                triangleVertexList.push_back(local[2]);
+
+                cx += local[0];
+                cy += local[1];
+                cz += local[2];
+            }
+
+            triangleFaceList.push_back(i);
+
+            centroidList.push_back(cx / 3.0f);
+            centroidList.push_back(cy / 3.0f);
+            centroidList.push_back(cz / 3.0f);
+        }
+    }
+
+    int triangleCount = centroidList.size() / 3;
+
+    for(int i = 0; i < triangleCount; i++)
+    {
+        triangleIndexList.push_back(i);
+    }
+
+    // Uma árvore binária com folhas de pelo menos um triângulo tem no máximo 2n - 1 nós
+    nodeList.reserve(max(1, 2 * triangleCount - 1));
+
+    MeshBVHNode root;
+    root.leftFirst = 0;
+    root.triangleCount = triangleCount;
+    nodeList.push_back(root);
+
+    updateNodeBounds(0);
+    subdivide(0);
+
+    centroidList.clear();
+    centroidList.shrink_to_fit();
+}
+
+void MeshBVH::updateNodeBounds(int nodeIndex)
+{
+    MeshBVHNode &node = nodeList[nodeIndex];
+
+    for(int axis = 0; axis < 3; axis++)
+    {
+        node.bmin[axis] = 1e30f;
+        node.bmax[axis] = -1e30f;
+    }
+
+    for(int i = 0; i < node.triangleCount; i++)
+    {
+        const float *tri = &triangleVertexList[9 * triangleIndexList[node.leftFirst + i]];
+
+        for(int k = 0; k < 3; k++)
+        {
+            for(int axis = 0; axis < 3; axis++)
+            {
+                node.bmin[axis] = min(node.bmin[axis], tri[3 * k + axis]);
+                node.bmax[axis] = max(node.bmax[axis], tri[3 * k + axis]);
+            }
+        }
+    }
+}
+
+void MeshBVH::subdivide(int nodeIndex)
+{
+    if(nodeList[nodeIndex].triangleCount <= MESH_BVH_LEAF_SIZE)
+    {
+        return;
+    }
+
+    int first = nodeList[nodeIndex].leftFirst;
+    int count = nodeList[nodeIndex].triangleCount;
+
+    // Divide no eixo de maior extensão dos centróides
+    float cmin[3] = { 1e30f, 1e30f, 1e30f };
+    float cmax[3] = { -1e30f, -1e30f, -1e30f };
+
+    for(int i = first; i < first + count; i++)
+    {
+        for(int axis = 0; axis < 3; axis++)
+        {
+            cmin[axis] = min(cmin[axis], centroidList[3 * triangleIndexList[i] + axis]);
+            cmax[axis] = max(cmax[axis], centroidList[3 * triangleIndexList[i] + axis]);
+        }
+    }
+
+    int axis = 0;
+
+    if((cmax[1] - cmin[1]) > (cmax[axis] - cmin[axis]))
+    {
+        axis = 1;
+    }
+
+    if((cmax[2] - cmin[2]) > (cmax[axis] - cmin[axis]))
+    {
+        axis = 2;
+    }
+
+    // Todos os centróides coincidem, não há como dividir
+    if((cmax[axis] - cmin[axis]) <= 0.0f)
+    {
+        return;
+    }
+
+    // Divide pela mediana dos centróides
+    int middle = first + (count / 2);
+    const vector<float> &centroids = centroidList;
+
+    nth_element(triangleIndexList.begin() + first, triangleIndexList.begin() + middle, triangleIndexList.begin() + first + count,
+                [&centroids, axis](int a, int b) { return centroids[3 * a + axis] < centroids[3 * b + axis]; });
+
+    int leftIndex = nodeList.size();
+
+    MeshBVHNode left, right;
+    left.leftFirst = first;
+    left.triangleCount = middle - first;
+    right.leftFirst = middle;
+    right.triangleCount = first + count - middle;
+
+    nodeList.push_back(left);
+    nodeList.push_back(right);
+
+    nodeList[nodeIndex].leftFirst = leftIndex;
+    nodeList[nodeIndex].triangleCount = 0;
+
+    updateNodeBounds(leftIndex);
+    updateNodeBounds(leftIndex + 1);
+
+    subdivide(leftIndex);
+    subdivide(leftIndex + 1);
+}
+
+void MeshBVH::getTriangle(int triangleIndex, const AffineTransform &transform, double v[3][3])
+{
+    const float *tri = &triangleVertexList[9 * triangleIndex];
+
+    for(int k = 0; k < 3; k++)
+    {
+        double local[3] = { tri[3 * k], tri[3 * k + 1], tri[3 * k + 2] };
+        transform.transformPoint(local, v[k]);
+    }
+}
+
+int MeshBVH::getTriangleCount()
+{
+    return triangleIndexList.size();
+}
+
+int MeshBVH::getNodeCount()
+{
+    return nodeList.size();
+}
+
+void MeshBVH::getBounds(const AffineTransform &transform, double min[3], double max[3])
+{
+    const MeshBVHNode &root = nodeList[0];
+
+    for(int axis = 0; axis < 3; axis++)
+    {
+        min[axis] = 1e30;
+        max[axis] = -1e30;
+    }
+
+    // Transforma os 8 cantos da caixa da raiz
+    for(int corner = 0; corner < 8; corner++)
+    {
+        double local[3], world[3];
+        local[0] = (corner & 1) ? root.bmax[0] : root.bmin[0];
+        local[1] = (corner & 2) ? root.bmax[1] : root.bmin[1];
+        local[2] = (corner & 4) ? root.bmax[2] : root.bmin[2];
+
+        transform.transformPoint(local, world);
+
+        for(int axis = 0; axis < 3; axis++)
+        {
+            min[axis] = (world[axis] < min[axis]) ? world[axis] : min[axis];
+            max[axis] = (world[axis] > max[axis]) ? world[axis] : max[axis];
+        }
+    }
+}
+
+bool MeshBVH::hit(BoundingBox *box, const AffineTransform &transform)
+{
+    if(triangleIndexList.empty())
+    {
+        return false;
+    }
+
+    double boxMin[3], boxMax[3];
+    box->getMinMax(boxMin, boxMax);
+
+    double center[3], halfSize[3];
+
+    for(int axis = 0; axis < 3; axis++)
+    {
+        center[axis] = (boxMin[axis] + boxMax[axis]) / 2.0;
+        halfSize[axis] = (boxMax[axis] - boxMin[axis]) / 2.0;
+    }
+
+    AffineTransform inverse;
+
+    // Transformação degenerada, não há como consultar no espaço local
+    if(!transform.inverse(inverse))
+    {
+        return false;
+    }
+
+    // Caixa envolvente da bounding box levada para o espaço local da malha
+    double localMin[3] = { 1e30, 1e30, 1e30 };
+    double localMax[3] = { -1e30, -1e30, -1e30 };
+
+    for(int corner = 0; corner < 8; corner++)
+    {
+        double world[3], local[3];
+        world[0] = (corner & 1) ? boxMax[0] : boxMin[0];
+        world[1] = (corner & 2) ? boxMax[1] : boxMin[1];
+        world[2] = (corner & 4) ? boxMax[2] : boxMin[2];
+
+        inverse.transformPoint(world, local);
+
+        for(int axis = 0; axis < 3; axis++)
+        {
+            localMin[axis] = min(localMin[axis], local[axis]);
+            localMax[axis] = max(localMax[axis], local[axis]);
+        }
+    }
+
+    // Percorre a árvore com uma pilha explícita
+    int stack[64];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while(stackSize > 0)
+    {
+        const MeshBVHNode &node = nodeList[stack[--stackSize]];
+
+        if((node.bmin[0] > localMax[0]) || (node.bmax[0] < localMin[0]) ||
+           (node.bmin[1] > localMax[1]) || (node.bmax[1] < localMin[1]) ||
+           (node.bmin[2] > localMax[2]) || (node.bmax[2] < localMin[2]))
+        {
+            continue;
+        }
+
+        if(node.triangleCount > 0)
+        {
+            // Folha: testa os triângulos no espaço do mundo contra a caixa exata
+            for(int i = 0; i < node.triangleCount; i++)
+            {
+                double v[3][3];
+                getTriangle(triangleIndexList[node.leftFirst + i], transform, v);
+
+                for(int k = 0; k < 3; k++)
+                {
+                    v[k][0] -= center[0];
+                    v[k][1] -= center[1];
+                    v[k][2] -= center[2];
+                }
+
+                if(triangleBoxOverlap(v, halfSize))
+                {
+                    return true;
+                }
+            }
+        }
+        else if(stackSize < 63)
+        {
+            stack[stackSize++] = node.leftFirst;
+            stack[stackSize++] = node.leftFirst + 1;
+        }
+    }
+
+    return false;
+}
+
+bool MeshBVH::intersectRayTriangle(const double origin[3], const double direction[3], double v[3][3], double &distance)
+{
+    double e1[3], e2[3], p[3], q[3], s[3];
+
+    for(int axis = 0; axis < 3; axis++)
+    {
+        e1[axis] = v[1][axis] - v[0][axis];
+        e2[axis] = v[2][axis] - v[0][axis];
+        s[axis] = origin[axis] - v[0][axis];
+    }
+
+    p[0] = direction[1] * e2[2] - direction[2] * e2[1];
+    p[1] = direction[2] * e2[0] - direction[0] * e2[2];
+    p[2] = direction[0] * e2[1] - direction[1] * e2[0];
+
+    double det = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+
+    // Raio paralelo ao plano do triângulo
+    if(fabs(det) < 1e-12)
+    {
+        return false;
+    }
+
+    double invDet = 1.0 / det;
+    double u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) * invDet;
+
+    if((u < 0.0) || (u > 1.0))
+    {
+        return false;
+    }
+
+    q[0] = s[1] * e1[2] - s[2] * e1[1];
+    q[1] = s[2] * e1[0] - s[0] * e1[2];
+    q[2] = s[0] * e1[1] - s[1] * e1[0];
+
+    double w = (direction[0] * q[0] + direction[1] * q[1] + direction[2] * q[2]) * invDet;
+
+    if((w < 0.0) || ((u + w) > 1.0))
+    {
+        return false;
+    }
+
+    double t = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) * invDet;
+
+    if((t < 0.0) || (t >= distance))
+    {
+        return false;
+    }
+
+    distance = t;
+    return true;
+}
+
+bool MeshBVH::raycast(const double origin[3], const double direction[3], const AffineTransform &transform, double &distance, int &faceIndex)
+{
+    if(triangleIndexList.empty())
+    {
+        return false;
+    }
+
+    AffineTransform inverse;
+
+    if(!transform.inverse(inverse))
+    {
+        return false;
+    }
+
+    // Raio no espaço local da malha (a distância ao longo do raio é a mesma nos dois espaços)
+    double localOrigin[3], localDirection[3], invDirection[3];
+    inverse.transformPoint(origin, localOrigin);
+    inverse.transformVector(direction, localDirection);
+
+    for(int axis = 0; axis < 3; axis++)
+    {
+        invDirection[axis] = 1.0 / localDirection[axis];
+    }
+
+    bool hasHit = false;
+
+    int stack[64];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while(stackSize > 0)
+    {
+        const MeshBVHNode &node = nodeList[stack[--stackSize]];
+
+        // Teste das placas (slabs) com a caixa do nó
+        double tmin = 0.0, tmax = distance;
+
+        for(int axis = 0; axis < 3; axis++)
+        {
+            double t0 = (node.bmin[axis] - localOrigin[axis]) * invDirection[axis];
+            double t1 = (node.bmax[axis] - localOrigin[axis]) * invDirection[axis];
+
+            if(t0 > t1)
+            {
+                swap(t0, t1);
+            }
+
+            tmin = max(tmin, t0);
+            tmax = min(tmax, t1);
+        }
+
+        if(tmin > tmax)
+        {
+            continue;
+        }
+
+        if(node.triangleCount > 0)
+        {
+            for(int i = 0; i < node.triangleCount; i++)
+            {
+                int triangleIndex = triangleIndexList[node.leftFirst + i];
+                const float *tri = &triangleVertexList[9 * triangleIndex];
+                double v[3][3];
+
+                for(int k = 0; k < 3; k++)
+                {
+                    v[k][0] = tri[3 * k];
+                    v[k][1] = tri[3 * k + 1];
+                    v[k][2] = tri[3 * k + 2];
+                }
+
+                if(intersectRayTriangle(localOrigin, localDirection, v, distance))
+                {
+                    faceIndex = triangleFaceList[triangleIndex];
+                    hasHit = true;
+                }
+            }
+        }
+        else if(stackSize < 63)
+        {
+            stack[stackSize++] = node.leftFirst;
+            stack[stackSize++] = node.leftFirst + 1;
+        }
+    }
+
+    return hasHit;
+}
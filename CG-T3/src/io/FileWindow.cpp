@@ -0,0 +1,128 @@
+#include "io/FileWindow.h"
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+FileWindow::FileWindow(string filePath, size_t windowSize)
+{
+    this->fileDescriptor = open(filePath.c_str(), O_RDONLY);
+
+    if(this->fileDescriptor < 0)
+    {
+        throw runtime_error("Não foi possível abrir o arquivo " + filePath);
+    }
+
+    this->buffer.resize(windowSize > 0 ? windowSize : 1);
+    this->begin = 0;
+    this->end = 0;
+    this->endOfFile = false;
+}
+
+FileWindow::~FileWindow()
+{
+    close(this->fileDescriptor);
+}
+
+void FileWindow::fill()
+{
+    if(begin > 0)
+    {
+        memmove(buffer.data(), buffer.data() + begin, end - begin);
+        end -= begin;
+        begin = 0;
+    }
+
+    while(!endOfFile && (end < buffer.size()))
+    {
+        ssize_t readSize = read(fileDescriptor, buffer.data() + end, buffer.size() - end);
+
+        if(readSize < 0)
+        {
+            throw runtime_error("Erro na leitura do arquivo");
+        }
+
+        if(readSize == 0)
+        {
+            endOfFile = true;
+        }
+
+        end += readSize;
+    }
+}
+
+void FileWindow::seek(size_t offset)
+{
+    if(lseek(fileDescriptor, offset, SEEK_SET) < 0)
+    {
+        throw runtime_error("Erro na leitura do arquivo");
+    }
+
+    begin = 0;
+    end = 0;
+    endOfFile = false;
+}
+
+bool FileWindow::require(size_t size)
+{
+    if(end - begin >= size)
+    {
+        return true;
+    }
+
+    if(size > buffer.size())
+    {
+        throw runtime_error("Registro maior que a janela de leitura");
+    }
+
+    fill();
+
+    return (end - begin >= size);
+}
+
+const char* FileWindow::getData()
+{
+    return buffer.data() + begin;
+}
+
+size_t FileWindow::getAvailable()
+{
+    return end - begin;
+}
+
+void FileWindow::consume(size_t size)
+{
+    begin += min(size, end - begin);
+}
+
+bool FileWindow::nextLine(const char *&line, const char *&lineEnd)
+{
+    const char *lineBreak = (const char*)memchr(buffer.data() + begin, '\n', end - begin);
+
+    if(!lineBreak)
+    {
+        fill();
+        lineBreak = (const char*)memchr(buffer.data() + begin, '\n', end - begin);
+
+        // Sem quebra de linha em uma janela cheia, a linha não cabe na janela
+        if(!lineBreak && !endOfFile)
+        {
+            throw runtime_error("Linha maior que a janela de leitura");
+        }
+    }
+
+    // A última linha pode terminar sem quebra de linha
+    if(!lineBreak && (begin == end))
+    {
+        return false;
+    }
+
+    line = buffer.data() + begin;
+    lineEnd = lineBreak ? lineBreak : buffer.data() + end;
+    begin = lineBreak ? (lineBreak - buffer.data()) + 1 : end;
+
+    return true;
+}
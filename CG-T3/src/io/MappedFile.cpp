@@ -0,0 +1,69 @@
+#include "io/MappedFile.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+MappedFile::MappedFile(string filePath)
+{
+    this->data = NULL;
+    this->size = 0;
+
+    int fileDescriptor = open(filePath.c_str(), O_RDONLY);
+
+    if(fileDescriptor < 0)
+    {
+        throw runtime_error("Não foi possível abrir o arquivo " + filePath);
+    }
+
+    struct stat fileStatus;
+
+    if(fstat(fileDescriptor, &fileStatus) < 0)
+    {
+        close(fileDescriptor);
+        throw runtime_error("Não foi possível obter o tamanho do arquivo " + filePath);
+    }
+
+    this->size = fileStatus.st_size;
+
+    // Arquivos vazios não podem ser mapeados
+    if(this->size > 0)
+    {
+        void *mapping = mmap(NULL, this->size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+
+        if(mapping == MAP_FAILED)
+        {
+            close(fileDescriptor);
+            throw runtime_error("Não foi possível mapear o arquivo " + filePath);
+        }
+
+        // O arquivo é lido do início ao fim, o que permite ao sistema antecipar a leitura das páginas
+        madvise(mapping, this->size, MADV_SEQUENTIAL);
+
+        this->data = (const char*)mapping;
+    }
+
+    // O mapeamento continua válido após o descritor ser fechado
+    close(fileDescriptor);
+}
+
+MappedFile::~MappedFile()
+{
+    if(this->data)
+    {
+        munmap((void*)this->data, this->size);
+    }
+}
+
+const char* MappedFile::getData()
+{
+    return this->data;
+}
+
+size_t MappedFile::getSize()
+{
+    return this->size;
+}
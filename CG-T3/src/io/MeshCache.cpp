@@ -0,0 +1,397 @@
+#include "io/MeshCache.h"
+
+#include <cstdio>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <atomic>
+
+#include <unistd.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+// Diretório onde os arquivos de cache são gravados
+#define MESH_CACHE_DIRECTORY "data/cache"
+// Versão do formato do arquivo (deve ser incrementada a cada mudança no formato ou no conteúdo dos blocos)
+#define MESH_CACHE_VERSION 7
+// Marca usada para rejeitar caches gravados em máquinas com outra ordem de bytes
+#define MESH_CACHE_BYTE_ORDER_MARK 0x01020304
+
+// Cabeçalho do arquivo, seguido das opções de processamento, dos arquivos de origem,
+// da tabela de blocos e dos dados dos blocos (todos alinhados em 8 bytes)
+struct MeshCacheFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrderMark;
+    uint32_t sourceCount;
+    uint32_t blockCount;
+    uint32_t settingsLength;
+    uint32_t reserved;
+};
+
+// Registro de um arquivo de origem, seguido do caminho do arquivo
+struct MeshCacheFileSource
+{
+    uint64_t size;
+    int64_t modificationTime;
+    uint64_t contentHash;
+    uint64_t pathLength;
+};
+
+// Registro da tabela de blocos
+struct MeshCacheFileBlock
+{
+    uint32_t blockId;
+    uint32_t reserved;
+    uint64_t offset;
+    uint64_t size;
+};
+
+static const char meshCacheMagic[8] = { 'M', 'E', 'S', 'H', 'C', 'A', 'C', 'H' };
+
+// Contador que distingue os arquivos temporários gravados ao mesmo tempo por threads do mesmo processo
+static atomic<unsigned int> tempFileCounter(0);
+
+// Arredonda um tamanho para o próximo múltiplo de 8
+static size_t alignSize(size_t size)
+{
+    return (size + 7) & ~(size_t)7;
+}
+
+MeshCache::MeshCache(string sourcePath, string settings)
+{
+    this->sourcePath = sourcePath;
+    this->settings = settings;
+}
+
+string MeshCache::getCachePath()
+{
+    // O nome do arquivo combina o nome do modelo com o hash do caminho e das opções de processamento
+    string key = sourcePath + '\n' + settings;
+    uint64_t keyHash = hashData(key.data(), key.size());
+
+    string fileName = sourcePath.substr(sourcePath.find_last_of('/') + 1);
+
+    char hashText[17];
+    snprintf(hashText, sizeof(hashText), "%016llx", (unsigned long long)keyHash);
+
+    return string(MESH_CACHE_DIRECTORY) + "/" + fileName + "-" + hashText + ".mcache";
+}
+
+bool MeshCache::getSourceInfo(string path, bool computeHash, MeshCacheSource &source)
+{
+    struct stat fileStatus;
+
+    if(stat(path.c_str(), &fileStatus) < 0)
+    {
+        return false;
+    }
+
+    source.path = path;
+    source.size = fileStatus.st_size;
+    source.modificationTime = (int64_t)fileStatus.st_mtim.tv_sec * 1000000000 + fileStatus.st_mtim.tv_nsec;
+    source.contentHash = 0;
+
+    if(computeHash)
+    {
+        try
+        {
+            MappedFile mappedFile(path);
+            source.contentHash = hashData(mappedFile.getData(), mappedFile.getSize());
+        }
+        catch(exception&)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+uint64_t MeshCache::hashData(const char *data, size_t size)
+{
+    // FNV-1a aplicado a palavras de 8 bytes, com uma mistura dos bits altos a cada passo
+    uint64_t hash = 14695981039346656037ULL;
+    size_t i = 0;
+
+    for(; i + 8 <= size; i += 8)
+    {
+        uint64_t word;
+        memcpy(&word, data + i, 8);
+
+        hash = (hash ^ word) * 1099511628211ULL;
+        hash ^= (hash >> 32);
+    }
+
+    for(; i < size; i++)
+    {
+        hash = (hash ^ (unsigned char)data[i]) * 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+bool MeshCache::load()
+{
+    mappedFile.reset();
+    loadedIdList.clear();
+    loadedDataList.clear();
+    loadedSizeList.clear();
+
+    string cachePath = getCachePath();
+
+    // Verifica a existência do cache antes de mapeá-lo, evitando a exceção no caso comum de cache ausente
+    if(access(cachePath.c_str(), R_OK) != 0)
+    {
+        return false;
+    }
+
+    unique_ptr<MappedFile> cacheFile;
+
+    try
+    {
+        cacheFile.reset(new MappedFile(cachePath));
+    }
+    catch(exception&)
+    {
+        return false;
+    }
+
+    const char *data = cacheFile->getData();
+    size_t dataSize = cacheFile->getSize();
+
+    if(dataSize < sizeof(MeshCacheFileHeader))
+    {
+        return false;
+    }
+
+    const MeshCacheFileHeader *header = (const MeshCacheFileHeader*)data;
+
+    if((memcmp(header->magic, meshCacheMagic, sizeof(meshCacheMagic)) != 0) ||
+       (header->version != MESH_CACHE_VERSION) ||
+       (header->byteOrderMark != MESH_CACHE_BYTE_ORDER_MARK))
+    {
+        return false;
+    }
+
+    size_t offset = sizeof(MeshCacheFileHeader);
+
+    // Opções de processamento
+    if((offset + alignSize(header->settingsLength) > dataSize) ||
+       (settings.compare(0, string::npos, data + offset, header->settingsLength) != 0))
+    {
+        return false;
+    }
+
+    offset += alignSize(header->settingsLength);
+
+    // Arquivos de origem: o cache é válido se o tamanho for o mesmo e a data de modificação
+    // também for ou, caso contrário, se o conteúdo não tiver mudado (ex.: arquivo copiado)
+    vector<size_t> refreshOffsetList;
+    vector<int64_t> refreshTimeList;
+
+    for(unsigned int i = 0; i < header->sourceCount; i++)
+    {
+        if(offset + sizeof(MeshCacheFileSource) > dataSize)
+        {
+            return false;
+        }
+
+        const MeshCacheFileSource *fileSource = (const MeshCacheFileSource*)(data + offset);
+        size_t pathOffset = offset + sizeof(MeshCacheFileSource);
+
+        if((fileSource->pathLength > dataSize) || (pathOffset + alignSize(fileSource->pathLength) > dataSize))
+        {
+            return false;
+        }
+
+        string path(data + pathOffset, fileSource->pathLength);
+        MeshCacheSource source;
+
+        if(!getSourceInfo(path, false, source) || (source.size != fileSource->size))
+        {
+            return false;
+        }
+
+        if(source.modificationTime != fileSource->modificationTime)
+        {
+            if(!getSourceInfo(path, true, source) || (source.contentHash != fileSource->contentHash))
+            {
+                return false;
+            }
+
+            refreshOffsetList.push_back(offset + offsetof(MeshCacheFileSource, modificationTime));
+            refreshTimeList.push_back(source.modificationTime);
+        }
+
+        offset = pathOffset + alignSize(fileSource->pathLength);
+    }
+
+    // Tabela de blocos
+    if(offset + (size_t)header->blockCount * sizeof(MeshCacheFileBlock) > dataSize)
+    {
+        return false;
+    }
+
+    const MeshCacheFileBlock *blockTable = (const MeshCacheFileBlock*)(data + offset);
+
+    for(unsigned int i = 0; i < header->blockCount; i++)
+    {
+        const MeshCacheFileBlock &block = blockTable[i];
+
+        if((block.offset > dataSize) || (block.size > dataSize - block.offset) || ((block.offset & 7) != 0))
+        {
+            return false;
+        }
+
+        loadedIdList.push_back((MeshCacheBlock)block.blockId);
+        loadedDataList.push_back(data + block.offset);
+        loadedSizeList.push_back(block.size);
+    }
+
+    // Atualiza as datas dos arquivos de origem cujo conteúdo não mudou, evitando calcular o hash na próxima leitura
+    if(!refreshOffsetList.empty())
+    {
+        FILE *file = fopen(cachePath.c_str(), "r+b");
+
+        if(file)
+        {
+            for(unsigned int i = 0; i < refreshOffsetList.size(); i++)
+            {
+                fseek(file, refreshOffsetList[i], SEEK_SET);
+                fwrite(&refreshTimeList[i], sizeof(int64_t), 1, file);
+            }
+
+            fclose(file);
+        }
+    }
+
+    mappedFile = move(cacheFile);
+
+    return true;
+}
+
+const void* MeshCache::getBlock(MeshCacheBlock block, size_t &size)
+{
+    for(unsigned int i = 0; i < loadedIdList.size(); i++)
+    {
+        if(loadedIdList[i] == block)
+        {
+            size = loadedSizeList[i];
+            return loadedDataList[i];
+        }
+    }
+
+    size = 0;
+    return NULL;
+}
+
+void MeshCache::addDependency(string path)
+{
+    dependencyList.push_back(path);
+}
+
+void MeshCache::addBlock(MeshCacheBlock block, const void *data, size_t size)
+{
+    blockIdList.push_back(block);
+    blockDataList.push_back(data);
+    blockSizeList.push_back(size);
+}
+
+bool MeshCache::save()
+{
+    // Identifica as versões atuais do modelo e das dependências
+    vector<MeshCacheSource> sourceList(1 + dependencyList.size());
+
+    if(!getSourceInfo(sourcePath, true, sourceList[0]))
+    {
+        return false;
+    }
+
+    for(unsigned int i = 0; i < dependencyList.size(); i++)
+    {
+        if(!getSourceInfo(dependencyList[i], true, sourceList[i + 1]))
+        {
+            return false;
+        }
+    }
+
+    // Monta o cabeçalho, os arquivos de origem e a tabela de blocos
+    string headerData;
+
+    MeshCacheFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, meshCacheMagic, sizeof(meshCacheMagic));
+    header.version = MESH_CACHE_VERSION;
+    header.byteOrderMark = MESH_CACHE_BYTE_ORDER_MARK;
+    header.sourceCount = sourceList.size();
+    header.blockCount = blockIdList.size();
+    header.settingsLength = settings.size();
+
+    headerData.append((const char*)&header, sizeof(header));
+    headerData.append(settings);
+    headerData.resize(alignSize(headerData.size()), '\0');
+
+    for(unsigned int i = 0; i < sourceList.size(); i++)
+    {
+        MeshCacheFileSource fileSource;
+        fileSource.size = sourceList[i].size;
+        fileSource.modificationTime = sourceList[i].modificationTime;
+        fileSource.contentHash = sourceList[i].contentHash;
+        fileSource.pathLength = sourceList[i].path.size();
+
+        headerData.append((const char*)&fileSource, sizeof(fileSource));
+        headerData.append(sourceList[i].path);
+        headerData.resize(alignSize(headerData.size()), '\0');
+    }
+
+    size_t dataOffset = headerData.size() + blockIdList.size() * sizeof(MeshCacheFileBlock);
+
+    for(unsigned int i = 0; i < blockIdList.size(); i++)
+    {
+        MeshCacheFileBlock fileBlock;
+        fileBlock.blockId = blockIdList[i];
+        fileBlock.reserved = 0;
+        fileBlock.offset = dataOffset;
+        fileBlock.size = blockSizeList[i];
+
+        headerData.append((const char*)&fileBlock, sizeof(fileBlock));
+        dataOffset += alignSize(blockSizeList[i]);
+    }
+
+    // Grava em um arquivo temporário que substitui o cache anterior de uma só vez,
+    // para que outra execução nunca mapeie um cache incompleto
+    mkdir(MESH_CACHE_DIRECTORY, 0755);
+
+    string cachePath = getCachePath();
+    string tempPath = cachePath + "." + to_string(getpid()) + "-" + to_string(tempFileCounter++) + ".tmp";
+
+    ofstream cacheStream(tempPath.c_str(), ios::out | ios::binary | ios::trunc);
+
+    if(!cacheStream.is_open())
+    {
+        return false;
+    }
+
+    static const char padding[8] = { 0 };
+
+    cacheStream.write(headerData.data(), headerData.size());
+
+    for(unsigned int i = 0; i < blockIdList.size(); i++)
+    {
+        cacheStream.write((const char*)blockDataList[i], blockSizeList[i]);
+        cacheStream.write(padding, alignSize(blockSizeList[i]) - blockSizeList[i]);
+    }
+
+    cacheStream.close();
+
+    if(cacheStream.fail() || (rename(tempPath.c_str(), cachePath.c_str()) != 0))
+    {
+        remove(tempPath.c_str());
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,125 @@
+#include "io/NumberParser.h"
+
+#include <cstdlib>
+#include <string>
+
+using namespace std;
+
+// Indica se o caractere termina um número
+static inline bool isSeparator(char c)
+{
+    return (c == ' ') || (c == '\t') || (c == '\n') || (c == '\r');
+}
+
+const char* NumberParser::parseDouble(const char *data, const char *end, double &value)
+{
+    // Potências de 10 representadas exatamente em double
+    static const double powerOf10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+    const char *tokenStart = data;
+    bool negative = false;
+
+    if((data < end) && ((*data == '-') || (*data == '+')))
+    {
+        negative = (*data == '-');
+        data++;
+    }
+
+    // Acumula até 19 dígitos significativos na mantissa; os demais só ajustam o expoente
+    unsigned long long mantissa = 0;
+    int digitCount = 0, exponent = 0;
+    bool hasDigits = false;
+
+    while((data < end) && (*data >= '0') && (*data <= '9'))
+    {
+        if(digitCount < 19)
+        {
+            mantissa = 10 * mantissa + (*data - '0');
+            digitCount += (mantissa > 0);
+        }
+        else
+        {
+            exponent++;
+        }
+
+        hasDigits = true;
+        data++;
+    }
+
+    if((data < end) && (*data == '.'))
+    {
+        data++;
+
+        while((data < end) && (*data >= '0') && (*data <= '9'))
+        {
+            if(digitCount < 19)
+            {
+                mantissa = 10 * mantissa + (*data - '0');
+                digitCount += (mantissa > 0);
+                exponent--;
+            }
+
+            hasDigits = true;
+            data++;
+        }
+    }
+
+    if(hasDigits && (data < end) && ((*data == 'e') || (*data == 'E')))
+    {
+        data++;
+
+        bool negativeExponent = false;
+
+        if((data < end) && ((*data == '-') || (*data == '+')))
+        {
+            negativeExponent = (*data == '-');
+            data++;
+        }
+
+        int exponentValue = 0;
+
+        while((data < end) && (*data >= '0') && (*data <= '9'))
+        {
+            exponentValue = (exponentValue < 10000) ? (10 * exponentValue + (*data - '0')) : exponentValue;
+            data++;
+        }
+
+        exponent += negativeExponent ? -exponentValue : exponentValue;
+    }
+
+    // Valores fora do formato comum (inf, nan, hexadecimal, ...) e os que não podem ser montados com um
+    // único arredondamento (mantissa acima de 53 bits ou expoente fora da tabela) são convertidos pela
+    // biblioteca padrão
+    if(!hasDigits || ((data < end) && !isSeparator(*data)) ||
+       (mantissa > (1ULL << 53)) || (exponent < -22) || (exponent > 22))
+    {
+        const char *tokenEnd = tokenStart;
+
+        while((tokenEnd < end) && !isSeparator(*tokenEnd))
+        {
+            tokenEnd++;
+        }
+
+        string token(tokenStart, tokenEnd);
+        char *parseEnd;
+
+        value = strtod(token.c_str(), &parseEnd);
+
+        if(token.empty() || (*parseEnd != '\0'))
+        {
+            return NULL;
+        }
+
+        return tokenEnd;
+    }
+
+    // A mantissa e a potência de 10 são exatas, então o resultado tem um único arredondamento
+    double result = (double)mantissa;
+
+    result = (exponent < 0) ? (result / powerOf10[-exponent]) : (result * powerOf10[exponent]);
+
+    value = negative ? -result : result;
+
+    return data;
+}
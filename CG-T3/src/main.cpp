@@ -1,10 +1,16 @@
 #include <iostream>
 #include <vector>
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <atomic>
 
 #include <GL/glut.h>
 
 #include "primitive/Point.h"
 
+#include "collision/HullCollider.h"
+
 #include "drawable/Axis.h"
 #include "drawable/Grid.h"
 
@@ -16,6 +22,7 @@
 #include "player/Player.h"
 
 #include "ply/PLYReader.h"
+#include "ply/PLYLoader.h"
 #include "obj/glcWavefrontObject.h"
 
 #include "scene/Scene.h"
@@ -32,12 +39,13 @@ char objFiles[4][50] =
     "data/obj/statue04/12340_statue_v2_l1.obj"
 };
 
-char objTextureFiles[4][50] =
+// Posição (x, y, z) e rotação no eixo Y (em graus) de cada estátua
+double statuePlacement[4][4] =
 {
-    "data/obj/statue01/DavidFixedDiff.png",
-    "data/obj/statue02/statue.png",
-    "data/obj/statue03/12341_Statue_diff.png",
-    "data/obj/statue04/12340_Statue_diff.png"
+    { -0.75, 0.3, -0.02, -90.0 },
+    { 1.0, 0.4, 0.0, -90.0 },
+    { 0.8, 0.3, 0.8, -135.0 },
+    { 0.8, 0.35, -0.8, -45.0 }
 };
 
 enum EditMode { ModeTranslation = 0, ModeRotation = 1, ModeScale = 2, ModePLY = 3 };
@@ -66,6 +74,28 @@ string editModeEnumToString(EditMode mode)
     return "None";
 }
 
+inline CollisionDetail& operator++(CollisionDetail& detail, int)
+{
+    const int i = static_cast<int>(detail) + 1;
+    detail = static_cast<CollisionDetail>(i % 3);
+    return detail;
+}
+
+string collisionDetailEnumToString(CollisionDetail detail)
+{
+    switch(detail)
+    {
+        case BoxCollision:
+            return "Bounding box";
+        case HullCollision:
+            return "Envoltórias convexas";
+        case MeshCollision:
+            return "Malha exata";
+    }
+
+    return "None";
+}
+
 int initWindowWidth = 1200, initWindowHeight = 600;
 int currWindowWidth = initWindowWidth, currWindowHeight = initWindowHeight;
 int currMiddleWindowWidth = (currWindowWidth / 2), currMiddleWindowHeight = (currWindowHeight / 2);
@@ -77,11 +107,21 @@ bool enableEditMode = false;
 EditMode editMode = ModeTranslation;
 double modeFactor = 1.0;
 bool enableCollision = false;
+CollisionDetail collisionDetail = MeshCollision;
+
+// Multiplicador da velocidade ao correr (Shift pressionado)
+double runSpeedFactor = 3.0;
+bool enableRun = false;
 
-bool lockForward = false;
-bool lockBackward = false;
-bool lockLeft = false;
-bool lockRight = false;
+// Passo fixo da simulação (120 Hz), em milissegundos
+const double simulationStep = 1000.0 / 120.0;
+// Tempo ainda não simulado e instante da última atualização da simulação (ms)
+double simulationAccumulator = 0.0;
+int lastSimulationTime = 0;
+
+// Quadros desenhados desde a última atualização do título da janela
+int renderedFrames = 0;
+int lastTitleTime = 0;
 
 // Posição atual no eixo-Z da câmera
 double cam_height = 3.0;
@@ -92,7 +132,20 @@ double rotationX = 0.0, rotationZ = 0.0;
 int last_MotionX, last_MotionZ;
 
 PLYReader plyReader;
+// Leitura em segundo plano dos arquivos PLY carregados no modo de edição
+PLYLoader plyLoader;
+// Indica se uma thread está aguardando dados digitados no console
+atomic<bool> consoleBusy(false);
+// Diretório cujos arquivos PLY são lidos na inicialização (vazio desabilita) e o limite de memória (em MB) dessa leitura
+string plyPreloadDirectory = "";
+size_t plyPreloadBudget = 1024;
+// Tamanho (em MB) a partir do qual os arquivos PLY são lidos em fluxo para uma malha compacta (0 desabilita)
+size_t plyStreamThreshold = 64;
 glcWavefrontObject* objectManager;
+// Identificadores das estátuas carregadas pelo objectManager
+int statueHandles[4];
+// Colisores das estátuas, formados pelas envoltórias convexas geradas na importação
+HullCollider statueColliderList[4];
 
 Scene mainScene;
 
@@ -106,6 +159,12 @@ Object *currObj;
 Axis axis;
 Grid grid(0.1, -1.3, 1.3, -1.3, 1.3);
 PLYObject *highlighter;
+
+// Matrizes das viewports 2D (0) e 3D (1) do modo de edição no último quadro desenhado
+GLdouble editModelviewMatrix[2][16];
+GLdouble editProjectionMatrix[2][16];
+GLint editViewport[2][4];
+bool editViewportStored[2] = { false, false };
 Ground *ground;
 Cylinder *cylinder;
 Player player(-1.2, 0.2, 0.0);
@@ -126,7 +185,6 @@ void keyboardUp(unsigned char key, int x, int y);
 void specialKeyboard(int key, int x, int y);
 void motion(int x, int y);
 void mouse(int button, int state, int x, int y);
-void idle(void);
 void reshape(int w, int h);
 void display(void);
 
@@ -136,6 +194,26 @@ int main(int argc, char** argv)
     {
         // Inicializa o GLUT
         glutInit(&argc, argv);
+
+        // Opções restantes da linha de comando: --preload [diretório], --preload-budget <MB> e --stream-threshold <MB>
+        for(int i = 1; i < argc; i++)
+        {
+            string option = argv[i];
+
+            if(option == "--preload")
+            {
+                plyPreloadDirectory = ((i + 1 < argc) && (argv[i + 1][0] != '-')) ? argv[++i] : "data/ply";
+            }
+            else if((option == "--preload-budget") && (i + 1 < argc))
+            {
+                plyPreloadBudget = stoul(argv[++i]);
+            }
+            else if((option == "--stream-threshold") && (i + 1 < argc))
+            {
+                plyStreamThreshold = stoul(argv[++i]);
+            }
+        }
+
         glutInitDisplayMode(GLUT_RGB | GLUT_DOUBLE | GLUT_DEPTH);
         glutInitWindowSize(initWindowWidth, initWindowHeight);
         initWindowPosX = ((glutGet(GLUT_SCREEN_WIDTH) - initWindowWidth) / 2);
@@ -150,12 +228,16 @@ int main(int argc, char** argv)
         glutSpecialFunc(specialKeyboard);
         glutMotionFunc(motion);
         glutMouseFunc(mouse);
-        glutIdleFunc(idle);
         glutReshapeFunc(reshape);
         glutDisplayFunc(display);
 
         glutIgnoreKeyRepeat(1);
 
+        // Inicia o laço da simulação
+        lastSimulationTime = glutGet(GLUT_ELAPSED_TIME);
+        lastTitleTime = lastSimulationTime;
+        glutTimerFunc(0, timer, 0);
+
         cout << "# =========================================================== #" << endl;
         cout << "No modo de edição:" << endl;
         cout << "'s' -> Salva cenário" << endl;
@@ -179,7 +261,8 @@ int main(int argc, char** argv)
         cout << "'Seta para cima/baixo' -> Altera o objeto selecionado do grupo" << endl;
         cout << "'Seta para cima/baixo' -> Altera o objeto PLY selecionado (EditMode = PLY)" << endl;
         cout << "'Seta para esquerda/direita' -> Altera o grupo selecionado" << endl;
-        cout << "'Clique esquerdo' -> Cria um ponto no grid 2D (EditMode != PLY). 2 pontos criam uma parede" << endl;
+        cout << "'Clique esquerdo' -> Seleciona o objeto clicado (nas duas viewports)" << endl;
+        cout << "'Clique esquerdo' -> Fora dos objetos, cria um ponto no grid 2D (EditMode != PLY). 2 pontos criam uma parede" << endl;
         cout << "'Clique direito' -> Remove o último ponto criado (EditMode != PLY)" << endl;
         cout << "'Scroll up/down' -> Aumenta/diminui o zoom do cenário 3D" << endl;
         cout << "'Movimento do mouse' -> Rotaciona o cenário 3D" << endl;
@@ -188,13 +271,22 @@ int main(int argc, char** argv)
         cout << "No modo de navegação:" << endl;
         cout << "'Movimento do mouse' -> Rotaciona a câmera" << endl;
         cout << "'a', 'w', 's', 'd' -> Navega pelo cenário" << endl;
+        cout << "'Shift + a, w, s, d' -> Corre pelo cenário" << endl;
         cout << "'m' -> Alterna para o modo de edição" << endl;
         cout << "'/' -> Habilita/desabilita a colisão" << endl;
+        cout << "'k' -> Alterna o detalhe da colisão (bounding box, envoltórias convexas ou malha exata)" << endl;
         cout << "'F12' -> Habilita/desabilita o modo tela inteira" << endl;
         cout << "'ESC' -> Sai do programa" << endl;
         cout << "# =========================================================== #" << endl;
         cout << ">>>>> AVISO: POR PADRÃO, A COLISÃO ESTÁ DESABILITADA! (Use '/' para ativar/desativar)" << endl << endl;
 
+        // Lê todos os arquivos PLY do diretório em paralelo, sem bloquear a cena
+        if(!plyPreloadDirectory.empty())
+        {
+            int fileCount = plyLoader.requestDirectory(plyPreloadDirectory, plyPreloadBudget * 1024 * 1024);
+            cout << "Carregando " << fileCount << " arquivos PLY de " << plyPreloadDirectory << " em segundo plano..." << endl << endl;
+        }
+
         glutMainLoop();
     }
     catch(exception &ex)
@@ -279,7 +371,6 @@ void initNavigation()
     {
         glutPassiveMotionFunc(motion);
         glutSetCursor(GLUT_CURSOR_NONE);
-        glutTimerFunc(1, timer, 0);
     }
 }
 
@@ -381,7 +472,7 @@ void initMuseum()
     Brick* paint01 = new Brick();
     paint01->setMaterialType(MaterialType::White);
     paint01->setEnableTexture(true);
-    paint01->setTextureId(10);
+    paint01->setTextureId(6);
     paint01->getFace(0)->setEnableTexture(false);
     paint01->getFace(1)->setEnableTexture(false);
     paint01->getFace(2)->setEnableTexture(false);
@@ -397,7 +488,7 @@ void initMuseum()
     Brick* paint02 = new Brick();
     paint02->setMaterialType(MaterialType::White);
     paint02->setEnableTexture(true);
-    paint02->setTextureId(11);
+    paint02->setTextureId(7);
     paint02->getFace(0)->setEnableTexture(false);
     paint02->getFace(1)->setEnableTexture(false);
     paint02->getFace(2)->setEnableTexture(false);
@@ -445,7 +536,7 @@ void initMuseum()
     Brick* paint03 = new Brick();
     paint03->setMaterialType(MaterialType::White);
     paint03->setEnableTexture(true);
-    paint03->setTextureId(12);
+    paint03->setTextureId(8);
     paint03->getFace(0)->setEnableTexture(false);
     paint03->getFace(1)->setEnableTexture(false);
     paint03->getFace(2)->setEnableTexture(false);
@@ -461,7 +552,7 @@ void initMuseum()
     Brick* paint04 = new Brick();
     paint04->setMaterialType(MaterialType::White);
     paint04->setEnableTexture(true);
-    paint04->setTextureId(13);
+    paint04->setTextureId(9);
     paint04->getFace(0)->setEnableTexture(false);
     paint04->getFace(1)->setEnableTexture(false);
     paint04->getFace(2)->setEnableTexture(false);
@@ -520,7 +611,7 @@ void initMuseum()
     Brick* paint05 = new Brick();
     paint05->setMaterialType(MaterialType::White);
     paint05->setEnableTexture(true);
-    paint05->setTextureId(9);
+    paint05->setTextureId(5);
     paint05->getFace(0)->setEnableTexture(false);
     paint05->getFace(1)->setEnableTexture(false);
     paint05->getFace(2)->setEnableTexture(false);
@@ -536,37 +627,40 @@ void initMuseum()
 void initObj()
 {
     objectManager = new glcWavefrontObject();
-    objectManager->SetNumberOfObjects(4);
     objectManager->SetShadingMode(SMOOTH_SHADING);
     objectManager->SetRenderMode(USE_TEXTURE_AND_MATERIAL);
+    // Envoltórias convexas usadas na colisão com as estátuas
+    objectManager->SetConvexHullGeneration(32, 2);
+    // Solda dos vértices repetidos nos arquivos das estátuas
+    objectManager->SetVertexWelding(true, 1e-6);
+    // Posições, normais e coordenadas de textura das estátuas guardadas em 16 bits
+    objectManager->SetVertexQuantization(true);
+
+    // As malhas já processadas são lidas do cache binário enquanto os arquivos OBJ/MTL não mudarem,
+    // e as quatro estátuas são processadas ao mesmo tempo
+    const char *statueFiles[4] = { objFiles[0], objFiles[1], objFiles[2], objFiles[3] };
+    GLfloat statueScales[4] = { 0.5, 0.7, 0.4, 0.5 };
+    objectManager->LoadProcessedObjects(4, statueFiles, 90.0, statueScales, statueHandles);
+
+    // Posiciona os colisores com as mesmas transformações usadas no desenho das estátuas
+    for(int i = 0; i < 4; i++)
+    {
+        for(int j = 0; j < objectManager->GetNumberOfConvexHulls(statueHandles[i]); j++)
+        {
+            statueColliderList[i].addConvexHull(objectManager->GetConvexHull(statueHandles[i], j));
+        }
 
-    objectManager->SelectObject(0);
-    objectManager->ReadObject(objFiles[0]);
-    objectManager->Unitize();
-    objectManager->FacetNormal();
-    objectManager->VertexNormals(90.0);
-    objectManager->Scale(0.5);
-
-    objectManager->SelectObject(1);
-    objectManager->ReadObject(objFiles[1]);
-    objectManager->Unitize();
-    objectManager->FacetNormal();
-    objectManager->VertexNormals(90.0);
-    objectManager->Scale(0.7);
-
-    objectManager->SelectObject(2);
-    objectManager->ReadObject(objFiles[2]);
-    objectManager->Unitize();
-    objectManager->FacetNormal();
-    objectManager->VertexNormals(90.0);
-    objectManager->Scale(0.4);
-
-    objectManager->SelectObject(3);
-    objectManager->ReadObject(objFiles[3]);
-    objectManager->Unitize();
-    objectManager->FacetNormal();
-    objectManager->VertexNormals(90.0);
-    objectManager->Scale(0.5);
+        GLfloat acmr[2];
+        objectManager->GetACMR(statueHandles[i], acmr);
+        cout << "Estátua " << statueFiles[i] << " | ACMR: " << acmr[0] << " -> " << acmr[1]
+             << " | Vértices soldados: " << objectManager->GetNumberOfWeldedVertices(statueHandles[i])
+             << " | Vértices: " << objectManager->GetVertexDataSize(statueHandles[i]) / 1024 << " KB" << endl;
+
+        AffineTransform *statueTransform = statueColliderList[i].getTransform();
+        statueTransform->rotateX(-90.0 * M_PI / 180.0);
+        statueTransform->rotateY(statuePlacement[i][3] * M_PI / 180.0);
+        statueTransform->translate(statuePlacement[i][0], statuePlacement[i][1], statuePlacement[i][2]);
+    }
 }
 
 void initTexture()
@@ -574,22 +668,19 @@ void initTexture()
     textureManager = new glcTexture();
     textureManager->SetColorMode(GL_MODULATE);
     textureManager->SetWrappingMode(GL_REPEAT);
-    textureManager->SetNumberOfTextures(14);
+    textureManager->SetNumberOfTextures(10);
 
     textureManager->CreateTexture("data/texture/door.png", 0);
     textureManager->CreateTexture("data/texture/floor.png", 1);
     textureManager->CreateTexture("data/texture/wall.png", 2);
     textureManager->CreateTexture("data/texture/wood_wall.png", 3);
     textureManager->CreateTexture("data/texture/support.png", 4);
-    textureManager->CreateTexture(objTextureFiles[0], 5);
-    textureManager->CreateTexture(objTextureFiles[1], 6);
-    textureManager->CreateTexture(objTextureFiles[2], 7);
-    textureManager->CreateTexture(objTextureFiles[3], 8);
-    textureManager->CreateTexture("data/texture/paint05.png", 9);
-    textureManager->CreateTexture("data/texture/paint01.png", 10);
-    textureManager->CreateTexture("data/texture/paint02.png", 11);
-    textureManager->CreateTexture("data/texture/paint03.png", 12);
-    textureManager->CreateTexture("data/texture/paint04.png", 13);
+    // As texturas das estátuas são lidas das bibliotecas de materiais (map_Kd) pelo objectManager
+    textureManager->CreateTexture("data/texture/paint05.png", 5);
+    textureManager->CreateTexture("data/texture/paint01.png", 6);
+    textureManager->CreateTexture("data/texture/paint02.png", 7);
+    textureManager->CreateTexture("data/texture/paint03.png", 8);
+    textureManager->CreateTexture("data/texture/paint04.png", 9);
 }
 
 void init(void)
@@ -616,7 +707,19 @@ void init(void)
     highlighter->rescaling(0.2, 0.2, 0.2);
     highlighter->rotateXAxis(90.0);
     highlighter->rotateYAxis(90.0);
-    highlighter->translate(0.0, 0.2, 0.0);
+
+    // Os objetos PLY carregados no cenário recebem envoltórias convexas para a colisão
+    plyLoader.setConvexHullGeneration(32, 2);
+    // Muitos arquivos PLY repetem os vértices em cada face
+    plyLoader.setVertexWelding(true, 1e-6);
+    // Os arquivos grandes são lidos em fluxo, com a memória limitada pela janela de leitura
+    plyLoader.setStreamThreshold(plyStreamThreshold * 1024 * 1024);
+
+    // A leitura de um diretório inteiro usa uma thread de trabalho por núcleo
+    if(!plyPreloadDirectory.empty())
+    {
+        plyLoader.setWorkerCount(thread::hardware_concurrency());
+    }
 
     initObj();
     initTexture();
@@ -628,209 +731,265 @@ void init(void)
     initNavigation();
 }
 
-void timer(int value)
+// Obtém o instante de impacto (entre 0 e 1) do jogador deslocado por displacement contra o cenário
+double playerTimeOfImpact(const double displacement[3])
 {
-	if(nav_keyUp['w'] || nav_keyUp['W'])
-	{
-	    if(enableCollision)
-        {
-            if(!lockBackward)
-            {
-                ObjectGroup *tmpObjectGroup;
-
-                for(int i = 0; i < mainScene.objectGroupListSize(); i++)
-                {
-                    tmpObjectGroup = mainScene.getObjectGroup(i);
+    BoundingBox *playerBox = player.getCollider();
+    ObjectGroup *tmpObjectGroup;
+    double toi = 1.0;
 
-                    vector<Collider*>* colliderList = tmpObjectGroup->getColliderList();
-                    vector<BoundingBox*>* wallBoundingBoxList = tmpObjectGroup->getWallBoundingBoxList();
+    for(int i = 0; i < mainScene.objectGroupListSize(); i++)
+    {
+        tmpObjectGroup = mainScene.getObjectGroup(i);
 
-                    for(unsigned int j = 0; j < colliderList->size(); j++)
-                    {
-                        if(player.getCollider()->hit(colliderList->at(j)->getCollider()))
-                        {
-                            lockForward = true;
-                            break;
-                        }
-                    }
+        vector<Collider*>* colliderList = tmpObjectGroup->getColliderList();
+        vector<BoundingBox*>* wallBoundingBoxList = tmpObjectGroup->getWallBoundingBoxList();
 
-                    for(unsigned int j = 0; j < wallBoundingBoxList->size(); j++)
-                    {
-                        if(player.getCollider()->hit(wallBoundingBoxList->at(j)))
-                        {
-                            lockForward = true;
-                            break;
-                        }
-                    }
-                }
-            }
-            else
-            {
-                lockBackward = false;
-                lockLeft = false;
-                lockRight = false;
-            }
+        for(unsigned int j = 0; j < colliderList->size(); j++)
+        {
+            toi = min(toi, colliderList->at(j)->sweep(playerBox, displacement, collisionDetail));
         }
 
-        if(!lockForward)
+        for(unsigned int j = 0; j < wallBoundingBoxList->size(); j++)
         {
-            player.forward();
+            toi = min(toi, playerBox->sweep(wallBoundingBoxList->at(j), displacement));
         }
-	}
-	else if(nav_keyUp['s'] || nav_keyUp['S'])
-	{
-	    if(enableCollision)
-        {
-            if(!lockForward)
-            {
-                ObjectGroup *tmpObjectGroup;
+    }
 
-                for(int i = 0; i < mainScene.objectGroupListSize(); i++)
-                {
-                    tmpObjectGroup = mainScene.getObjectGroup(i);
+    for(int i = 0; i < 4; i++)
+    {
+        toi = min(toi, statueColliderList[i].sweep(playerBox, displacement, collisionDetail));
+    }
 
-                    vector<Collider*>* colliderList = tmpObjectGroup->getColliderList();
-                    vector<BoundingBox*>* wallBoundingBoxList = tmpObjectGroup->getWallBoundingBoxList();
+    return toi;
+}
 
-                    for(unsigned int j = 0; j < colliderList->size(); j++)
-                    {
-                        if(player.getCollider()->hit(colliderList->at(j)->getCollider()))
-                        {
-                            lockBackward = true;
-                            break;
-                        }
-                    }
+// Desloca o jogador até o primeiro contato, mantendo uma pequena folga, e retorna a fração percorrida
+double movePlayerUntilImpact(const double displacement[3])
+{
+    double length = sqrt(displacement[0] * displacement[0] + displacement[1] * displacement[1] + displacement[2] * displacement[2]);
 
-                    for(unsigned int j = 0; j < wallBoundingBoxList->size(); j++)
-                    {
-                        if(player.getCollider()->hit(wallBoundingBoxList->at(j)))
-                        {
-                            lockBackward = true;
-                            break;
-                        }
-                    }
-                }
-            }
-            else
-            {
-                lockForward = false;
-                lockLeft = false;
-                lockRight = false;
-            }
-        }
+    if(length == 0.0)
+    {
+        return 1.0;
+    }
+
+    double toi = playerTimeOfImpact(displacement);
+
+    if(toi < 1.0)
+    {
+        toi = max(0.0, toi - (1e-4 / length));
+    }
+
+    double partialDisplacement[3] = { toi * displacement[0], toi * displacement[1], toi * displacement[2] };
+    player.move(partialDisplacement);
+
+    return toi;
+}
+
+void updatePlayer(double deltaTime)
+{
+    int forwardAxis = 0;
+    int strafeAxis = 0;
+
+    if(nav_keyUp['w'] || nav_keyUp['W'])
+    {
+        forwardAxis = 1;
+    }
+    else if(nav_keyUp['s'] || nav_keyUp['S'])
+    {
+        forwardAxis = -1;
+    }
+    else if(nav_keyUp['a'] || nav_keyUp['A'])
+    {
+        strafeAxis = 1;
+    }
+    else if(nav_keyUp['d'] || nav_keyUp['D'])
+    {
+        strafeAxis = -1;
+    }
+
+    if((forwardAxis == 0) && (strafeAxis == 0))
+    {
+        return;
+    }
+
+    double displacement[3];
+    player.getDisplacement(forwardAxis, strafeAxis, (enableRun ? runSpeedFactor : 1.0), deltaTime, displacement);
+
+    if(!enableCollision)
+    {
+        player.move(displacement);
+        return;
+    }
 
-        if(!lockBackward)
+    // Colisão contínua: o deslocamento é varrido contra o cenário, então não há como atravessar
+    // paredes finas independentemente da velocidade
+    double toi = movePlayerUntilImpact(displacement);
+
+    // O restante do deslocamento desliza ao longo do obstáculo, eixo por eixo
+    if(toi < 1.0)
+    {
+        for(int axis = 0; axis < 3; axis += 2)
         {
-            player.backward();
+            double slideDisplacement[3] = { 0.0, 0.0, 0.0 };
+            slideDisplacement[axis] = (1.0 - toi) * displacement[axis];
+
+            movePlayerUntilImpact(slideDisplacement);
         }
-	}
-	else if(nav_keyUp['a'] || nav_keyUp['A'])
-	{
-	    if(enableCollision)
-        {
-            if(!lockRight)
-            {
-                ObjectGroup *tmpObjectGroup;
+    }
+}
 
-                for(int i = 0; i < mainScene.objectGroupListSize(); i++)
-                {
-                    tmpObjectGroup = mainScene.getObjectGroup(i);
+void updateWindowTitle(int currTime)
+{
+    // Calcula o FPS e exibe as informações na barra de título da janela
+    if((currTime - lastTitleTime) < 1000)
+    {
+        return;
+    }
 
-                    vector<Collider*>* colliderList = tmpObjectGroup->getColliderList();
-                    vector<BoundingBox*>* wallBoundingBoxList = tmpObjectGroup->getWallBoundingBoxList();
+    GLfloat seconds = (currTime - lastTitleTime) / 1000.0;
+    GLfloat fps = renderedFrames / seconds;
+    lastTitleTime = currTime;
+    renderedFrames = 0;
 
-                    for(unsigned int j = 0; j < colliderList->size(); j++)
-                    {
-                        if(player.getCollider()->hit(colliderList->at(j)->getCollider()))
-                        {
-                            lockLeft = true;
-                            break;
-                        }
-                    }
+    string windowTitle = string("CG - Virtual Ambient")
+                        + string(" | FPS = ") + to_string(fps)
+                        + string(" | Group = ") + to_string(currObjGroupIndex)
+                        + string(" | Edit Mode = ") + editModeEnumToString(editMode)
+                        + string(" | Mode Factor = ") + to_string(modeFactor)
+                        + string(" | Wall = (") + to_string(currObjGroup->getWallWidth()) + ", " + to_string(currObjGroup->getWallHeight()) + ")";
 
-                    for(unsigned int j = 0; j < wallBoundingBoxList->size(); j++)
-                    {
-                        if(player.getCollider()->hit(wallBoundingBoxList->at(j)))
-                        {
-                            lockLeft = true;
-                            break;
-                        }
-                    }
-                }
-            }
-            else
-            {
-                lockForward = false;
-                lockBackward = false;
-                lockLeft = false;
-            }
-        }
+    if((editMode == ModePLY) && !plyNameList.empty())
+    {
+        windowTitle += string(" | PLY Name = ") + plyNameList[currPLYIndex];
+    }
+
+    // Triângulos das estátuas enviados no último desenho, após o descarte dos agrupamentos
+    int drawnTriangles = 0;
+    int statueTriangles = 0;
+
+    for(int i = 0; i < 4; i++)
+    {
+        drawnTriangles += objectManager->GetNumberOfDrawnTriangles(statueHandles[i]);
+        statueTriangles += objectManager->GetNumberOfTriangles(statueHandles[i]);
+    }
+
+    windowTitle += string(" | Statue Triangles = ") + to_string(drawnTriangles) + "/" + to_string(statueTriangles);
+
+    int pendingPLY = plyLoader.getPendingCount();
+
+    if(pendingPLY > 0)
+    {
+        windowTitle += string(" | Loading PLY = ") + to_string((int)(100.0 * plyLoader.getProgress())) + "%"
+                       + string(" (") + to_string(pendingPLY) + " files)";
+    }
+
+    glutSetWindowTitle(windowTitle.c_str());
+}
+
+// Recebe os arquivos PLY cuja leitura em segundo plano terminou
+void receiveLoadedPLY()
+{
+    PLYLoadResult result;
 
-        if(!lockLeft)
+    while(plyLoader.popResult(result))
+    {
+        if(result.plyObject == NULL)
         {
-            player.left();
+            cout << endl << ">>>>> ERROR: " << result.path << ": " << result.error << endl;
+            continue;
         }
-	}
-	else if(nav_keyUp['d'] || nav_keyUp['D'])
-	{
-	    if(enableCollision)
-        {
-            if(!lockLeft)
-            {
-                ObjectGroup *tmpObjectGroup;
 
-                for(int i = 0; i < mainScene.objectGroupListSize(); i++)
-                {
-                    tmpObjectGroup = mainScene.getObjectGroup(i);
+        plyList.push_back(result.plyObject);
+        plyNameList.push_back(result.name);
 
-                    vector<Collider*>* colliderList = tmpObjectGroup->getColliderList();
-                    vector<BoundingBox*>* wallBoundingBoxList = tmpObjectGroup->getWallBoundingBoxList();
+        currPLYIndex = (plyNameList.size() - 1);
 
-                    for(unsigned int j = 0; j < colliderList->size(); j++)
-                    {
-                        if(player.getCollider()->hit(colliderList->at(j)->getCollider()))
-                        {
-                            lockRight = true;
-                            break;
-                        }
-                    }
+        double acmrBefore, acmrAfter;
+        result.plyObject->getVertexCacheStats(acmrBefore, acmrAfter);
 
-                    for(unsigned int j = 0; j < wallBoundingBoxList->size(); j++)
-                    {
-                        if(player.getCollider()->hit(wallBoundingBoxList->at(j)))
-                        {
-                            lockRight = true;
-                            break;
-                        }
-                    }
-                }
-            }
-            else
-            {
-                lockForward = false;
-                lockBackward = false;
-                lockRight = false;
-            }
+        cout << "Carregamento do arquivo PLY " << result.name << " terminado!" << endl;
+        cout << "ACMR: " << acmrBefore << " -> " << acmrAfter << endl;
+
+        cout << "Vértices soldados: " << result.plyObject->getWeldedVertexCount() << endl;
+
+        QuantizedMesh *quantizedMesh = result.plyObject->getQuantizedMesh();
+
+        if(quantizedMesh)
+        {
+            cout << "Malha compacta: " << quantizedMesh->getVertexCount() << " vértices, " << quantizedMesh->getTriangleCount()
+                 << " triângulos (" << quantizedMesh->getMemorySize() / 1024 << " KB)" << endl;
         }
 
-        if(!lockRight)
+        cout << endl;
+
+        glutPostRedisplay();
+    }
+}
+
+void timer(int value)
+{
+    int currTime = glutGet(GLUT_ELAPSED_TIME);
+
+    // Limita o tempo acumulado para não disparar muitos passos após uma pausa (ex.: leitura no console)
+    simulationAccumulator += min(currTime - lastSimulationTime, 250);
+    lastSimulationTime = currTime;
+
+    bool playerChanged = false;
+
+    while(simulationAccumulator >= simulationStep)
+    {
+        // Um passo parado logo após um movimento ainda precisa ser desenhado para concluir a interpolação
+        playerChanged = playerChanged || player.isMoving();
+
+        player.storePreviousPosition();
+
+        if(!enableEditMode)
         {
-            player.right();
+            updatePlayer(simulationStep / 1000.0);
         }
-	}
 
-	if(!enableEditMode)
+        playerChanged = playerChanged || player.isMoving();
+        simulationAccumulator -= simulationStep;
+    }
+
+    // Só desenha um novo quadro quando a câmera mudou
+    if(playerChanged && !enableEditMode)
     {
-        glutTimerFunc(1, timer, 0);
+        glutPostRedisplay();
     }
+
+    receiveLoadedPLY();
+    updateWindowTitle(currTime);
+
+    // Agenda o próximo passo
+    int nextStep = (int)ceil(simulationStep - simulationAccumulator);
+    glutTimerFunc(max(nextStep, 1), timer, 0);
+}
+
+// Obtém a fração do passo atual já decorrida, usada para interpolar a câmera
+double simulationAlpha()
+{
+    double alpha = (simulationAccumulator + (glutGet(GLUT_ELAPSED_TIME) - lastSimulationTime)) / simulationStep;
+
+    return min(alpha, 1.0);
 }
 
 void keyboard(unsigned char key, int x, int y)
 {
     nav_keyUp[key] = true;
+    enableRun = ((glutGetModifiers() & GLUT_ACTIVE_SHIFT) != 0);
 
     if(enableEditMode)
     {
+        // Os comandos que leem do console aguardam a leitura iniciada anteriormente
+        if(consoleBusy && ((tolower(key) == 's') || (tolower(key) == 'l')))
+        {
+            cout << endl << "Aguarde, há uma leitura do console em andamento." << endl;
+            return;
+        }
+
         switch(tolower(key))
         {
             case 's':
@@ -882,7 +1041,11 @@ void keyboard(unsigned char key, int x, int y)
                 }
                 else
                 {
-                    try
+                    // O caminho e o nome são lidos do console em outra thread e o arquivo é lido
+                    // em segundo plano, sem bloquear a cena; o objeto é recebido em receiveLoadedPLY()
+                    consoleBusy = true;
+
+                    thread([]()
                     {
                         string plyPath;
                         string plyName;
@@ -890,22 +1053,14 @@ void keyboard(unsigned char key, int x, int y)
                         cout << "Informe o caminho do arquivo PLY: ";
                         cin >> plyPath;
 
-                        cout << "Aguarde, carregando o arquivo " << plyPath << "...";
-                        PLYObject *objPly = plyReader.read_ply_file(plyPath);
-                        plyList.push_back(objPly);
-
-                        cout << endl << "Informe um nome para o arquivo carregado: ";
+                        cout << "Informe um nome para o arquivo carregado: ";
                         cin >> plyName;
-                        plyNameList.push_back(plyName);
 
-                        cout << "Carregamento do arquivo PLY terminado!" << endl << endl;
+                        plyLoader.requestLoad(plyPath, plyName);
+                        cout << "Carregando o arquivo " << plyPath << " em segundo plano..." << endl;
 
-                        currPLYIndex = (plyNameList.size() - 1);
-                    }
-                    catch(exception &ex)
-                    {
-                        cout << endl << ">>>>> ERROR: " << ex.what() << endl;
-                    }
+                        consoleBusy = false;
+                    }).detach();
                 }
                 break;
             }
@@ -922,7 +1077,6 @@ void keyboard(unsigned char key, int x, int y)
                 {
                     glutPassiveMotionFunc(motion);
                     glutSetCursor(GLUT_CURSOR_NONE);
-                    glutTimerFunc(1, timer, 0);
                 }
                 break;
             }
@@ -1229,29 +1383,34 @@ void keyboard(unsigned char key, int x, int y)
                 {
                     glutPassiveMotionFunc(motion);
                     glutSetCursor(GLUT_CURSOR_NONE);
-                    glutTimerFunc(1, timer, 0);
                 }
                 break;
             }
             case '/':
             {
                 enableCollision = !enableCollision;
-
-                lockForward = false;
-                lockBackward = false;
-                lockLeft = false;
-                lockRight = false;
+                break;
+            }
+            case 'k':
+            {
+                collisionDetail = collisionDetail++;
+                cout << ">>>>> Detalhe da colisão: " << collisionDetailEnumToString(collisionDetail) << endl;
                 break;
             }
             case 27:
                 exit(0);
         }
     }
+
+    glutPostRedisplay();
 }
 
 void keyboardUp(unsigned char key, int x, int y)
 {
-	nav_keyUp[key] = false;
+    // Libera as duas variações da tecla, já que o Shift pode mudar entre o pressionar e o soltar
+	nav_keyUp[tolower(key)] = false;
+	nav_keyUp[toupper(key)] = false;
+	enableRun = ((glutGetModifiers() & GLUT_ACTIVE_SHIFT) != 0);
 }
 
 void specialKeyboard(int key, int x, int y)
@@ -1353,6 +1512,8 @@ void specialKeyboard(int key, int x, int y)
             break;
         }
     }
+
+    glutPostRedisplay();
 }
 
 void motion(int x, int y)
@@ -1374,6 +1535,57 @@ void motion(int x, int y)
     {
         player.rotate(x, y, currMiddleWindowWidth, currMiddleWindowHeight);
     }
+
+    glutPostRedisplay();
+}
+
+void storeEditViewport(int viewportIndex)
+{
+    glGetDoublev(GL_MODELVIEW_MATRIX, editModelviewMatrix[viewportIndex]);
+    glGetDoublev(GL_PROJECTION_MATRIX, editProjectionMatrix[viewportIndex]);
+    glGetIntegerv(GL_VIEWPORT, editViewport[viewportIndex]);
+
+    editViewportStored[viewportIndex] = true;
+}
+
+// Seleciona o objeto atingido pelo raio que passa pelo pixel (x, y) de uma das viewports do modo de edição
+bool selectObjectAt(int x, int y)
+{
+    int viewportIndex = (x < currMiddleWindowWidth) ? 0 : 1;
+
+    if(!editViewportStored[viewportIndex])
+    {
+        return false;
+    }
+
+    // Pontos do pixel nos planos próximo e distante da projeção
+    double winY = currWindowHeight - y;
+    double nearPoint[3], farPoint[3];
+
+    if(!gluUnProject(x, winY, 0.0, editModelviewMatrix[viewportIndex], editProjectionMatrix[viewportIndex], editViewport[viewportIndex],
+                     &nearPoint[0], &nearPoint[1], &nearPoint[2]) ||
+       !gluUnProject(x, winY, 1.0, editModelviewMatrix[viewportIndex], editProjectionMatrix[viewportIndex], editViewport[viewportIndex],
+                     &farPoint[0], &farPoint[1], &farPoint[2]))
+    {
+        return false;
+    }
+
+    double direction[3] = { farPoint[0] - nearPoint[0], farPoint[1] - nearPoint[1], farPoint[2] - nearPoint[2] };
+    SceneRayHit hit;
+
+    if(!mainScene.raycast(nearPoint, direction, hit))
+    {
+        return false;
+    }
+
+    currObjGroupIndex = hit.objectRef.groupIndex;
+    currObjGroup = mainScene.getObjectGroup(currObjGroupIndex);
+    currObjIndex = hit.objectRef.objectIndex;
+    currObj = hit.objectRef.object;
+
+    cout << ">>>>> Objeto " << currObjIndex << " do grupo " << currObjGroupIndex << " selecionado (face " << hit.faceIndex << ")" << endl;
+
+    return true;
 }
 
 void mouse(int button, int state, int x, int y)
@@ -1382,8 +1594,9 @@ void mouse(int button, int state, int x, int y)
     {
         if ((button == GLUT_LEFT_BUTTON) && (state == GLUT_DOWN)) // Botão esquerdo do mouse
         {
-            // Limita o clique apenas para a Viewport dos pontos 2D
-            if(x < currMiddleWindowWidth)
+            // Clique sobre um objeto em qualquer viewport seleciona o objeto. Caso contrário,
+            // limita o clique apenas para a Viewport dos pontos 2D
+            if(!selectObjectAt(x, y) && (x < currMiddleWindowWidth))
             {
                 double posX, posY, posZ;
 
@@ -1448,40 +1661,6 @@ void mouse(int button, int state, int x, int y)
     glutPostRedisplay();
 }
 
-void idle()
-{
-     // Calcula o FPS e exibe as informações na barra de título da janela
-    static int frames = 0;
-    static int t0 = 0;
-
-    frames++;
-    GLint t = glutGet(GLUT_ELAPSED_TIME);
-
-    if (t - t0 >= 1000)
-    {
-        GLfloat seconds = (t - t0) / 1000.0;
-        GLfloat fps = frames / seconds;
-        t0 = t;
-        frames = 0;
-
-        string windowTitle = string("CG - Virtual Ambient")
-                            + string(" | FPS = ") + to_string(fps)
-                            + string(" | Group = ") + to_string(currObjGroupIndex)
-                            + string(" | Edit Mode = ") + editModeEnumToString(editMode)
-                            + string(" | Mode Factor = ") + to_string(modeFactor)
-                            + string(" | Wall = (") + to_string(currObjGroup->getWallWidth()) + ", " + to_string(currObjGroup->getWallHeight()) + ")";
-
-        if((editMode == ModePLY) && !plyNameList.empty())
-        {
-            windowTitle += string(" | PLY Name = ") + plyNameList[currPLYIndex];
-        }
-
-        glutSetWindowTitle(windowTitle.c_str());
-    }
-
-    glutPostRedisplay();
-}
-
 void reshape(int w, int h)
 {
     currWindowWidth = w;
@@ -1493,60 +1672,28 @@ void reshape(int w, int h)
 
 void drawObj()
 {
-    glPushMatrix();
-        glTranslated(-0.75, 0.3, -0.02);
-        glRotated(-90.0, 0.0, 1.0, 0.0);
-        glRotated(-90.0, 1.0, 0.0, 0.0);
-
-        textureManager->Bind(5);
-
-        objectManager->SelectObject(0);
-        objectManager->Draw();
-    glPopMatrix();
-
-    glPushMatrix();
-        glTranslated(1.0, 0.4, 0.0);
-        glRotated(-90.0, 0.0, 1.0, 0.0);
-        glRotated(-90.0, 1.0, 0.0, 0.0);
-
-        textureManager->Bind(6);
-
-        objectManager->SelectObject(1);
-        objectManager->Draw();
-    glPopMatrix();
-
-    glPushMatrix();
-        glTranslated(0.8, 0.3, 0.8);
-        glRotated(-135.0, 0.0, 1.0, 0.0);
-        glRotated(-90.0, 1.0, 0.0, 0.0);
-
-        textureManager->Bind(7);
-
-        objectManager->SelectObject(2);
-        objectManager->Draw();
-    glPopMatrix();
-
-    glPushMatrix();
-        glTranslated(0.8, 0.35, -0.8);
-        glRotated(-45.0, 0.0, 1.0, 0.0);
-        glRotated(-90.0, 1.0, 0.0, 0.0);
-
-        textureManager->Bind(8);
+    for(int i = 0; i < 4; i++)
+    {
+        glPushMatrix();
+            glTranslated(statuePlacement[i][0], statuePlacement[i][1], statuePlacement[i][2]);
+            glRotated(statuePlacement[i][3], 0.0, 1.0, 0.0);
+            glRotated(-90.0, 1.0, 0.0, 0.0);
 
-        objectManager->SelectObject(3);
-        objectManager->Draw();
-    glPopMatrix();
+            objectManager->Draw(statueHandles[i]);
+        glPopMatrix();
+    }
 }
 
 void drawEditMode()
 {
     vector<Point*>* pointList = currObjGroup->getWallPointList();
 
+    // O marcador é posicionado pela matriz de modelo, sem alterar os seus vértices
+    Vertex3D objCenter;
+
     if(currObj != NULL)
     {
-        Vertex3D objCenter = currObj->getCenter();
-        highlighter->centralize();
-        highlighter->translate(objCenter.getX(), objCenter.getY() + 0.3, objCenter.getZ());
+        objCenter = currObj->getCenter();
     }
 
     // Define a Viewport 2D
@@ -1567,6 +1714,9 @@ void drawEditMode()
 
     gluLookAt(0.0, 0.9, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0);
 
+    // Guarda as matrizes da viewport para a seleção com o mouse
+    storeEditViewport(0);
+
     glPushMatrix();
         enableLighting(false);
             axis.draw();
@@ -1574,7 +1724,10 @@ void drawEditMode()
 
             if(currObj != NULL)
             {
-                highlighter->draw();
+                glPushMatrix();
+                    glTranslated(objCenter.getX(), objCenter.getY() + 0.3, objCenter.getZ());
+                    highlighter->draw();
+                glPopMatrix();
             }
 
             for(int i = (pointList->size() - 1); i >= 0; i--)
@@ -1632,13 +1785,18 @@ void drawEditMode()
         glRotated(rotationZ, 0.0, 0.0, 1.0);
         glRotated(rotationX, 1.0, 0.0, 0.0);
 
+        storeEditViewport(1);
+
         enableLighting(false);
             axis.draw();
             grid.draw();
 
             if(currObj != NULL)
             {
-                highlighter->draw();
+                glPushMatrix();
+                    glTranslated(objCenter.getX(), objCenter.getY() + 0.3, objCenter.getZ());
+                    highlighter->draw();
+                glPopMatrix();
             }
 
             if(enableWireFrame)
@@ -1707,7 +1865,7 @@ void drawNavigatorMode()
     glMatrixMode(GL_MODELVIEW);
     glLoadIdentity();
 
-    player.refresh();
+    player.refresh(simulationAlpha());
 
     glPushMatrix();
         enableLighting(false);
@@ -1771,4 +1929,5 @@ void display(void)
     }
 
     glutSwapBuffers();
+    renderedFrames++;
 }
@@ -1,64 +1,61 @@
 #include "material/Material.h"
 
-Material::~Material()
-{
-    delete polished_bronze_ambient;
-    delete polished_bronze_diffuse;
-    delete polished_bronze_specular;
-    delete polished_bronze_shininess;
-
-    delete polished_copper_ambient;
-    delete polished_copper_diffuse;
-    delete polished_copper_specular;
-    delete polished_copper_shininess;
-
-    delete polished_gold_ambient;
-    delete polished_gold_diffuse;
-    delete polished_gold_specular;
-    delete polished_gold_shininess;
-
-    delete pewter_ambient;
-    delete pewter_diffuse;
-    delete pewter_specular;
-    delete pewter_shininess;
-
-    delete polished_silver_ambient;
-    delete polished_silver_diffuse;
-    delete polished_silver_specular;
-    delete polished_silver_shininess;
-
-    delete emerald_ambient;
-    delete emerald_diffuse;
-    delete emerald_specular;
-    delete emerald_shininess;
-
-    delete ruby_ambient;
-    delete ruby_diffuse;
-    delete ruby_specular;
-    delete ruby_shininess;
-
-    delete turquoise_ambient;
-    delete turquoise_diffuse;
-    delete turquoise_specular;
-    delete turquoise_shininess;
-
-    delete black_rubber_ambient;
-    delete black_rubber_diffuse;
-    delete black_rubber_specular;
-    delete black_rubber_shininess;
-
-    delete grass_ambient;
-    delete grass_diffuse;
-    delete grass_specular;
-    delete grass_shininess;
-
-    delete white_ambient;
-    delete white_diffuse;
-    delete white_specular;
-    delete white_shininess;
-}
-
-void Material::setObjectMaterial(GLfloat* obj_front_ambient, GLfloat* obj_front_diffuse, GLfloat* obj_specular, GLfloat* obj_shininess)
+const GLfloat Material::polished_bronze_ambient[4] = {0.250000, 0.148000, 0.064750, 1.000000};
+const GLfloat Material::polished_bronze_diffuse[4] = {0.400000, 0.236800, 0.103600, 1.000000};
+const GLfloat Material::polished_bronze_specular[4] = {0.774597, 0.458561, 0.200621, 1.000000};
+const GLfloat Material::polished_bronze_shininess[1] = {76.800003};
+
+const GLfloat Material::polished_copper_ambient[4] = {0.229500, 0.088250, 0.027500, 1.000000};
+const GLfloat Material::polished_copper_diffuse[4] = {0.550800, 0.211800, 0.066000, 1.000000};
+const GLfloat Material::polished_copper_specular[4] = {0.580594, 0.223257, 0.069570, 1.000000};
+const GLfloat Material::polished_copper_shininess[1] = {51.200001};
+
+const GLfloat Material::polished_gold_ambient[4] = {0.247250, 0.224500, 0.064500, 1.000000};
+const GLfloat Material::polished_gold_diffuse[4] = {0.346150, 0.314300, 0.090300, 1.000000};
+const GLfloat Material::polished_gold_specular[4] = {0.797357, 0.723991, 0.208006, 1.000000};
+const GLfloat Material::polished_gold_shininess[1] = {83.199997};
+
+const GLfloat Material::pewter_ambient[4] = {0.105882, 0.058824, 0.113725, 1.000000};
+const GLfloat Material::pewter_diffuse[4] = {0.427451, 0.470588, 0.541176, 1.000000};
+const GLfloat Material::pewter_specular[4] = {0.333333, 0.333333, 0.521569, 1.000000};
+const GLfloat Material::pewter_shininess[1] = {9.846150};
+
+const GLfloat Material::polished_silver_ambient[4] = {0.231250, 0.231250, 0.231250, 1.000000};
+const GLfloat Material::polished_silver_diffuse[4] = {0.277500, 0.277500, 0.277500, 1.000000};
+const GLfloat Material::polished_silver_specular[4] = {0.773911, 0.773911, 0.773911, 1.000000};
+const GLfloat Material::polished_silver_shininess[1] = {89.599998};
+
+const GLfloat Material::emerald_ambient[4] = {0.021500, 0.174500, 0.021500, 0.550000};
+const GLfloat Material::emerald_diffuse[4] = {0.075680, 0.614240, 0.075680, 0.550000};
+const GLfloat Material::emerald_specular[4] = {0.633000, 0.727811, 0.633000, 0.550000};
+const GLfloat Material::emerald_shininess[1] = {76.800003};
+
+const GLfloat Material::ruby_ambient[4] = {0.174500, 0.011750, 0.011750, 0.550000};
+const GLfloat Material::ruby_diffuse[4] = {0.614240, 0.041360, 0.041360, 0.550000};
+const GLfloat Material::ruby_specular[4] = {0.1, 0.1, 0.1, 0.0};
+const GLfloat Material::ruby_shininess[1] = {76.0};
+
+const GLfloat Material::turquoise_ambient[4] = {0.100000, 0.187250, 0.174500, 0.800000};
+const GLfloat Material::turquoise_diffuse[4] = {0.396000, 0.741510, 0.691020, 0.800000};
+const GLfloat Material::turquoise_specular[4] = {0.297254, 0.308290, 0.306678, 0.800000};
+const GLfloat Material::turquoise_shininess[1] = {12.800000};
+
+const GLfloat Material::black_rubber_ambient[4] = {0.020000, 0.020000, 0.020000, 1.000000};
+const GLfloat Material::black_rubber_diffuse[4] = {0.010000, 0.010000, 0.010000, 1.000000};
+const GLfloat Material::black_rubber_specular[4] = {0.400000, 0.400000, 0.400000, 1.000000};
+const GLfloat Material::black_rubber_shininess[1] = {10.000000};
+
+const GLfloat Material::grass_ambient[4] = {0.021500, 0.174500, 0.021500, 0.550000};
+const GLfloat Material::grass_diffuse[4] = {0.075680, 0.614240, 0.075680, 0.550000};
+const GLfloat Material::grass_specular[4] = {0.0, 0.0, 0.0, 0.0};
+const GLfloat Material::grass_shininess[1] = {50.0};
+
+const GLfloat Material::white_ambient[4] = {1.0, 1.0, 1.0, 1.0};
+const GLfloat Material::white_diffuse[4] = {1.0, 1.0, 1.0, 1.0};
+const GLfloat Material::white_specular[4] = {0.0, 0.0, 0.0, 0.0};
+const GLfloat Material::white_shininess[1] = {0.0};
+
+void Material::setObjectMaterial(const GLfloat* obj_front_ambient, const GLfloat* obj_front_diffuse, const GLfloat* obj_specular, const GLfloat* obj_shininess)
 {
     glMaterialfv(GL_FRONT, GL_AMBIENT, obj_front_ambient);
     glMaterialfv(GL_FRONT, GL_DIFFUSE, obj_front_diffuse);
@@ -120,3 +117,45 @@ void Material::setWhiteMaterial()
 {
     setObjectMaterial(white_ambient, white_diffuse, white_specular, white_shininess);
 }
+
+void Material::setMaterial(MaterialType materialType)
+{
+    switch(materialType)
+    {
+        case PolishedBronze:
+            setPolishedBronzeMaterial();
+            break;
+        case PolishedCopper:
+            setPolishedCopperMaterial();
+            break;
+        case PolishedGold:
+            setPolishedGoldMaterial();
+            break;
+        case PolishedSilver:
+            setPolishedSilverMaterial();
+            break;
+        case Pewter:
+            setPewterMaterial();
+            break;
+        case Emerald:
+            setEmeraldMaterial();
+            break;
+        case Ruby:
+            setRubyMaterial();
+            break;
+        case Turquoise:
+            setTurquoiseMaterial();
+            break;
+        case BlackRubber:
+            setBlackRubberMaterial();
+            break;
+        case Grass:
+            setGrassMaterial();
+            break;
+        case White:
+            setWhiteMaterial();
+            break;
+        default:
+            setWhiteMaterial();
+    }
+}
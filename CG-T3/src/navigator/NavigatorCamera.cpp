@@ -9,6 +9,11 @@ void NavigatorCamera::Init()
 }
 
 void NavigatorCamera::Refresh()
+{
+	Refresh(m_x, m_y, m_z);
+}
+
+void NavigatorCamera::Refresh(float x, float y, float z)
 {
 	// Camera parameter according to Riegl's co-ordinate system
 	// x/y for flat, z for height
@@ -21,7 +26,7 @@ void NavigatorCamera::Refresh()
 
 	glMatrixMode(GL_MODELVIEW);
 	glLoadIdentity();
-	gluLookAt(m_x, m_y, m_z, m_x + m_lx, m_y + m_ly, m_z + m_lz, 0.0,1.0,0.0);
+	gluLookAt(x, y, z, x + m_lx, y + m_ly, z + m_lz, 0.0,1.0,0.0);
 
 	//printf("Camera: %f %f %f Direction vector: %f %f %f\n", m_x, m_y, m_z, m_lx, m_ly, m_lz);
 }
@@ -54,6 +59,12 @@ void NavigatorCamera::GetDirectionVector(float &x, float &y, float &z)
     z = m_lz;
 }
 
+void NavigatorCamera::GetStrafeVector(float &x, float &z)
+{
+    x = m_strafe_lx;
+    z = m_strafe_lz;
+}
+
 void NavigatorCamera::Move(float incr, bool flyMode)
 {
 	if(flyMode)
@@ -4,16 +4,42 @@
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <ctype.h>
+#include <limits.h>
+
+#include <map>
+#include <algorithm>
+#include <vector>
+#include <memory>
+#include <string>
+#include <stdexcept>
+#include <exception>
+
+#include "io/MappedFile.h"
+#include "io/NumberParser.h"
+#include "thread/ThreadPool.h"
+#include "texture/glcTextureCache.h"
+#include "primitive/VertexCacheOptimizer.h"
+#include "primitive/VertexWelder.h"
+#include "primitive/VertexQuantizer.h"
+
+/* minimum number of triangles or vertices handled by each parallel task */
+#define MIN_PARALLEL_RANGE 8192
+
+/* maximum number of triangles in a cluster */
+#define CLUSTER_SIZE 128
+
+/* fallbacks reported by Draw (once per model) */
+#define DRAW_WARNED_FLAT_SHADING    0x1
+#define DRAW_WARNED_SMOOTH_SHADING  0x2
+#define DRAW_WARNED_TEXTURE         0x4
+#define DRAW_WARNED_MATERIAL        0x8
 
 //#pragma GCC diagnostic push
 //#pragma GCC diagnostic ignored "-Wunused-result"
 
 glcWavefrontObject::glcWavefrontObject()
 {
-    this->model = NULL;
-    this->modelList = NULL;
-    this->numberOfObjects = 1;
-
     this->shading = FLAT_SHADING;
     this->render  = USE_COLOR;
 
@@ -22,46 +48,137 @@ glcWavefrontObject::glcWavefrontObject()
     this->color[1] = 0.5;
     this->color[2] = 0.0;
     this->color[3] = 1.0;
+
+    // Convex hull generation is disabled by default
+    this->hullMaxVertices = 0;
+    this->hullCount = 1;
+
+    // Processed meshes are cached by default
+    this->cacheEnabled = true;
+
+    // Clusters outside the view are skipped by default
+    this->clusterCulling = true;
+
+    this->weldEnabled = false;
+    this->weldEpsilon = 0.0;
+
+    this->quantizeEnabled = false;
 }
 
 glcWavefrontObject::~glcWavefrontObject()
 {
-    if(this->model && this->numberOfObjects == 1)
-        delete this->model;
-    else if(this->model && this->numberOfObjects > 1)
-        delete [] this->model;
 }
 
 //-----------------------------------------------------------
-void glcWavefrontObject::SetNumberOfObjects(int n)
+int glcWavefrontObject::AddModel(GLMmodel* model)
+{
+    std::shared_ptr<GLMmodel> modelRef(model, DeleteModel);
+    std::lock_guard<std::mutex> lock(modelMutex);
+    int handle;
+
+    /* handles of unloaded objects are reused before the list grows */
+    if (!freeHandles.empty())
+    {
+        handle = freeHandles.back();
+        freeHandles.pop_back();
+        modelList[handle] = modelRef;
+    }
+    else
+    {
+        handle = modelList.size();
+        modelList.push_back(modelRef);
+    }
+
+    return handle;
+}
+
+//-----------------------------------------------------------
+std::shared_ptr<GLMmodel> glcWavefrontObject::GetModel(int handle)
+{
+    std::lock_guard<std::mutex> lock(modelMutex);
+
+    if (handle < 0 || handle >= (int)modelList.size() || !modelList[handle])
+        throw std::invalid_argument("glcWavefrontObject: invalid object handle.");
+
+    return modelList[handle];
+}
+
+//-----------------------------------------------------------
+void glcWavefrontObject::UnloadObject(int handle)
 {
-    this->numberOfObjects = n;
+    std::shared_ptr<GLMmodel> modelRef;
 
-    this->modelList = new GLMmodel[n];
+    {
+        std::lock_guard<std::mutex> lock(modelMutex);
+
+        if (handle < 0 || handle >= (int)modelList.size() || !modelList[handle])
+            throw std::invalid_argument("glcWavefrontObject: invalid object handle.");
+
+        modelRef.swap(modelList[handle]);
+        freeHandles.push_back(handle);
+    }
+
+    /* the model is deleted here, or by the last call still using it */
 }
 
 //-----------------------------------------------------------
 int glcWavefrontObject::GetNumberOfObjects()
 {
-    return this->numberOfObjects;
+    std::lock_guard<std::mutex> lock(modelMutex);
+
+    return modelList.size() - freeHandles.size();
 }
 
 //-----------------------------------------------------------
-void  glcWavefrontObject::SelectObject(int obj)
+int glcWavefrontObject::GetNumberOfVertices(int handle)
 {
-    this->model = &modelList[obj];
+    return GetModel(handle)->numvertices;
 }
 
 //-----------------------------------------------------------
-int glcWavefrontObject::GetNumberOfVertices()
+int glcWavefrontObject::GetNumberOfTriangles(int handle)
 {
-    return this->model->numvertices;
+    return GetModel(handle)->numtriangles;
 }
 
 //-----------------------------------------------------------
-int glcWavefrontObject::GetNumberOfTriangles()
+int glcWavefrontObject::GetNumberOfDrawnTriangles(int handle)
 {
-    return this->model->numtriangles;
+    return GetModel(handle)->numdrawntriangles;
+}
+
+//-----------------------------------------------------------
+int glcWavefrontObject::GetNumberOfWeldedVertices(int handle)
+{
+    return GetModel(handle)->numweldedvertices;
+}
+
+//-----------------------------------------------------------
+GLuint glcWavefrontObject::GetVertexDataSize(int handle)
+{
+    std::shared_ptr<GLMmodel> modelRef = GetModel(handle);
+    GLMmodel* model = modelRef.get();
+
+    if (model->qvertices)
+        return sizeof(GLshort) * (3 * (model->numvertices + 1) +
+                                  (model->qnormals ? 2 * (model->numnormals + 1) : 0) +
+                                  (model->qtexcoords ? 2 * (model->numtexcoords + 1) : 0) +
+                                  (model->qfacetnorms ? 2 * (model->numfacetnorms + 1) : 0));
+
+    return sizeof(GLfloat) * ((model->vertices ? 3 * (model->numvertices + 1) : 0) +
+                              (model->normals ? 3 * (model->numnormals + 1) : 0) +
+                              (model->texcoords ? 2 * (model->numtexcoords + 1) : 0) +
+                              (model->facetnorms ? 3 * (model->numfacetnorms + 1) : 0));
+}
+
+//-----------------------------------------------------------
+void glcWavefrontObject::GetACMR(int handle, GLfloat* acmr)
+{
+    std::shared_ptr<GLMmodel> modelRef = GetModel(handle);
+    GLMmodel* model = modelRef.get();
+
+    acmr[0] = model->acmr[0];
+    acmr[1] = model->acmr[1];
 }
 
 //-----------------------------------------------------------
@@ -102,25 +219,67 @@ void  glcWavefrontObject::SetColor(float r, float g, float b, float a)
 }
 
 //-----------------------------------------------------------
-void glcWavefrontObject::ReadObject(const char *filename)
+int glcWavefrontObject::LoadObject(const char *filename)
 {
-    FILE*   file;
+    GLMmodel* model = NewModel(filename);
 
-    /* open the file */
-    file = fopen(filename, "r");
-    if (!file)
+    try
     {
-        fprintf(stderr, "glmReadOBJ() failed: can't open data file \"%s\".\n",
-                filename);
-        exit(1);
+        ReadObject(model, filename);
+        if (quantizeEnabled)
+            QuantizeModel(model);
+    }
+    catch (...)
+    {
+        DeleteModel(model);
+        throw;
     }
 
-    /* allocate a new model */
+    return AddModel(model);
+}
+
+//-----------------------------------------------------------
+void glcWavefrontObject::ReadObject(GLMmodel* model, const char *filename)
+{
+    std::unique_ptr<MappedFile> file;
+
+    /* map the file */
+    try
+    {
+        file.reset(new MappedFile(filename));
+    }
+    catch (std::exception&)
+    {
+        std::string message = std::string("glcWavefrontObject::ReadObject(): Can't open data file \"") + filename + "\".";
+        throw std::runtime_error(message);
+    }
+
+    /* read the vertices, normals, texcoords, groups & triangles in a single pass */
+    ParseOBJ(model, file->getData(), file->getSize());
+
+    /* merge the repeated vertices before anything that depends on the topology */
+    if(weldEnabled)
+        WeldVertices(model);
+
+    /* generate the collision proxies */
+    if(hullMaxVertices > 0)
+        BuildConvexHulls(model);
+
+    /* split the groups in clusters for the culling, and order the triangles
+       and vertices for the vertex cache */
+    BuildClusters(model);
+    OptimizeVertexFetch(model);
+}
 
-    if(numberOfObjects == 1)
-        this->model = (GLMmodel*) malloc(sizeof(GLMmodel));
+//-----------------------------------------------------------
+GLMmodel* glcWavefrontObject::NewModel(const char *filename)
+{
+    GLMmodel* model;
+
+    /* allocate a new model */
+    model = (GLMmodel*) malloc(sizeof(GLMmodel));
 
-    this->model->pathname     = strdup(filename);
+    model->pathname     = strdup(filename);
     model->mtllibname   = NULL;
     model->numvertices  = 0;
     model->vertices     = NULL;
@@ -136,40 +295,622 @@ void glcWavefrontObject::ReadObject(const char *filename)
     model->materials       = NULL;
     model->numgroups       = 0;
     model->groups      = NULL;
+    model->numclusters   = 0;
+    model->clusters      = NULL;
+    model->numhulls      = 0;
+    model->hulls         = NULL;
     model->position[0]   = 0.0;
     model->position[1]   = 0.0;
     model->position[2]   = 0.0;
+    for (int i = 0; i < 6; i++)
+        model->boundingbox[i] = 0.0;
+    model->drawwarnings  = 0;
+    model->numdrawntriangles = 0;
+    model->acmr[0]       = 0.0;
+    model->acmr[1]       = 0.0;
+    model->numweldedvertices = 0;
+    model->qvertices     = NULL;
+    model->qnormals      = NULL;
+    model->qtexcoords    = NULL;
+    model->qfacetnorms   = NULL;
+    for (int i = 0; i < 3; i++)
+    {
+        model->qoffset[i] = 0.0;
+        model->qscale[i]  = 1.0;
+    }
+    for (int i = 0; i < 2; i++)
+    {
+        model->qtexoffset[i] = 0.0;
+        model->qtexscale[i]  = 1.0;
+    }
+
+    return model;
+}
+
+//-----------------------------------------------------------
+void glcWavefrontObject::DeleteModel(GLMmodel* model)
+{
+    GLMgroup* group;
+    GLuint i;
+
+    free(model->pathname);
+    free(model->mtllibname);
+    free(model->vertices);
+    free(model->normals);
+    free(model->texcoords);
+    free(model->facetnorms);
+    free(model->triangles);
+    free(model->qvertices);
+    free(model->qnormals);
+    free(model->qtexcoords);
+    free(model->qfacetnorms);
+
+    for (i = 0; i < model->nummaterials; i++)
+    {
+        free(model->materials[i].name);
+        free(model->materials[i].map_diffuse);
+    }
+    free(model->materials);
+
+    while (model->groups)
+    {
+        group = model->groups;
+        model->groups = group->next;
+        free(group->name);
+        free(group->triangles);
+        free(group);
+    }
+
+    free(model->clusters);
+
+    for (i = 0; i < model->numhulls; i++)
+        delete model->hulls[i];
+    free(model->hulls);
+
+    free(model);
+}
+
+//-----------------------------------------------------------
+void glcWavefrontObject::SetConvexHullGeneration(int maxVertices, int hullCount)
+{
+    this->hullMaxVertices = maxVertices;
+    this->hullCount = hullCount;
+}
+
+//-----------------------------------------------------------
+int glcWavefrontObject::GetNumberOfConvexHulls(int handle)
+{
+    return GetModel(handle)->numhulls;
+}
+
+//-----------------------------------------------------------
+ConvexHull* glcWavefrontObject::GetConvexHull(int handle, int index)
+{
+    return GetModel(handle)->hulls[index];
+}
+
+//-----------------------------------------------------------
+void glcWavefrontObject::BuildConvexHulls(GLMmodel* model)
+{
+    GLuint i, j;
+
+    assert(model);
+    assert(model->vertices);
+
+    /* gather the triangle soup used by the hull generator */
+    std::vector<double> triangleList;
+    triangleList.reserve(9 * model->numtriangles);
+
+    for (i = 0; i < model->numtriangles; i++)
+    {
+        for (j = 0; j < 3; j++)
+        {
+            GLfloat* v = &model->vertices[3 * T(i).vindices[j]];
+            triangleList.push_back(v[0]);
+            triangleList.push_back(v[1]);
+            triangleList.push_back(v[2]);
+        }
+    }
+
+    std::vector<ConvexHull*> hullList = ConvexHull::fromTriangles(triangleList, hullMaxVertices, hullCount);
+
+    model->numhulls = hullList.size();
+    model->hulls = (ConvexHull**)malloc(sizeof(ConvexHull*) * (model->numhulls + 1));
+
+    for (i = 0; i < model->numhulls; i++)
+        model->hulls[i] = hullList[i];
+}
+
+//-----------------------------------------------------------
+void glcWavefrontObject::SetVertexWelding(bool enabled, GLfloat epsilon)
+{
+    this->weldEnabled = enabled;
+    this->weldEpsilon = epsilon;
+}
+
+//-----------------------------------------------------------
+/* WeldVertices: merges the vertices closer than the welding epsilon (scaled to
+   the model's size) and drops the triangles that collapse */
+void glcWavefrontObject::WeldVertices(GLMmodel* model)
+{
+    std::vector<GLuint> remap, triangleremap;
+    GLfloat extent = 0.0;
+    GLuint i, j, k, n;
+
+    for (k = 0; k < 3; k++)
+        extent = std::max(extent, (model->boundingbox[k + 3] - model->boundingbox[k]) / 2.0f);
+
+    n = VertexWelder::weld(&model->vertices[3], model->numvertices, weldEpsilon * extent, remap);
+    model->numweldedvertices = model->numvertices - n;
+    if (n == model->numvertices)
+        return;
+
+    /* the first vertex of each welded set is kept, and the kept ones keep their order */
+    for (i = 0, n = 0; i < model->numvertices; i++)
+    {
+        if (remap[i] == n)
+        {
+            for (k = 0; k < 3; k++)
+                model->vertices[3 * (n + 1) + k] = model->vertices[3 * (i + 1) + k];
+            n++;
+        }
+    }
+    model->numvertices = n;
+
+    /* remap the triangles, keeping the ones with three distinct vertices */
+    triangleremap.assign(model->numtriangles, 0xFFFFFFFF);
+    for (i = 0, n = 0; i < model->numtriangles; i++)
+    {
+        GLMtriangle* triangle = &T(i);
+        for (j = 0; j < 3; j++)
+            triangle->vindices[j] = remap[triangle->vindices[j] - 1] + 1;
+
+        if (triangle->vindices[0] != triangle->vindices[1] &&
+            triangle->vindices[1] != triangle->vindices[2] &&
+            triangle->vindices[2] != triangle->vindices[0])
+        {
+            T(n) = *triangle;
+            triangleremap[i] = n++;
+        }
+    }
+    model->numtriangles = n;
+
+    for (GLMgroup* group = model->groups; group; group = group->next)
+    {
+        for (i = 0, n = 0; i < group->numtriangles; i++)
+        {
+            if (triangleremap[group->triangles[i]] != 0xFFFFFFFF)
+                group->triangles[n++] = triangleremap[group->triangles[i]];
+        }
+        group->numtriangles = n;
+    }
+}
+
+//-----------------------------------------------------------
+void glcWavefrontObject::SetVertexQuantization(bool enabled)
+{
+    this->quantizeEnabled = enabled;
+}
+
+//-----------------------------------------------------------
+/* QuantizeModel: replaces the vertices, normals, texcoords and facet normals
+   with their compact formats. The positions move by up to half a step on each
+   axis, so the cluster spheres grow by that much to keep the culling conservative */
+void glcWavefrontObject::QuantizeModel(GLMmodel* model)
+{
+    GLuint i;
+    GLfloat error;
+
+    if (model->qvertices || !model->vertices)
+        return;
+
+    /* the arrays keep the unused first element of the float ones */
+    model->qvertices = (GLshort*)calloc(3 * (model->numvertices + 1), sizeof(GLshort));
+    VertexQuantizer::quantize(&model->vertices[3], model->numvertices, 3, true,
+                              &model->qvertices[3], model->qoffset, model->qscale);
+    free(model->vertices);
+    model->vertices = NULL;
+
+    error = sqrt(3.0) / 2.0 * model->qscale[0];
+    for (i = 0; i < model->numclusters; i++)
+        model->clusters[i].radius += error;
+
+    if (model->normals)
+    {
+        model->qnormals = (GLshort*)calloc(2 * (model->numnormals + 1), sizeof(GLshort));
+        for (i = 1; i <= model->numnormals; i++)
+            VertexQuantizer::encodeOctahedral(&model->normals[3 * i], &model->qnormals[2 * i]);
+        free(model->normals);
+        model->normals = NULL;
+    }
+
+    if (model->texcoords)
+    {
+        model->qtexcoords = (GLshort*)calloc(2 * (model->numtexcoords + 1), sizeof(GLshort));
+        VertexQuantizer::quantize(&model->texcoords[2], model->numtexcoords, 2, false,
+                                  &model->qtexcoords[2], model->qtexoffset, model->qtexscale);
+        free(model->texcoords);
+        model->texcoords = NULL;
+    }
+
+    if (model->facetnorms)
+    {
+        model->qfacetnorms = (GLshort*)calloc(2 * (model->numfacetnorms + 1), sizeof(GLshort));
+        for (i = 1; i <= model->numfacetnorms; i++)
+            VertexQuantizer::encodeOctahedral(&model->facetnorms[3 * i], &model->qfacetnorms[2 * i]);
+        free(model->facetnorms);
+        model->facetnorms = NULL;
+    }
+}
+
+//-----------------------------------------------------------
+/* DequantizeModel: restores the float arrays of a quantized model */
+void glcWavefrontObject::DequantizeModel(GLMmodel* model)
+{
+    GLuint i;
+
+    if (!model->qvertices)
+        return;
+
+    model->vertices = (GLfloat*)calloc(3 * (model->numvertices + 1), sizeof(GLfloat));
+    VertexQuantizer::dequantize(&model->qvertices[3], model->numvertices, 3,
+                                model->qoffset, model->qscale, &model->vertices[3]);
+    free(model->qvertices);
+    model->qvertices = NULL;
+
+    if (model->qnormals)
+    {
+        model->normals = (GLfloat*)calloc(3 * (model->numnormals + 1), sizeof(GLfloat));
+        for (i = 1; i <= model->numnormals; i++)
+            VertexQuantizer::decodeOctahedral(&model->qnormals[2 * i], &model->normals[3 * i]);
+        free(model->qnormals);
+        model->qnormals = NULL;
+    }
 
-    /* make a first pass through the file to get a count of the number
-    of vertices, normals, texcoords & triangles */
-    FirstPass(file);
+    if (model->qtexcoords)
+    {
+        model->texcoords = (GLfloat*)calloc(2 * (model->numtexcoords + 1), sizeof(GLfloat));
+        VertexQuantizer::dequantize(&model->qtexcoords[2], model->numtexcoords, 2,
+                                    model->qtexoffset, model->qtexscale, &model->texcoords[2]);
+        free(model->qtexcoords);
+        model->qtexcoords = NULL;
+    }
 
-    /* allocate memory */
-    model->vertices = (GLfloat*)malloc(sizeof(GLfloat) * 3 * (model->numvertices + 1));
-    model->triangles = (GLMtriangle*)malloc(sizeof(GLMtriangle) * model->numtriangles);
-    if (model->numnormals)
+    if (model->qfacetnorms)
     {
-        model->normals = (GLfloat*)malloc(sizeof(GLfloat) * 3 * (model->numnormals + 1));
+        model->facetnorms = (GLfloat*)calloc(3 * (model->numfacetnorms + 1), sizeof(GLfloat));
+        for (i = 1; i <= model->numfacetnorms; i++)
+            VertexQuantizer::decodeOctahedral(&model->qfacetnorms[2 * i], &model->facetnorms[3 * i]);
+        free(model->qfacetnorms);
+        model->qfacetnorms = NULL;
     }
-    if (model->numtexcoords)
+}
+
+//-----------------------------------------------------------
+/* SpreadBits: inserts two zero bits between the 10 low bits of x (for Morton codes) */
+static GLuint SpreadBits(GLuint x)
+{
+    x &= 0x3FF;
+    x = (x | (x << 16)) & 0x030000FF;
+    x = (x | (x << 8))  & 0x0300F00F;
+    x = (x | (x << 4))  & 0x030C30C3;
+    x = (x | (x << 2))  & 0x09249249;
+    return x;
+}
+
+//-----------------------------------------------------------
+/* BuildClusters: sorts the triangles of each group along a Morton curve of
+   their centroids and splits the sorted array in runs of CLUSTER_SIZE
+   triangles, which are therefore spatially coherent */
+void glcWavefrontObject::BuildClusters(GLMmodel* model)
+{
+    GLMgroup* group;
+    GLMcluster* cluster;
+    GLfloat extent[3];
+    GLuint i, j, k, n;
+    std::vector< std::pair<GLuint, GLuint> > order;
+    std::vector<GLuint> indices, local(model->numvertices + 1, 0xFFFFFFFF);
+
+    DrawOrderIndices(model, indices);
+    model->acmr[0] = VertexCacheOptimizer::getACMR(indices.data(), indices.size(), model->numvertices);
+
+    free(model->clusters);
+    model->numclusters = 0;
+    for (group = model->groups; group; group = group->next)
+        model->numclusters += (group->numtriangles + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+    model->clusters = (GLMcluster*)malloc(sizeof(GLMcluster) * (model->numclusters + 1));
+
+    for (k = 0; k < 3; k++)
     {
-        model->texcoords = (GLfloat*)malloc(sizeof(GLfloat) * 2 * (model->numtexcoords + 1));
+        extent[k] = model->boundingbox[k + 3] - model->boundingbox[k];
+        if (!(extent[k] > 0.0))
+            extent[k] = 1.0;
     }
 
-    /* rewind to beginning of file and read in the data this pass */
-    rewind(file);
+    n = 0;
+    for (group = model->groups; group; group = group->next)
+    {
+        order.resize(group->numtriangles);
+        for (i = 0; i < group->numtriangles; i++)
+        {
+            GLMtriangle* triangle = &T(group->triangles[i]);
+            GLuint code = 0;
+
+            for (k = 0; k < 3; k++)
+            {
+                GLfloat centroid = 0.0;
+                for (j = 0; j < 3; j++)
+                    centroid += model->vertices[3 * triangle->vindices[j] + k];
+                centroid = (centroid / 3.0 - model->boundingbox[k]) / extent[k];
+
+                if (!(centroid > 0.0))
+                    centroid = 0.0;
+                if (centroid > 1.0)
+                    centroid = 1.0;
+                code |= SpreadBits((GLuint)(centroid * 1023.0)) << k;
+            }
+            order[i] = std::make_pair(code, group->triangles[i]);
+        }
 
-    SecondPass(file);
+        std::sort(order.begin(), order.end());
+        for (i = 0; i < group->numtriangles; i++)
+            group->triangles[i] = order[i].second;
 
-    /* close the file */
-    fclose(file);
+        group->firstcluster = n;
+        group->numclusters = 0;
+        for (i = 0; i < group->numtriangles; i += CLUSTER_SIZE)
+        {
+            cluster = &model->clusters[n++];
+            cluster->first = i;
+            cluster->count = std::min<GLuint>(CLUSTER_SIZE, group->numtriangles - i);
+            ComputeClusterBounds(model, group, cluster);
+            OptimizeClusterOrder(model, group, cluster, local);
+            group->numclusters++;
+        }
+    }
 
-    /* compute the bounding box */
-    ComputeBoundingBox();
+    DrawOrderIndices(model, indices);
+    model->acmr[1] = VertexCacheOptimizer::getACMR(indices.data(), indices.size(), model->numvertices);
+}
+
+//-----------------------------------------------------------
+/* OptimizeClusterOrder: reorders the triangles of a cluster for the vertex
+   cache (Forsyth), which keeps its bounds. local must have numvertices + 1
+   entries set to 0xFFFFFFFF, and is left that way */
+void glcWavefrontObject::OptimizeClusterOrder(GLMmodel* model, GLMgroup* group, GLMcluster* cluster, std::vector<GLuint>& local)
+{
+    std::vector<GLuint> indices(3 * cluster->count), vertices, order, triangles;
+    GLuint i, j;
+
+    /* the cluster's vertices are renumbered so the optimizer's tables stay small */
+    for (i = 0; i < cluster->count; i++)
+    {
+        GLMtriangle* triangle = &T(group->triangles[cluster->first + i]);
+        for (j = 0; j < 3; j++)
+        {
+            GLuint v = triangle->vindices[j];
+            if (local[v] == 0xFFFFFFFF)
+            {
+                local[v] = vertices.size();
+                vertices.push_back(v);
+            }
+            indices[3 * i + j] = local[v];
+        }
+    }
+
+    VertexCacheOptimizer::optimizeTriangleOrder(indices.data(), indices.size(), vertices.size(), order);
+
+    triangles.assign(&group->triangles[cluster->first], &group->triangles[cluster->first + cluster->count]);
+    for (i = 0; i < cluster->count; i++)
+        group->triangles[cluster->first + i] = triangles[order[i]];
+
+    for (i = 0; i < vertices.size(); i++)
+        local[vertices[i]] = 0xFFFFFFFF;
+}
+
+//-----------------------------------------------------------
+/* OptimizeVertexFetch: stores the triangles in the order Draw submits them
+   and renumbers the vertices by their first use, so Draw walks both arrays
+   almost sequentially */
+void glcWavefrontObject::OptimizeVertexFetch(GLMmodel* model)
+{
+    GLMgroup* group;
+    GLMtriangle* triangles;
+    std::vector<GLuint> indices, remap;
+    GLuint i, j, n;
+
+    if (!model->numtriangles)
+        return;
+
+    /* triangles, in draw order (a triangle outside the groups goes to the end) */
+    triangles = (GLMtriangle*)malloc(sizeof(GLMtriangle) * (model->numtriangles + 1));
+    remap.assign(model->numtriangles, 0xFFFFFFFF);
+    n = 0;
+    for (group = model->groups; group; group = group->next)
+    {
+        for (i = 0; i < group->numtriangles; i++)
+        {
+            if (remap[group->triangles[i]] == 0xFFFFFFFF)
+            {
+                triangles[n] = T(group->triangles[i]);
+                remap[group->triangles[i]] = n++;
+            }
+            group->triangles[i] = remap[group->triangles[i]];
+        }
+    }
+    for (i = 0; i < model->numtriangles; i++)
+    {
+        if (remap[i] == 0xFFFFFFFF)
+            triangles[n++] = T(i);
+    }
+    free(model->triangles);
+    model->triangles = triangles;
+
+    /* vertices, by first use (the indices are 1-based) */
+    DrawOrderIndices(model, indices);
+    VertexCacheOptimizer::optimizeVertexOrder(indices.data(), indices.size(), model->numvertices, remap);
+    for (i = 0; i < model->numtriangles; i++)
+    {
+        for (j = 0; j < 3; j++)
+            T(i).vindices[j] = remap[T(i).vindices[j] - 1] + 1;
+    }
+    VertexCacheOptimizer::remapAttribute(&model->vertices[3], remap, 3);
 }
 
 //-----------------------------------------------------------
-float glcWavefrontObject::Unitize()
+/* DrawOrderIndices: 0-based vertex indices of the triangles in the order Draw submits them */
+void glcWavefrontObject::DrawOrderIndices(GLMmodel* model, std::vector<GLuint>& indices)
+{
+    GLMgroup* group;
+    GLuint i, j;
+
+    indices.clear();
+    indices.reserve(3 * model->numtriangles);
+    for (group = model->groups; group; group = group->next)
+    {
+        for (i = 0; i < group->numtriangles; i++)
+        {
+            for (j = 0; j < 3; j++)
+                indices.push_back(T(group->triangles[i]).vindices[j] - 1);
+        }
+    }
+}
+
+//-----------------------------------------------------------
+/* ComputeClusterBounds: bounding sphere (centered in the bounding box) and
+   normal cone of a cluster. The cone's cutoff is the sine of the largest
+   angle between its axis and the facet normals, so the cluster faces away
+   from every direction closer than that to the axis */
+void glcWavefrontObject::ComputeClusterBounds(GLMmodel* model, GLMgroup* group, GLMcluster* cluster)
+{
+    GLfloat minv[3], maxv[3], sum[3] = { 0.0, 0.0, 0.0 };
+    GLfloat u[3], v[3], n[3], d[3];
+    GLfloat length, radius2 = 0.0, mindot = 1.0;
+    GLuint i, j, k;
+
+    for (k = 0; k < 3; k++)
+    {
+        minv[k] = model->vertices[3 * T(group->triangles[cluster->first]).vindices[0] + k];
+        maxv[k] = minv[k];
+    }
+
+    for (i = cluster->first; i < cluster->first + cluster->count; i++)
+    {
+        for (j = 0; j < 3; j++)
+        {
+            GLfloat* p = &model->vertices[3 * T(group->triangles[i]).vindices[j]];
+            for (k = 0; k < 3; k++)
+            {
+                minv[k] = std::min(minv[k], p[k]);
+                maxv[k] = std::max(maxv[k], p[k]);
+            }
+        }
+    }
+
+    for (k = 0; k < 3; k++)
+        cluster->center[k] = (minv[k] + maxv[k]) / 2.0;
+
+    for (i = cluster->first; i < cluster->first + cluster->count; i++)
+    {
+        GLMtriangle* triangle = &T(group->triangles[i]);
+        GLfloat* p0 = &model->vertices[3 * triangle->vindices[0]];
+        GLfloat* p1 = &model->vertices[3 * triangle->vindices[1]];
+        GLfloat* p2 = &model->vertices[3 * triangle->vindices[2]];
+
+        for (j = 0; j < 3; j++)
+        {
+            GLfloat* p = &model->vertices[3 * triangle->vindices[j]];
+            for (k = 0; k < 3; k++)
+                d[k] = p[k] - cluster->center[k];
+            radius2 = std::max(radius2, Dot(d, d));
+        }
+
+        for (k = 0; k < 3; k++)
+        {
+            u[k] = p1[k] - p0[k];
+            v[k] = p2[k] - p0[k];
+        }
+        Cross(u, v, n);
+        length = sqrt(Dot(n, n));
+        if (length > 0.0)
+        {
+            for (k = 0; k < 3; k++)
+                sum[k] += n[k] / length;
+        }
+    }
+
+    cluster->radius = sqrt(radius2);
+
+    /* the cone's axis is the average facet direction */
+    length = sqrt(Dot(sum, sum));
+    if (length > 0.0)
+    {
+        for (k = 0; k < 3; k++)
+            cluster->axis[k] = sum[k] / length;
+
+        for (i = cluster->first; i < cluster->first + cluster->count; i++)
+        {
+            GLMtriangle* triangle = &T(group->triangles[i]);
+            GLfloat* p0 = &model->vertices[3 * triangle->vindices[0]];
+            GLfloat* p1 = &model->vertices[3 * triangle->vindices[1]];
+            GLfloat* p2 = &model->vertices[3 * triangle->vindices[2]];
+
+            for (k = 0; k < 3; k++)
+            {
+                u[k] = p1[k] - p0[k];
+                v[k] = p2[k] - p0[k];
+            }
+            Cross(u, v, n);
+            length = sqrt(Dot(n, n));
+            if (length > 0.0)
+                mindot = std::min(mindot, Dot(n, cluster->axis) / length);
+        }
+    }
+    else
+    {
+        cluster->axis[0] = 0.0;
+        cluster->axis[1] = 0.0;
+        cluster->axis[2] = 1.0;
+        mindot = 0.0;
+    }
+
+    /* a cone of 90 degrees or more has faces towards every direction */
+    cluster->cutoff = (mindot > 0.0) ? sqrt(1.0 - mindot * mindot) : 1.0;
+}
+
+//-----------------------------------------------------------
+void glcWavefrontObject::TransformClusters(GLMmodel* model, const GLfloat* center, GLfloat unitscale, GLfloat scale)
+{
+    GLuint i, k;
+
+    /* same operations applied to the vertices; the cones don't change with a uniform scale */
+    for (i = 0; i < model->numclusters; i++)
+    {
+        for (k = 0; k < 3; k++)
+            model->clusters[i].center[k] = ((model->clusters[i].center[k] - (center ? center[k] : 0.0f)) * unitscale) * scale;
+        model->clusters[i].radius = (model->clusters[i].radius * unitscale) * scale;
+    }
+}
+
+//-----------------------------------------------------------
+float glcWavefrontObject::Unitize(int handle)
+{
+    std::shared_ptr<GLMmodel> modelRef = GetModel(handle);
+    GLMmodel* model = modelRef.get();
+    bool quantized = (model->qvertices != NULL);
+    float scale;
+
+    if (quantized)
+        DequantizeModel(model);
+    scale = Unitize(model);
+    if (quantized)
+        QuantizeModel(model);
+
+    return scale;
+}
+
+//-----------------------------------------------------------
+float glcWavefrontObject::Unitize(GLMmodel* model)
 {
     GLuint  i;
     GLfloat *maxx, *minx, *maxy, *miny, *maxz, *minz;
@@ -211,6 +952,16 @@ float glcWavefrontObject::Unitize()
         model->vertices[3 * i + 2] *= scale;
     }
 
+    /* keep the collision proxies and the clusters in the same space as the vertices */
+    for (i = 0; i < model->numhulls; i++)
+    {
+        model->hulls[i]->translate(-cx, -cy, -cz);
+        model->hulls[i]->scale(scale, scale, scale);
+    }
+
+    GLfloat center[3] = { cx, cy, cz };
+    TransformClusters(model, center, scale, 1.0);
+
     /* correct bounding box */
     (*minx) = scale * (*minx-cx);
     (*miny) = scale * (*miny-cy);
@@ -223,12 +974,14 @@ float glcWavefrontObject::Unitize()
 }
 
 //-----------------------------------------------------------
-void glcWavefrontObject::GetDimensions(GLfloat* dimensions)
+void glcWavefrontObject::GetDimensions(int handle, GLfloat* dimensions)
 {
+    std::shared_ptr<GLMmodel> modelRef = GetModel(handle);
+    GLMmodel* model = modelRef.get();
     GLfloat maxx, minx, maxy, miny, maxz, minz;
 
     assert(model);
-    assert(model->vertices);
+    assert(model->vertices || model->qvertices);
     assert(dimensions);
 
     /* recover bounding box from model */
@@ -246,7 +999,21 @@ void glcWavefrontObject::GetDimensions(GLfloat* dimensions)
 }
 
 //-----------------------------------------------------------
-void glcWavefrontObject::Scale(GLfloat scale)
+void glcWavefrontObject::Scale(int handle, GLfloat scale)
+{
+    std::shared_ptr<GLMmodel> modelRef = GetModel(handle);
+    GLMmodel* model = modelRef.get();
+    bool quantized = (model->qvertices != NULL);
+
+    if (quantized)
+        DequantizeModel(model);
+    Scale(model, scale);
+    if (quantized)
+        QuantizeModel(model);
+}
+
+//-----------------------------------------------------------
+void glcWavefrontObject::Scale(GLMmodel* model, GLfloat scale)
 {
     GLuint i;
 
@@ -259,53 +1026,521 @@ void glcWavefrontObject::Scale(GLfloat scale)
 
     for(i = 0; i < 6; i++)
         model->boundingbox[i] *= scale;
+
+    for(i = 0; i < model->numhulls; i++)
+        model->hulls[i]->scale(scale, scale, scale);
+
+    TransformClusters(model, NULL, 1.0, scale);
 }
 
 //-----------------------------------------------------------
-void glcWavefrontObject::ComputeBoundingBox()
+// Cached model summary, stored in the MESH_CACHE_HEADER block
+struct GLMcachedmodel
 {
-    GLuint i;
-    GLfloat maxx, minx, maxy, miny, maxz, minz;
+    GLuint numvertices;
+    GLuint numnormals;
+    GLuint numtexcoords;
+    GLuint numfacetnorms;
+    GLuint numtriangles;
+    GLuint nummaterials;
+    GLuint numgroups;
+    GLuint numhulls;
+    GLuint mtllibname;            /* offset in the names block (NO_CACHED_NAME if none) */
+    GLuint mtllibnamelength;
+    GLfloat acmr[2];
+    GLuint numweldedvertices;
+};
+
+// Cached group, stored in list order (its triangles follow in MESH_CACHE_GROUP_TRIANGLE)
+struct GLMcachedgroup
+{
+    GLuint numtriangles;
+    GLuint numclusters;           /* its clusters follow in MESH_CACHE_CLUSTER */
+    GLuint material;
+    GLuint name;
+    GLuint namelength;
+};
+
+// Cached material
+struct GLMcachedmaterial
+{
+    GLfloat diffuse[4];
+    GLfloat ambient[4];
+    GLfloat specular[4];
+    GLfloat emmissive[4];
+    GLfloat shininess;
+    GLuint name;
+    GLuint namelength;
+    GLuint mapdiffuse;            /* offset in the names block (NO_CACHED_NAME if none) */
+    GLuint mapdiffuselength;
+};
+
+#define NO_CACHED_NAME 0xFFFFFFFF
+
+//-----------------------------------------------------------
+void glcWavefrontObject::SetCacheEnabled(bool enabled)
+{
+    this->cacheEnabled = enabled;
+}
+
+//-----------------------------------------------------------
+void glcWavefrontObject::SetClusterCulling(bool enabled)
+{
+    this->clusterCulling = enabled;
+}
+
+//-----------------------------------------------------------
+int glcWavefrontObject::LoadProcessedObject(const char *filename, GLfloat angle, GLfloat scale)
+{
+    return LoadProcessedObject(filename, GLMprocessing(scale, angle));
+}
+
+//-----------------------------------------------------------
+int glcWavefrontObject::LoadProcessedObject(const char *filename, const GLMprocessing& processing)
+{
+    GLMmodel* model = NewModel(filename);
+
+    try
+    {
+        /* the cache keeps the float buffers, so the quantization doesn't change it */
+        ReadProcessedObject(model, filename, processing);
+        if (quantizeEnabled)
+            QuantizeModel(model);
+    }
+    catch (...)
+    {
+        DeleteModel(model);
+        throw;
+    }
+
+    return AddModel(model);
+}
+
+//-----------------------------------------------------------
+void glcWavefrontObject::ReadProcessedObject(GLMmodel* model, const char *filename, const GLMprocessing& processing)
+{
+    char settings[192];
+    snprintf(settings, sizeof(settings), "obj unitize=%d scale=%.9g normals=%d%d angle=%.9g hulls=%dx%d weld=%.9g",
+             processing.unitize, processing.scale, processing.facetnormals, processing.vertexnormals,
+             processing.angle, hullMaxVertices > 0 ? hullMaxVertices : 0, hullCount,
+             weldEnabled ? weldEpsilon : -1.0);
+
+    MeshCache cache(filename, settings);
+
+    /* warm start: the processed buffers are copied straight from the cache */
+    if (cacheEnabled && cache.load() && ReadCachedObject(model, cache))
+        return;
+
+    ReadObject(model, filename);
+    ProcessObject(model, processing);
+
+    if (cacheEnabled)
+        SaveCachedObject(model, cache);
+}
+
+//-----------------------------------------------------------
+void glcWavefrontObject::ProcessObject(GLMmodel* model, const GLMprocessing& processing)
+{
+    GLfloat center[3] = { 0.0, 0.0, 0.0 };
+    GLfloat unitscale = 1.0;
+    GLfloat scale = processing.scale;
+    GLfloat* bounds = model->boundingbox;
+    int numranges;
+    int i;
 
-    assert(model);
     assert(model->vertices);
 
-    /* get the max/mins */
-    maxx = minx = model->vertices[3 + 0];
-    maxy = miny = model->vertices[3 + 1];
-    maxz = minz = model->vertices[3 + 2];
-    for (i = 1; i <= model->numvertices; i++)
+    /* the bounding box is computed while the file is read, so the unitizing
+    transform is known before the vertices are touched */
+    if (processing.unitize)
     {
-        if (maxx < model->vertices[3 * i + 0])
-            maxx = model->vertices[3 * i + 0];
-        if (minx > model->vertices[3 * i + 0])
-            minx = model->vertices[3 * i + 0];
+        for (i = 0; i < 3; i++)
+            center[i] = (bounds[i + 3] + bounds[i]) / 2.0;
+        unitscale = 1.0 / Max(Max(Abs(bounds[3] - bounds[0]), Abs(bounds[4] - bounds[1])), Abs(bounds[5] - bounds[2]));
+    }
 
-        if (maxy < model->vertices[3 * i + 1])
-            maxy = model->vertices[3 * i + 1];
-        if (miny > model->vertices[3 * i + 1])
-            miny = model->vertices[3 * i + 1];
+    /* unitize and scale in a single pass over the vertices, split in parallel ranges */
+    if (processing.unitize || scale != 1.0)
+    {
+        numranges = ParallelRanges(model->numvertices);
+        ThreadPool::getSharedPool().run(numranges, [&](int range)
+        {
+            GLfloat* v = &model->vertices[3 * (RangeStart(model->numvertices, numranges, range) + 1)];
+            GLfloat* end = &model->vertices[3 * (RangeStart(model->numvertices, numranges, range + 1) + 1)];
+
+            for (; v < end; v += 3)
+            {
+                v[0] = ((v[0] - center[0]) * unitscale) * scale;
+                v[1] = ((v[1] - center[1]) * unitscale) * scale;
+                v[2] = ((v[2] - center[2]) * unitscale) * scale;
+            }
+        });
+
+        for (i = 0; i < 6; i++)
+            bounds[i] = (unitscale * (bounds[i] - center[i % 3])) * scale;
 
-        if (maxz < model->vertices[3 * i + 2])
-            maxz = model->vertices[3 * i + 2];
-        if (minz > model->vertices[3 * i + 2])
-            minz = model->vertices[3 * i + 2];
+        /* keep the collision proxies in the same space as the vertices */
+        for (i = 0; i < (int)model->numhulls; i++)
+        {
+            model->hulls[i]->translate(-center[0], -center[1], -center[2]);
+            model->hulls[i]->scale(unitscale, unitscale, unitscale);
+            model->hulls[i]->scale(scale, scale, scale);
+        }
+
+        TransformClusters(model, center, unitscale, scale);
     }
 
-    model->boundingbox[0] = minx;
-    model->boundingbox[3] = maxx;
-    model->boundingbox[1] = miny;
-    model->boundingbox[4] = maxy;
-    model->boundingbox[2] = minz;
-    model->boundingbox[5] = maxz;
+    if (processing.facetnormals || processing.vertexnormals)
+        FacetNormal(model);
+    if (processing.vertexnormals)
+        VertexNormals(model, processing.angle);
 }
 
 //-----------------------------------------------------------
-void glcWavefrontObject::FacetNormal()
+void glcWavefrontObject::LoadProcessedObjects(int count, const char **filenames, GLfloat angle, const GLfloat *scales, int *handles)
 {
-    GLuint  i;
-    GLfloat u[3];
-    GLfloat v[3];
+    int i;
+
+    for (i = 0; i < count; i++)
+        handles[i] = -1;
+
+    /* the loads are independent, so each one runs as a task of the pool */
+    try
+    {
+        ThreadPool::getSharedPool().run(count, [&](int i)
+        {
+            handles[i] = LoadProcessedObject(filenames[i], angle, scales[i]);
+        });
+    }
+    catch (...)
+    {
+        /* nothing stays loaded if any of the objects fails */
+        for (i = 0; i < count; i++)
+        {
+            if (handles[i] >= 0)
+                UnloadObject(handles[i]);
+            handles[i] = -1;
+        }
+        throw;
+    }
+}
+
+//-----------------------------------------------------------
+bool glcWavefrontObject::ReadCachedObject(GLMmodel* model, MeshCache &cache)
+{
+    size_t count, size, i;
+    GLuint j;
+
+    const GLMcachedmodel* header = cache.getBlock<GLMcachedmodel>(MESH_CACHE_HEADER, count);
+    if (!header || count != 1)
+        return false;
+
+    size_t numvertices, numnormals, numtexcoords, numfacetnorms, numtriangles;
+    size_t nummaterials, numgroups, numgrouptriangles, numnames, numbounds, numhullsizes, numhullvertices, numclusters;
+
+    const GLfloat* vertices = cache.getBlock<GLfloat>(MESH_CACHE_POSITION, numvertices);
+    const GLfloat* normals = cache.getBlock<GLfloat>(MESH_CACHE_NORMAL, numnormals);
+    const GLfloat* texcoords = cache.getBlock<GLfloat>(MESH_CACHE_TEXCOORD, numtexcoords);
+    const GLfloat* facetnorms = cache.getBlock<GLfloat>(MESH_CACHE_FACET_NORMAL, numfacetnorms);
+    const GLMtriangle* triangles = cache.getBlock<GLMtriangle>(MESH_CACHE_TRIANGLE, numtriangles);
+    const GLMcachedmaterial* materials = cache.getBlock<GLMcachedmaterial>(MESH_CACHE_MATERIAL, nummaterials);
+    const GLMcachedgroup* groups = cache.getBlock<GLMcachedgroup>(MESH_CACHE_GROUP, numgroups);
+    const GLuint* grouptriangles = cache.getBlock<GLuint>(MESH_CACHE_GROUP_TRIANGLE, numgrouptriangles);
+    const char* names = cache.getBlock<char>(MESH_CACHE_NAME, numnames);
+    const GLfloat* bounds = cache.getBlock<GLfloat>(MESH_CACHE_BOUNDS, numbounds);
+    const GLuint* hullsizes = cache.getBlock<GLuint>(MESH_CACHE_HULL_SIZE, numhullsizes);
+    const double* hullvertices = cache.getBlock<double>(MESH_CACHE_HULL_VERTEX, numhullvertices);
+    const GLMcluster* clusters = cache.getBlock<GLMcluster>(MESH_CACHE_CLUSTER, numclusters);
+
+    /* check the block sizes against the summary before touching the model */
+    if (numvertices != 3 * (size_t)(header->numvertices + 1) ||
+        numnormals != (header->numnormals ? 3 * (size_t)(header->numnormals + 1) : 0) ||
+        numtexcoords != (header->numtexcoords ? 2 * (size_t)(header->numtexcoords + 1) : 0) ||
+        numfacetnorms != (header->numfacetnorms ? 3 * (size_t)(header->numfacetnorms + 1) : 0) ||
+        numtriangles != header->numtriangles ||
+        nummaterials != header->nummaterials ||
+        numgroups != header->numgroups ||
+        numhullsizes != header->numhulls ||
+        numbounds != 6)
+        return false;
+
+    for (i = 0; i < numtriangles; i++)
+    {
+        for (j = 0; j < 3; j++)
+        {
+            if (triangles[i].vindices[j] > header->numvertices ||
+                (header->numnormals && triangles[i].nindices[j] > header->numnormals) ||
+                (header->numtexcoords && triangles[i].tindices[j] > header->numtexcoords))
+                return false;
+        }
+        if (header->numfacetnorms && triangles[i].findex > header->numfacetnorms)
+            return false;
+    }
+
+    size = 0;
+    count = 0;
+    for (i = 0; i < numgroups; i++)
+    {
+        if (groups[i].name == NO_CACHED_NAME ||
+            (size_t)groups[i].name + groups[i].namelength > numnames ||
+            (nummaterials && groups[i].material >= nummaterials) ||
+            groups[i].numclusters > numclusters - count)
+            return false;
+        for (j = 0; j < groups[i].numclusters; j++, count++)
+        {
+            if (clusters[count].first > groups[i].numtriangles ||
+                clusters[count].count > groups[i].numtriangles - clusters[count].first)
+                return false;
+        }
+        size += groups[i].numtriangles;
+    }
+    if (size != numgrouptriangles || count != numclusters)
+        return false;
+    for (i = 0; i < numgrouptriangles; i++)
+    {
+        if (grouptriangles[i] >= numtriangles)
+            return false;
+    }
+
+    for (i = 0; i < nummaterials; i++)
+    {
+        if (materials[i].name != NO_CACHED_NAME && (size_t)materials[i].name + materials[i].namelength > numnames)
+            return false;
+        if (materials[i].mapdiffuse != NO_CACHED_NAME && (size_t)materials[i].mapdiffuse + materials[i].mapdiffuselength > numnames)
+            return false;
+    }
+    if (header->mtllibname != NO_CACHED_NAME && (size_t)header->mtllibname + header->mtllibnamelength > numnames)
+        return false;
+
+    size = 0;
+    for (i = 0; i < numhullsizes; i++)
+        size += hullsizes[i];
+    if (3 * size != numhullvertices)
+        return false;
+
+    /* copy the buffers */
+    model->numvertices = header->numvertices;
+    model->vertices = (GLfloat*)malloc(sizeof(GLfloat) * numvertices);
+    memcpy(model->vertices, vertices, sizeof(GLfloat) * numvertices);
+
+    model->numnormals = header->numnormals;
+    if (numnormals)
+    {
+        model->normals = (GLfloat*)malloc(sizeof(GLfloat) * numnormals);
+        memcpy(model->normals, normals, sizeof(GLfloat) * numnormals);
+    }
+
+    model->numtexcoords = header->numtexcoords;
+    if (numtexcoords)
+    {
+        model->texcoords = (GLfloat*)malloc(sizeof(GLfloat) * numtexcoords);
+        memcpy(model->texcoords, texcoords, sizeof(GLfloat) * numtexcoords);
+    }
+
+    model->numfacetnorms = header->numfacetnorms;
+    if (numfacetnorms)
+    {
+        model->facetnorms = (GLfloat*)malloc(sizeof(GLfloat) * numfacetnorms);
+        memcpy(model->facetnorms, facetnorms, sizeof(GLfloat) * numfacetnorms);
+    }
+
+    model->numtriangles = header->numtriangles;
+    model->triangles = (GLMtriangle*)malloc(sizeof(GLMtriangle) * (numtriangles + 1));
+    memcpy(model->triangles, triangles, sizeof(GLMtriangle) * numtriangles);
+
+    if (header->mtllibname != NO_CACHED_NAME)
+        model->mtllibname = strndup(&names[header->mtllibname], header->mtllibnamelength);
+
+    model->nummaterials = header->nummaterials;
+    if (nummaterials)
+    {
+        model->materials = (GLMmaterial*)malloc(sizeof(GLMmaterial) * nummaterials);
+        for (i = 0; i < nummaterials; i++)
+        {
+            model->materials[i].name = NULL;
+            if (materials[i].name != NO_CACHED_NAME)
+                model->materials[i].name = strndup(&names[materials[i].name], materials[i].namelength);
+            model->materials[i].map_diffuse = NULL;
+            if (materials[i].mapdiffuse != NO_CACHED_NAME)
+                model->materials[i].map_diffuse = strndup(&names[materials[i].mapdiffuse], materials[i].mapdiffuselength);
+            model->materials[i].texture = 0;
+            memcpy(model->materials[i].diffuse, materials[i].diffuse, sizeof(materials[i].diffuse));
+            memcpy(model->materials[i].ambient, materials[i].ambient, sizeof(materials[i].ambient));
+            memcpy(model->materials[i].specular, materials[i].specular, sizeof(materials[i].specular));
+            memcpy(model->materials[i].emmissive, materials[i].emmissive, sizeof(materials[i].emmissive));
+            model->materials[i].shininess = materials[i].shininess;
+        }
+    }
+
+    model->numclusters = numclusters;
+    model->clusters = (GLMcluster*)malloc(sizeof(GLMcluster) * (numclusters + 1));
+    memcpy(model->clusters, clusters, sizeof(GLMcluster) * numclusters);
+
+    /* rebuild the group list in the cached order */
+    GLMgroup** tail = &model->groups;
+    model->numgroups = header->numgroups;
+    count = 0;
+    for (i = 0; i < numgroups; i++)
+    {
+        GLMgroup* group = (GLMgroup*)malloc(sizeof(GLMgroup));
+        group->name = strndup(&names[groups[i].name], groups[i].namelength);
+        group->material = groups[i].material;
+        group->numtriangles = groups[i].numtriangles;
+        group->triangles = (GLuint*)malloc(sizeof(GLuint) * (group->numtriangles + 1));
+        memcpy(group->triangles, grouptriangles, sizeof(GLuint) * group->numtriangles);
+        grouptriangles += group->numtriangles;
+        group->firstcluster = count;
+        group->numclusters = groups[i].numclusters;
+        count += group->numclusters;
+        group->next = NULL;
+        *tail = group;
+        tail = &group->next;
+    }
+
+    for (j = 0; j < 6; j++)
+        model->boundingbox[j] = bounds[j];
+    model->acmr[0] = header->acmr[0];
+    model->acmr[1] = header->acmr[1];
+    model->numweldedvertices = header->numweldedvertices;
+
+    /* the cached hull vertices are already a hull, so all of them are kept */
+    model->numhulls = header->numhulls;
+    model->hulls = (ConvexHull**)malloc(sizeof(ConvexHull*) * (model->numhulls + 1));
+    for (j = 0; j < model->numhulls; j++)
+    {
+        std::vector<double> pointList(hullvertices, hullvertices + 3 * hullsizes[j]);
+        model->hulls[j] = new ConvexHull(pointList, hullsizes[j]);
+        hullvertices += 3 * hullsizes[j];
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------
+void glcWavefrontObject::SaveCachedObject(GLMmodel* model, MeshCache &cache)
+{
+    GLuint i;
+    std::string names;
+
+    GLMcachedmodel header;
+    header.numvertices = model->numvertices;
+    header.numnormals = model->normals ? model->numnormals : 0;
+    header.numtexcoords = model->texcoords ? model->numtexcoords : 0;
+    header.numfacetnorms = model->facetnorms ? model->numfacetnorms : 0;
+    header.numtriangles = model->numtriangles;
+    header.nummaterials = model->materials ? model->nummaterials : 0;
+    header.numgroups = model->numgroups;
+    header.numhulls = model->numhulls;
+    header.mtllibname = NO_CACHED_NAME;
+    header.mtllibnamelength = 0;
+    header.acmr[0] = model->acmr[0];
+    header.acmr[1] = model->acmr[1];
+    header.numweldedvertices = model->numweldedvertices;
+
+    if (model->mtllibname)
+    {
+        header.mtllibname = names.size();
+        header.mtllibnamelength = strlen(model->mtllibname);
+        names += model->mtllibname;
+
+        /* a changed material library also invalidates the cache */
+        char* dir = DirName(model->pathname);
+        const char* library = model->mtllibname;
+        while (*library)
+        {
+            size_t length = strcspn(library, " ");
+            cache.addDependency(std::string(dir) + std::string(library, length));
+            library += length + (library[length] == ' ');
+        }
+        free(dir);
+    }
+
+    std::vector<GLMcachedmaterial> materials(header.nummaterials);
+    for (i = 0; i < header.nummaterials; i++)
+    {
+        memcpy(materials[i].diffuse, model->materials[i].diffuse, sizeof(materials[i].diffuse));
+        memcpy(materials[i].ambient, model->materials[i].ambient, sizeof(materials[i].ambient));
+        memcpy(materials[i].specular, model->materials[i].specular, sizeof(materials[i].specular));
+        memcpy(materials[i].emmissive, model->materials[i].emmissive, sizeof(materials[i].emmissive));
+        materials[i].shininess = model->materials[i].shininess;
+        materials[i].name = NO_CACHED_NAME;
+        materials[i].namelength = 0;
+        if (model->materials[i].name)
+        {
+            materials[i].name = names.size();
+            materials[i].namelength = strlen(model->materials[i].name);
+            names += model->materials[i].name;
+        }
+        materials[i].mapdiffuse = NO_CACHED_NAME;
+        materials[i].mapdiffuselength = 0;
+        if (model->materials[i].map_diffuse)
+        {
+            materials[i].mapdiffuse = names.size();
+            materials[i].mapdiffuselength = strlen(model->materials[i].map_diffuse);
+            names += model->materials[i].map_diffuse;
+        }
+    }
+
+    std::vector<GLMcachedgroup> groups;
+    std::vector<GLuint> grouptriangles;
+    for (GLMgroup* group = model->groups; group; group = group->next)
+    {
+        GLMcachedgroup cached;
+        cached.numtriangles = group->numtriangles;
+        cached.numclusters = group->numclusters;
+        cached.material = group->material;
+        cached.name = names.size();
+        cached.namelength = strlen(group->name);
+        names += group->name;
+        groups.push_back(cached);
+        grouptriangles.insert(grouptriangles.end(), group->triangles, group->triangles + group->numtriangles);
+    }
+
+    std::vector<GLuint> hullsizes;
+    std::vector<double> hullvertices;
+    for (i = 0; i < model->numhulls; i++)
+    {
+        std::vector<double>* vertexList = model->hulls[i]->getVertexList();
+        hullsizes.push_back(vertexList->size() / 3);
+        hullvertices.insert(hullvertices.end(), vertexList->begin(), vertexList->end());
+    }
+
+    cache.addBlock(MESH_CACHE_HEADER, &header, sizeof(header));
+    cache.addBlock(MESH_CACHE_POSITION, model->vertices, sizeof(GLfloat) * 3 * (model->numvertices + 1));
+    cache.addBlock(MESH_CACHE_NORMAL, model->normals, sizeof(GLfloat) * (header.numnormals ? 3 * (header.numnormals + 1) : 0));
+    cache.addBlock(MESH_CACHE_TEXCOORD, model->texcoords, sizeof(GLfloat) * (header.numtexcoords ? 2 * (header.numtexcoords + 1) : 0));
+    cache.addBlock(MESH_CACHE_FACET_NORMAL, model->facetnorms, sizeof(GLfloat) * (header.numfacetnorms ? 3 * (header.numfacetnorms + 1) : 0));
+    cache.addBlock(MESH_CACHE_TRIANGLE, model->triangles, sizeof(GLMtriangle) * model->numtriangles);
+    cache.addBlock(MESH_CACHE_MATERIAL, materials);
+    cache.addBlock(MESH_CACHE_GROUP, groups);
+    cache.addBlock(MESH_CACHE_GROUP_TRIANGLE, grouptriangles);
+    cache.addBlock(MESH_CACHE_NAME, names.data(), names.size());
+    cache.addBlock(MESH_CACHE_BOUNDS, model->boundingbox, sizeof(model->boundingbox));
+    cache.addBlock(MESH_CACHE_HULL_SIZE, hullsizes);
+    cache.addBlock(MESH_CACHE_HULL_VERTEX, hullvertices);
+    cache.addBlock(MESH_CACHE_CLUSTER, model->clusters, sizeof(GLMcluster) * model->numclusters);
+
+    cache.save();
+}
+
+//-----------------------------------------------------------
+void glcWavefrontObject::FacetNormal(int handle)
+{
+    std::shared_ptr<GLMmodel> modelRef = GetModel(handle);
+    GLMmodel* model = modelRef.get();
+    bool quantized = (model->qvertices != NULL);
+
+    if (quantized)
+        DequantizeModel(model);
+    FacetNormal(model);
+    if (quantized)
+        QuantizeModel(model);
+}
+
+//-----------------------------------------------------------
+void glcWavefrontObject::FacetNormal(GLMmodel* model)
+{
+    int numranges;
 
     assert(model);
     assert(model->vertices);
@@ -318,40 +1553,78 @@ void glcWavefrontObject::FacetNormal()
     model->numfacetnorms = model->numtriangles;
     model->facetnorms = (GLfloat*)malloc(sizeof(GLfloat) * 3 * (model->numfacetnorms + 1));
 
-    for (i = 0; i < model->numtriangles; i++)
+    /* the triangles are split in ranges computed in parallel */
+    numranges = ParallelRanges(model->numtriangles);
+    ThreadPool::getSharedPool().run(numranges, [this, model, numranges](int range)
     {
-        model->triangles[i].findex = i+1;
+        GLuint i;
+        GLfloat u[3];
+        GLfloat v[3];
 
-        u[0] = model->vertices[3 * T(i).vindices[1] + 0] -
-               model->vertices[3 * T(i).vindices[0] + 0];
-        u[1] = model->vertices[3 * T(i).vindices[1] + 1] -
-               model->vertices[3 * T(i).vindices[0] + 1];
-        u[2] = model->vertices[3 * T(i).vindices[1] + 2] -
-               model->vertices[3 * T(i).vindices[0] + 2];
+        for (i = RangeStart(model->numtriangles, numranges, range); i < RangeStart(model->numtriangles, numranges, range + 1); i++)
+        {
+            model->triangles[i].findex = i+1;
+
+            u[0] = model->vertices[3 * T(i).vindices[1] + 0] -
+                   model->vertices[3 * T(i).vindices[0] + 0];
+            u[1] = model->vertices[3 * T(i).vindices[1] + 1] -
+                   model->vertices[3 * T(i).vindices[0] + 1];
+            u[2] = model->vertices[3 * T(i).vindices[1] + 2] -
+                   model->vertices[3 * T(i).vindices[0] + 2];
+
+            v[0] = model->vertices[3 * T(i).vindices[2] + 0] -
+                   model->vertices[3 * T(i).vindices[0] + 0];
+            v[1] = model->vertices[3 * T(i).vindices[2] + 1] -
+                   model->vertices[3 * T(i).vindices[0] + 1];
+            v[2] = model->vertices[3 * T(i).vindices[2] + 2] -
+                   model->vertices[3 * T(i).vindices[0] + 2];
+
+            Cross(u, v, &model->facetnorms[3 * (i+1)]);
+            Normalize(&model->facetnorms[3 * (i+1)]);
+        }
+    });
+}
 
-        v[0] = model->vertices[3 * T(i).vindices[2] + 0] -
-               model->vertices[3 * T(i).vindices[0] + 0];
-        v[1] = model->vertices[3 * T(i).vindices[2] + 1] -
-               model->vertices[3 * T(i).vindices[0] + 1];
-        v[2] = model->vertices[3 * T(i).vindices[2] + 2] -
-               model->vertices[3 * T(i).vindices[0] + 2];
+//-----------------------------------------------------------
+int glcWavefrontObject::ParallelRanges(GLuint count)
+{
+    int numranges = ThreadPool::getSharedPool().getConcurrency();
 
-        Cross(u, v, &model->facetnorms[3 * (i+1)]);
-        Normalize(&model->facetnorms[3 * (i+1)]);
-    }
+    if (count / MIN_PARALLEL_RANGE < (GLuint)numranges)
+        numranges = count / MIN_PARALLEL_RANGE;
+
+    return numranges > 1 ? numranges : 1;
 }
 
 //-----------------------------------------------------------
-void glcWavefrontObject::VertexNormals(GLfloat angle)
+GLuint glcWavefrontObject::RangeStart(GLuint count, int numranges, int range)
 {
-    GLMnode*    node;
-    GLMnode*    tail;
-    GLMnode** members;
-    GLfloat*    normals;
-    GLuint  numnormals;
-    GLfloat average[3];
-    GLfloat dot, cos_angle;
-    GLuint  i, avg;
+    return (GLuint)((unsigned long long)count * range / numranges);
+}
+
+//-----------------------------------------------------------
+void glcWavefrontObject::VertexNormals(int handle, GLfloat angle)
+{
+    std::shared_ptr<GLMmodel> modelRef = GetModel(handle);
+    GLMmodel* model = modelRef.get();
+    bool quantized = (model->qvertices != NULL);
+
+    if (quantized)
+        DequantizeModel(model);
+    VertexNormals(model, angle);
+    if (quantized)
+        QuantizeModel(model);
+}
+
+//-----------------------------------------------------------
+void glcWavefrontObject::VertexNormals(GLMmodel* model, GLfloat angle)
+{
+    GLuint*   first;        /* first[v] .. first[v+1]-1: range of vertex v in corners */
+    GLuint*   corners;      /* triangles of every vertex, stored contiguously */
+    GLfloat   cos_angle;
+    GLuint    numnormals, numorphans;
+    GLuint    i, k, v;
+    int       numranges, r;
 
     assert(model);
     assert(model->facetnorms);
@@ -367,67 +1640,132 @@ void glcWavefrontObject::VertexNormals(GLfloat angle)
     model->numnormals = model->numtriangles * 3; /* 3 normals per triangle */
     model->normals = (GLfloat*)malloc(sizeof(GLfloat)* 3* (model->numnormals+1));
 
-    /* allocate a structure that will hold a linked list of triangle
-    indices for each vertex */
-    members = (GLMnode**)malloc(sizeof(GLMnode*) * (model->numvertices + 1));
-    for (i = 1; i <= model->numvertices; i++)
-        members[i] = NULL;
+    /* build the vertex -> triangle adjacency as a compressed sparse row
+    array: count the corners of each vertex, turn the counts into
+    offsets with a prefix sum and fill the ranges */
+    first = (GLuint*)calloc(model->numvertices + 2, sizeof(GLuint));
+    corners = (GLuint*)malloc(sizeof(GLuint) * (3 * model->numtriangles + 1));
+
+    for (i = 0; i < model->numtriangles; i++)
+        for (k = 0; k < 3; k++)
+            first[T(i).vindices[k] + 1]++;
+
+    for (v = 0; v <= model->numvertices; v++)
+        first[v + 1] += first[v];
+
+    /* each fill moves first[v] to the start of the next range... */
+    for (i = 0; i < model->numtriangles; i++)
+        for (k = 0; k < 3; k++)
+            corners[first[T(i).vindices[k]]++] = i;
+
+    /* ...so the offsets are shifted back by one vertex */
+    for (v = model->numvertices + 1; v > 0; v--)
+        first[v] = first[v - 1];
+    first[0] = 0;
+
+    /* calculate the average normal for each vertex, in parallel over
+    ranges of vertices. The normals are numbered in vertex order, so a
+    first pass counts the normals each range creates and a second one
+    writes them from the range's starting position */
+    numranges = ParallelRanges(model->numvertices);
+    std::vector<GLuint> rangenormals(numranges + 1, 0);
+    std::vector<GLuint> rangeorphans(numranges, 0);
+
+    ThreadPool::getSharedPool().run(numranges, [&](int range)
+    {
+        rangenormals[range + 1] = AverageNormals(model, cos_angle, first, corners,
+                                                 RangeStart(model->numvertices, numranges, range) + 1,
+                                                 RangeStart(model->numvertices, numranges, range + 1) + 1,
+                                                 0, &rangeorphans[range]);
+    });
+
+    rangenormals[0] = 1;
+    for (r = 0; r < numranges; r++)
+        rangenormals[r + 1] += rangenormals[r];
 
-    /* for every triangle, create a node for each vertex in it */
-    for (i = 0; i < model->numtriangles; i++)
+    ThreadPool::getSharedPool().run(numranges, [&](int range)
     {
-        node = (GLMnode*)malloc(sizeof(GLMnode));
-        node->index = i;
-        node->next  = members[T(i).vindices[0]];
-        members[T(i).vindices[0]] = node;
+        AverageNormals(model, cos_angle, first, corners,
+                       RangeStart(model->numvertices, numranges, range) + 1,
+                       RangeStart(model->numvertices, numranges, range + 1) + 1,
+                       rangenormals[range], NULL);
+    });
 
-        node = (GLMnode*)malloc(sizeof(GLMnode));
-        node->index = i;
-        node->next  = members[T(i).vindices[1]];
-        members[T(i).vindices[1]] = node;
+    numnormals = rangenormals[numranges];
+    numorphans = 0;
+    for (r = 0; r < numranges; r++)
+        numorphans += rangeorphans[r];
 
-        node = (GLMnode*)malloc(sizeof(GLMnode));
-        node->index = i;
-        node->next  = members[T(i).vindices[2]];
-        members[T(i).vindices[2]] = node;
-    }
+    if (numorphans)
+        fprintf(stderr, "glcWavefrontObject::VertexNormals(): %u vertices w/o a triangle\n", numorphans);
 
-    /* calculate the average normal for each vertex */
-    numnormals = 1;
-    for (i = 1; i <= model->numvertices; i++)
+    model->numnormals = numnormals - 1;
+
+    free(first);
+    free(corners);
+
+    /* pack the normals array (we previously allocated the maximum
+    number of normals that could possibly be created (numtriangles *
+    3), so get rid of some of them (usually alot unless none of the
+    facet normals were averaged)) */
+    model->normals = (GLfloat*)realloc(model->normals, sizeof(GLfloat)* 3* (model->numnormals+1));
+}
+
+//-----------------------------------------------------------
+/* AverageNormals: creates the normals of vertices firstvertex .. lastvertex-1
+   from position numnormals on and sets them in the triangles. With numnormals
+   equal to 0 nothing is written, and only the number of normals the range
+   creates is returned (and the vertices without triangles counted in orphans) */
+GLuint glcWavefrontObject::AverageNormals(GLMmodel* model, GLfloat cos_angle, const GLuint* first, const GLuint* corners,
+                                          GLuint firstvertex, GLuint lastvertex, GLuint numnormals, GLuint* orphans)
+{
+    GLfloat*  facetnorm;
+    GLfloat*  reference;
+    GLfloat   average[3];
+    GLuint    j, v, avg, n;
+    GLuint    count = 0;
+    bool      write = (numnormals != 0);
+
+    for (v = firstvertex; v < lastvertex; v++)
     {
-        /* calculate an average normal for this vertex by averaging the
-            facet normal of every triangle this vertex is in */
-        node = members[i];
-        if (!node)
-            fprintf(stderr, "glcWavefrontObject::VertexNormals(): vertex w/o a triangle\n");
+        if (first[v] == first[v + 1])
+        {
+            if (orphans)
+                (*orphans)++;
+            continue;
+        }
+
+        /* the triangles are visited from the last to the first, and the
+        facet normal of the last one is the reference for the crease angle */
+        reference = &model->facetnorms[3 * T(corners[first[v + 1] - 1]).findex];
         average[0] = 0.0;
         average[1] = 0.0;
         average[2] = 0.0;
         avg = 0;
-        while (node)
+        for (j = first[v + 1]; j-- > first[v]; )
         {
             /* only average if the dot product of the angle between the two
             facet normals is greater than the cosine of the threshold
             angle -- or, said another way, the angle between the two
                 facet normals is less than (or equal to) the threshold angle */
-            dot = Dot(&model->facetnorms[3 * T(node->index).findex],
-                      &model->facetnorms[3 * T(members[i]->index).findex]);
-            if (dot > cos_angle)
+            facetnorm = &model->facetnorms[3 * T(corners[j]).findex];
+            if (Dot(facetnorm, reference) > cos_angle)
             {
-                node->averaged = GL_TRUE;
-                average[0] += model->facetnorms[3 * T(node->index).findex + 0];
-                average[1] += model->facetnorms[3 * T(node->index).findex + 1];
-                average[2] += model->facetnorms[3 * T(node->index).findex + 2];
+                average[0] += facetnorm[0];
+                average[1] += facetnorm[1];
+                average[2] += facetnorm[2];
                 avg = 1;            /* we averaged at least one normal! */
             }
             else
-            {
-                node->averaged = GL_FALSE;
-            }
-            node = node->next;
+                count++;            /* this corner gets a copy of its facet normal */
         }
 
+        if (avg)
+            count++;
+
+        if (!write)
+            continue;
+
         if (avg)
         {
             /* normalize the averaged normal */
@@ -441,69 +1779,33 @@ void glcWavefrontObject::VertexNormals(GLfloat angle)
             numnormals++;
         }
 
-        /* set the normal of this vertex in each triangle it is in */
-        node = members[i];
-        while (node)
+        /* set the normal of this vertex in each triangle it is in: the
+        average normal if the triangle was averaged, its facet normal otherwise */
+        for (j = first[v + 1]; j-- > first[v]; )
         {
-            if (node->averaged)
-            {
-                /* if this node was averaged, use the average normal */
-                if (T(node->index).vindices[0] == i)
-                    T(node->index).nindices[0] = avg;
-                else if (T(node->index).vindices[1] == i)
-                    T(node->index).nindices[1] = avg;
-                else if (T(node->index).vindices[2] == i)
-                    T(node->index).nindices[2] = avg;
-            }
+            GLMtriangle* triangle = &T(corners[j]);
+
+            facetnorm = &model->facetnorms[3 * triangle->findex];
+            if (Dot(facetnorm, reference) > cos_angle)
+                n = avg;
             else
             {
-                /* if this node wasn't averaged, use the facet normal */
-                model->normals[3 * numnormals + 0] =
-                    model->facetnorms[3 * T(node->index).findex + 0];
-                model->normals[3 * numnormals + 1] =
-                    model->facetnorms[3 * T(node->index).findex + 1];
-                model->normals[3 * numnormals + 2] =
-                    model->facetnorms[3 * T(node->index).findex + 2];
-                if (T(node->index).vindices[0] == i)
-                    T(node->index).nindices[0] = numnormals;
-                else if (T(node->index).vindices[1] == i)
-                    T(node->index).nindices[1] = numnormals;
-                else if (T(node->index).vindices[2] == i)
-                    T(node->index).nindices[2] = numnormals;
-                numnormals++;
+                model->normals[3 * numnormals + 0] = facetnorm[0];
+                model->normals[3 * numnormals + 1] = facetnorm[1];
+                model->normals[3 * numnormals + 2] = facetnorm[2];
+                n = numnormals++;
             }
-            node = node->next;
-        }
-    }
-
-    model->numnormals = numnormals - 1;
 
-    /* free the member information */
-    for (i = 1; i <= model->numvertices; i++)
-    {
-        node = members[i];
-        while (node)
-        {
-            tail = node;
-            node = node->next;
-            free(tail);
+            if (triangle->vindices[0] == v)
+                triangle->nindices[0] = n;
+            else if (triangle->vindices[1] == v)
+                triangle->nindices[1] = n;
+            else if (triangle->vindices[2] == v)
+                triangle->nindices[2] = n;
         }
     }
-    free(members);
 
-    /* pack the normals array (we previously allocated the maximum
-    number of normals that could possibly be created (numtriangles *
-    3), so get rid of some of them (usually alot unless none of the
-    facet normals were averaged)) */
-    normals = model->normals;
-    model->normals = (GLfloat*)malloc(sizeof(GLfloat)* 3* (model->numnormals+1));
-    for (i = 1; i <= model->numnormals; i++)
-    {
-        model->normals[3 * i + 0] = normals[3 * i + 0];
-        model->normals[3 * i + 1] = normals[3 * i + 1];
-        model->normals[3 * i + 2] = normals[3 * i + 2];
-    }
-    free(normals);
+    return count;
 }
 
 //-----------------------------------------------------------
@@ -557,8 +1859,11 @@ float glcWavefrontObject::Abs(GLfloat f)
 }
 
 //-----------------------------------------------------------
-void glcWavefrontObject::DrawBoundingBox()
+void glcWavefrontObject::DrawBoundingBox(int handle)
 {
+    std::shared_ptr<GLMmodel> modelRef = GetModel(handle);
+    GLMmodel* model = modelRef.get();
+
     float pmin[3] = {model->boundingbox[0], model->boundingbox[1], model->boundingbox[2]};
     float pmax[3] = {model->boundingbox[3], model->boundingbox[4], model->boundingbox[5]};
 
@@ -606,46 +1911,99 @@ void glcWavefrontObject::DrawBoundingBox()
 }
 
 //-----------------------------------------------------------
-void glcWavefrontObject::Draw()
+void glcWavefrontObject::Draw(int handle)
 {
-    static GLuint i,j;
-    static GLMgroup* group;
-    static GLMtriangle* triangle;
-    static GLMmaterial* material;
-
-    assert(model);
-    assert(model->vertices);
+    std::shared_ptr<GLMmodel> modelRef = GetModel(handle);
+    GLMmodel* model = modelRef.get();
+    GLuint i,j,k;
+    GLMgroup* group;
+    GLMtriangle* triangle;
+    GLMmaterial* material;
+    GLMcluster* cluster;
+    int shading = this->shading;
+    int render = this->render;
+    GLfloat planes[6][4], eye[4];
+    GLint cullmode, frontface;
+    bool backface = false;
+    bool quantized = (model->qvertices != NULL);
+    GLboolean normalize = GL_FALSE;
+    GLboolean texture2d;
+    GLint texturebinding;
+    GLfloat normal[3] = { 0.0, 0.0, 1.0 };
+
+    assert(model->vertices || quantized);
+
+    /* the back facing clusters are only skipped when GL would discard their triangles anyway */
+    if (clusterCulling && GetViewVolume(planes, eye) && glIsEnabled(GL_CULL_FACE))
+    {
+        glGetIntegerv(GL_CULL_FACE_MODE, &cullmode);
+        glGetIntegerv(GL_FRONT_FACE, &frontface);
+        backface = (cullmode == GL_BACK && frontface == GL_CCW);
+    }
 
-    if (this->shading == FLAT_SHADING && !model->facetnorms)
+    /* the modes are only changed for this model, and each fallback is reported once */
+    if (shading == FLAT_SHADING && !model->facetnorms && !model->qfacetnorms)
     {
-        printf("glcWavefrontObject::Draw() warning: flat shading mode requested with no facet normals defined.\nChanging to SMOOTH_SHADING!\n");
-        this->shading = SMOOTH_SHADING;
+        if (!(model->drawwarnings & DRAW_WARNED_FLAT_SHADING))
+            printf("glcWavefrontObject::Draw() warning: flat shading mode requested with no facet normals defined.\nChanging to SMOOTH_SHADING!\n");
+        model->drawwarnings |= DRAW_WARNED_FLAT_SHADING;
+        shading = SMOOTH_SHADING;
     }
-    if (this->shading == SMOOTH_SHADING && !model->normals)
+    if (shading == SMOOTH_SHADING && !model->normals && !model->qnormals)
     {
-        printf("glcWavefrontObject::Draw() warning: smooth shading mode requested with no normals defined. Changing to FLAT_SHADING!\n");
-        this->shading = FLAT_SHADING;
+        if (!(model->drawwarnings & DRAW_WARNED_SMOOTH_SHADING))
+            printf("glcWavefrontObject::Draw() warning: smooth shading mode requested with no normals defined. Changing to FLAT_SHADING!\n");
+        model->drawwarnings |= DRAW_WARNED_SMOOTH_SHADING;
+        shading = FLAT_SHADING;
     }
-    if ( (this->render == USE_TEXTURE || this->render == USE_TEXTURE_AND_MATERIAL) && !model->texcoords)
+    if ( (render == USE_TEXTURE || render == USE_TEXTURE_AND_MATERIAL) && !model->texcoords && !model->qtexcoords)
     {
-        printf("glcWavefrontObject::Draw() warning: texture render mode requested with no texture coordinates defined.\nChanging to Color Rendering.\n");
-        this->render = USE_COLOR;
+        if (!(model->drawwarnings & DRAW_WARNED_TEXTURE))
+            printf("glcWavefrontObject::Draw() warning: texture render mode requested with no texture coordinates defined.\nChanging to Color Rendering.\n");
+        model->drawwarnings |= DRAW_WARNED_TEXTURE;
+        render = USE_COLOR;
     }
-    if (this->render == USE_MATERIAL && !model->materials)
+    if (render == USE_MATERIAL && !model->materials)
     {
-        printf("glcWavefrontObject::Draw() warning: material render mode requested with no materials defined.\nChanging to Color Rendering.\n");
-        this->render = USE_COLOR;
+        if (!(model->drawwarnings & DRAW_WARNED_MATERIAL))
+            printf("glcWavefrontObject::Draw() warning: material render mode requested with no materials defined.\nChanging to Color Rendering.\n");
+        model->drawwarnings |= DRAW_WARNED_MATERIAL;
+        render = USE_COLOR;
     }
 
-    if (this->render == USE_COLOR)
+    if (render == USE_COLOR)
         glEnable(GL_COLOR_MATERIAL);
-    else if (this->render == USE_MATERIAL)
+    else if (render == USE_MATERIAL)
         glDisable(GL_COLOR_MATERIAL);
 
+    /* the quantized positions and texcoords are decoded by the modelview and texture
+       matrices (after the view volume was read); the normals are renormalized after
+       the modelview's scale */
+    if (quantized)
+    {
+        glPushMatrix();
+        glTranslatef(model->qoffset[0], model->qoffset[1], model->qoffset[2]);
+        glScalef(model->qscale[0], model->qscale[1], model->qscale[2]);
+
+        normalize = glIsEnabled(GL_NORMALIZE);
+        glEnable(GL_NORMALIZE);
+
+        glMatrixMode(GL_TEXTURE);
+        glPushMatrix();
+        glTranslatef(model->qtexoffset[0], model->qtexoffset[1], 0.0);
+        glScalef(model->qtexscale[0], model->qtexscale[1], 1.0);
+        glMatrixMode(GL_MODELVIEW);
+    }
+
+    /* the texture state changed by the groups is restored after the draw */
+    texture2d = glIsEnabled(GL_TEXTURE_2D);
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &texturebinding);
+
+    model->numdrawntriangles = 0;
     group = model->groups;
     while (group)
     {
-        if (this->render == USE_MATERIAL || this->render == USE_TEXTURE_AND_MATERIAL)
+        if (render == USE_MATERIAL || render == USE_TEXTURE_AND_MATERIAL)
         {
             if(model->materials) // check if USE_TEXTURE_AND_MATERIAL is selected (some models may have only texture)
             {
@@ -657,47 +2015,214 @@ void glcWavefrontObject::Draw()
             }
         }
 
-        if (this->render == USE_COLOR)
+        if ((render == USE_TEXTURE || render == USE_TEXTURE_AND_MATERIAL) && model->materials)
+        {
+            /* the texture of the group's material is loaded on its first draw and shared by path */
+            material = &model->materials[group->material];
+            if (material->map_diffuse && !material->texture)
+                material->texture = glcTextureCache::GetSharedCache()->GetTexture(material->map_diffuse);
+
+            /* the groups without a diffuse map are drawn untextured */
+            if (material->texture)
+            {
+                glEnable(GL_TEXTURE_2D);
+                glBindTexture(GL_TEXTURE_2D, material->texture);
+            }
+            else
+                glDisable(GL_TEXTURE_2D);
+        }
+
+        if (render == USE_COLOR)
         {
             glColor4fv(color);
         }
 
         glBegin(GL_TRIANGLES);
-        for (i = 0; i < group->numtriangles; i++)
+        for (k = 0; k < group->numclusters; k++)
         {
-            triangle = &T(group->triangles[i]);
+            cluster = &model->clusters[group->firstcluster + k];
+            if (clusterCulling && ClusterCulled(cluster, planes, backface ? eye : NULL))
+                continue;
 
-            for (j = 0; j < 3; j++)
+            for (i = cluster->first; i < cluster->first + cluster->count; i++)
             {
-                //if (mode & FLAT_SHADING)
-                if(this->shading == FLAT_SHADING)
-                    glNormal3fv(&model->facetnorms[3 * triangle->findex]);
-
-                //if (mode & SMOOTH_SHADING)
-                if(this->shading == SMOOTH_SHADING)
-                    glNormal3fv(&model->normals[3 * triangle->nindices[j]]);
-                if (this->render == USE_TEXTURE || this->render == USE_TEXTURE_AND_MATERIAL )
-                    glTexCoord2fv(&model->texcoords[2 * triangle->tindices[j]]);
-                glVertex3fv(&model->vertices[3 * triangle->vindices[j]]);
+                triangle = &T(group->triangles[i]);
+
+                if (quantized)
+                {
+                    for (j = 0; j < 3; j++)
+                    {
+                        if(shading == FLAT_SHADING)
+                            VertexQuantizer::decodeOctahedral(&model->qfacetnorms[2 * triangle->findex], normal);
+                        if(shading == SMOOTH_SHADING)
+                            VertexQuantizer::decodeOctahedral(&model->qnormals[2 * triangle->nindices[j]], normal);
+                        glNormal3fv(normal);
+                        if (render == USE_TEXTURE || render == USE_TEXTURE_AND_MATERIAL )
+                            glTexCoord2sv(&model->qtexcoords[2 * triangle->tindices[j]]);
+                        glVertex3sv(&model->qvertices[3 * triangle->vindices[j]]);
+                    }
+                    continue;
+                }
+
+                for (j = 0; j < 3; j++)
+                {
+                    //if (mode & FLAT_SHADING)
+                    if(shading == FLAT_SHADING)
+                        glNormal3fv(&model->facetnorms[3 * triangle->findex]);
+
+                    //if (mode & SMOOTH_SHADING)
+                    if(shading == SMOOTH_SHADING)
+                        glNormal3fv(&model->normals[3 * triangle->nindices[j]]);
+                    if (render == USE_TEXTURE || render == USE_TEXTURE_AND_MATERIAL )
+                        glTexCoord2fv(&model->texcoords[2 * triangle->tindices[j]]);
+                    glVertex3fv(&model->vertices[3 * triangle->vindices[j]]);
+                }
             }
+            model->numdrawntriangles += cluster->count;
         }
         glEnd();
 
         group = group->next;
     }
+
+    if (quantized)
+    {
+        glMatrixMode(GL_TEXTURE);
+        glPopMatrix();
+        glMatrixMode(GL_MODELVIEW);
+        glPopMatrix();
+
+        if (!normalize)
+            glDisable(GL_NORMALIZE);
+    }
+
+    glBindTexture(GL_TEXTURE_2D, texturebinding);
+    if (texture2d)
+        glEnable(GL_TEXTURE_2D);
+    else
+        glDisable(GL_TEXTURE_2D);
 }
 
 //-----------------------------------------------------------------------------
 // PRIVATE METHODS
 //-----------------------------------------------------------------------------
 
+//-----------------------------------------------------------
+/* GetViewVolume: frustum planes (a, b, c, d with a normalized normal pointing
+   inwards) and camera in object space, from the current GL matrices. The camera
+   is a point (w = 1) for a perspective projection and the direction towards it
+   (w = 0) for an orthographic one. Returns false if the camera can't be found. */
+bool glcWavefrontObject::GetViewVolume(GLfloat planes[6][4], GLfloat eye[4])
+{
+    GLfloat m[16], p[16], c[16], length, det;
+    GLfloat inverse[9];
+    int i, j, k;
+
+    glGetFloatv(GL_MODELVIEW_MATRIX, m);
+    glGetFloatv(GL_PROJECTION_MATRIX, p);
+
+    /* clip = projection * modelview (column major) */
+    for (i = 0; i < 4; i++)
+    {
+        for (j = 0; j < 4; j++)
+        {
+            c[4 * j + i] = 0.0;
+            for (k = 0; k < 4; k++)
+                c[4 * j + i] += p[4 * k + i] * m[4 * j + k];
+        }
+    }
+
+    /* left, right, bottom, top, near and far planes: row 4 +/- rows 1, 2 and 3 */
+    for (i = 0; i < 6; i++)
+    {
+        GLfloat sign = (i % 2) ? -1.0 : 1.0;
+        for (k = 0; k < 4; k++)
+            planes[i][k] = c[4 * k + 3] + sign * c[4 * k + i / 2];
+
+        length = sqrt(planes[i][0] * planes[i][0] + planes[i][1] * planes[i][1] + planes[i][2] * planes[i][2]);
+        if (length > 0.0)
+        {
+            for (k = 0; k < 4; k++)
+                planes[i][k] /= length;
+        }
+    }
+
+    /* inverse of the modelview's linear part (cofactors of its columns) */
+    inverse[0] = m[5] * m[10] - m[6] * m[9];
+    inverse[1] = m[6] * m[8] - m[4] * m[10];
+    inverse[2] = m[4] * m[9] - m[5] * m[8];
+    inverse[3] = m[9] * m[2] - m[10] * m[1];
+    inverse[4] = m[10] * m[0] - m[8] * m[2];
+    inverse[5] = m[8] * m[1] - m[9] * m[0];
+    inverse[6] = m[1] * m[6] - m[2] * m[5];
+    inverse[7] = m[2] * m[4] - m[0] * m[6];
+    inverse[8] = m[0] * m[5] - m[1] * m[4];
+    det = m[0] * inverse[0] + m[1] * inverse[1] + m[2] * inverse[2];
+
+    /* a mirrored modelview inverts the winding of the triangles */
+    if (!(det > 0.0))
+        return false;
+
+    /* row i of the inverse is (inverse[3 * i], inverse[3 * i + 1], inverse[3 * i + 2]) / det */
+    if (p[11] == 0.0 && p[15] == 1.0)
+    {
+        /* orthographic: direction of the eye space's +z */
+        for (i = 0; i < 3; i++)
+            eye[i] = inverse[3 * i + 2];
+        length = sqrt(eye[0] * eye[0] + eye[1] * eye[1] + eye[2] * eye[2]);
+        for (i = 0; i < 3; i++)
+            eye[i] /= length;
+        eye[3] = 0.0;
+    }
+    else
+    {
+        /* perspective: eye space's origin, -A^-1 * t */
+        for (i = 0; i < 3; i++)
+            eye[i] = -(inverse[3 * i] * m[12] + inverse[3 * i + 1] * m[13] + inverse[3 * i + 2] * m[14]) / det;
+        eye[3] = 1.0;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------
+/* ClusterCulled: true if the cluster's sphere is outside one of the planes or,
+   when eye isn't NULL, if all of its triangles face away from the camera */
+bool glcWavefrontObject::ClusterCulled(const GLMcluster* cluster, GLfloat planes[6][4], const GLfloat* eye)
+{
+    GLfloat d[3], length;
+    int i;
+
+    for (i = 0; i < 6; i++)
+    {
+        if (planes[i][0] * cluster->center[0] + planes[i][1] * cluster->center[1] +
+            planes[i][2] * cluster->center[2] + planes[i][3] < -cluster->radius)
+            return true;
+    }
+
+    if (!eye || cluster->cutoff >= 1.0)
+        return false;
+
+    if (eye[3] == 0.0)
+    {
+        /* parallel view rays, going against the direction towards the eye */
+        return -(eye[0] * cluster->axis[0] + eye[1] * cluster->axis[1] + eye[2] * cluster->axis[2]) >= cluster->cutoff;
+    }
+
+    for (i = 0; i < 3; i++)
+        d[i] = cluster->center[i] - eye[i];
+    length = sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+
+    return d[0] * cluster->axis[0] + d[1] * cluster->axis[1] + d[2] * cluster->axis[2] >= cluster->cutoff * length + cluster->radius;
+}
+
 //-----------------------------------------------------------
 // Add a group to the model
-GLMgroup* glcWavefrontObject::AddGroup(char* name)
+GLMgroup* glcWavefrontObject::AddGroup(GLMmodel* model, const char* name)
 {
     GLMgroup* group;
 
-    group = FindGroup(name);
+    group = FindGroup(model, name);
     if (!group)
     {
         group = (GLMgroup*)malloc(sizeof(GLMgroup));
@@ -705,6 +2230,8 @@ GLMgroup* glcWavefrontObject::AddGroup(char* name)
         group->material = 0;
         group->numtriangles = 0;
         group->triangles = NULL;
+        group->firstcluster = 0;
+        group->numclusters = 0;
         group->next = model->groups;
         model->groups = group;
         model->numgroups++;
@@ -715,7 +2242,7 @@ GLMgroup* glcWavefrontObject::AddGroup(char* name)
 
 //-----------------------------------------------------------
 /* glmFindGroup: Find a material in the model */
-GLuint glcWavefrontObject::FindMaterial(char* name)
+GLuint glcWavefrontObject::FindMaterial(GLMmodel* model, const char* name)
 {
     GLuint i;
 
@@ -736,343 +2263,335 @@ found:
 }
 
 //-----------------------------------------------------------
-void glcWavefrontObject::FirstPass(FILE *file)
+// Scanners used by ParseOBJ. The mapped file is not null terminated,
+// so none of them reads past 'end'
+static inline bool IsBlank(char c)
 {
-    GLuint  numvertices;        /* number of vertices in model */
-    GLuint  numnormals;         /* number of normals in model */
-    GLuint  numtexcoords;       /* number of texcoords in model */
-    GLuint  numtriangles;       /* number of triangles in model */
-    GLMgroup* group;            /* current group */
-    unsigned    v, n, t;
-    char        buf[128];
+    return (c == ' ' || c == '\t' || c == '\r');
+}
 
-    /* make a default group */
-    group = AddGroup((char *) "default");
+static const char* SkipBlanks(const char* p, const char* end)
+{
+    while (p < end && IsBlank(*p))
+        p++;
+    return p;
+}
 
-    numvertices = numnormals = numtexcoords = numtriangles = 0;
-    while(fscanf(file, "%s", buf) != EOF)
-    {
-        switch(buf[0])
-        {
-            case '#':               /* comment */
-                /* eat up rest of line */
-                fgets(buf, sizeof(buf), file);
-                break;
-            case 'v':               /* v, vn, vt */
-                switch(buf[1])
-                {
-                    case '\0':          /* vertex */
-                        /* eat up rest of line */
-                        fgets(buf, sizeof(buf), file);
-                        numvertices++;
-                        break;
-                    case 'n':           /* normal */
-                        /* eat up rest of line */
-                        fgets(buf, sizeof(buf), file);
-                        numnormals++;
-                        break;
-                    case 't':           /* texcoord */
-                        /* eat up rest of line */
-                        fgets(buf, sizeof(buf), file);
-                        numtexcoords++;
-                        break;
-                    default:
-                        printf("glcWavefrontObject::FirstPass(): Unknown token \"%s\".\n", buf);
-                        exit(1);
-                        break;
-                }
-                break;
-            case 'm':
-                fgets(buf, sizeof(buf), file);
-                sscanf(buf, "%s %s", buf, buf);
-                model->mtllibname = strdup(buf);
-                ReadMTL(buf);
-                break;
-            case 'u':
-                /* eat up rest of line */
-                fgets(buf, sizeof(buf), file);
-                break;
-            case 'g':               /* group */
-                /* eat up rest of line */
-                fgets(buf, sizeof(buf), file);
-#if SINGLE_STRING_GROUP_NAMES
-                sscanf(buf, "%s", buf);
-#else
-                buf[strlen(buf)-1] = '\0';  /* nuke '\n' */
-#endif
-                group = AddGroup(buf);
-                break;
-            case 'f':               /* face */
-                v = n = t = 0;
-                fscanf(file, "%s", buf);
-                /* can be one of %d, %d//%d, %d/%d, %d/%d/%d %d//%d */
-                if (strstr(buf, "//"))
-                {
-                    /* v//n */
-                    sscanf(buf, "%d//%d", &v, &n);
-                    fscanf(file, "%d//%d", &v, &n);
-                    fscanf(file, "%d//%d", &v, &n);
-                    numtriangles++;
-                    group->numtriangles++;
-                    while(fscanf(file, "%d//%d", &v, &n) > 0)
-                    {
-                        numtriangles++;
-                        group->numtriangles++;
-                    }
-                }
-                else if (sscanf(buf, "%d/%d/%d", &v, &t, &n) == 3)
-                {
-                    /* v/t/n */
-                    fscanf(file, "%d/%d/%d", &v, &t, &n);
-                    fscanf(file, "%d/%d/%d", &v, &t, &n);
-                    numtriangles++;
-                    group->numtriangles++;
-                    while(fscanf(file, "%d/%d/%d", &v, &t, &n) > 0)
-                    {
-                        numtriangles++;
-                        group->numtriangles++;
-                    }
-                }
-                else if (sscanf(buf, "%d/%d", &v, &t) == 2)
-                {
-                    /* v/t */
-                    fscanf(file, "%d/%d", &v, &t);
-                    fscanf(file, "%d/%d", &v, &t);
-                    numtriangles++;
-                    group->numtriangles++;
-                    while(fscanf(file, "%d/%d", &v, &t) > 0)
-                    {
-                        numtriangles++;
-                        group->numtriangles++;
-                    }
-                }
-                else
-                {
-                    /* v */
-                    fscanf(file, "%d", &v);
-                    fscanf(file, "%d", &v);
-                    numtriangles++;
-                    group->numtriangles++;
-                    while(fscanf(file, "%d", &v) > 0)
-                    {
-                        numtriangles++;
-                        group->numtriangles++;
-                    }
-                }
-                break;
+static const char* TokenEnd(const char* p, const char* end)
+{
+    while (p < end && !IsBlank(*p))
+        p++;
+    return p;
+}
 
-            default:
-                /* eat up rest of line */
-                fgets(buf, sizeof(buf), file);
-                break;
-        }
+/* LineEnd: returns the end of the line that starts at p, before any comment,
+   and sets next to the start of the following line */
+static const char* LineEnd(const char* p, const char* end, const char** next)
+{
+    const char* eol = (const char*)memchr(p, '\n', end - p);
+    const char* hash;
+
+    if (!eol)
+        eol = end;
+    *next = eol + 1;
+
+    /* a comment may end any line */
+    hash = (const char*)memchr(p, '#', eol - p);
+    return hash ? hash : eol;
+}
+
+/* ScanFloat: parses the number at p and returns the position after it
+   (NULL if there is no valid number) */
+static const char* ScanFloat(const char* p, const char* end, GLfloat* value)
+{
+    double result;
+
+    p = NumberParser::parseDouble(SkipBlanks(p, end), end, result);
+    if (p)
+        *value = (GLfloat)result;
+    return p;
+}
+
+/* ScanIndex: parses the (possibly negative) integer at p and returns the
+   position after it (NULL if there are no digits) */
+static const char* ScanIndex(const char* p, const char* end, long long* value)
+{
+    bool negative = false;
+    long long result = 0;
+
+    if (p < end && *p == '-')
+    {
+        negative = true;
+        p++;
     }
 
-    /* set the stats in the model structure */
-    model->numvertices  = numvertices;
-    model->numnormals   = numnormals;
-    model->numtexcoords = numtexcoords;
-    model->numtriangles = numtriangles;
+    if (p == end || *p < '0' || *p > '9')
+        return NULL;
 
-    /* allocate memory for the triangles in each group */
-    group = model->groups;
-    while(group)
+    while (p < end && *p >= '0' && *p <= '9')
     {
-        group->triangles = (GLuint*)malloc(sizeof(GLuint) * group->numtriangles);
-        group->numtriangles = 0;
-        group = group->next;
+        result = (result < 100000000000LL) ? (10 * result + (*p - '0')) : result;
+        p++;
     }
+
+    *value = negative ? -result : result;
+    return p;
+}
+
+/* GrowArray: grows a malloc'ed array geometrically so that it holds at least 'needed' items */
+template<typename T>
+static void GrowArray(T** array, GLuint* capacity, size_t needed)
+{
+    size_t newCapacity;
+
+    if (needed <= *capacity)
+        return;
+
+    newCapacity = *capacity ? *capacity : 1024;
+    while (newCapacity < needed)
+        newCapacity *= 2;
+
+    T* grown = (T*)realloc(*array, sizeof(T) * newCapacity);
+    if (!grown)
+        throw std::bad_alloc();
+
+    *array = grown;
+    *capacity = newCapacity;
+}
+
+//-----------------------------------------------------------
+void glcWavefrontObject::ParseError(GLMmodel* model, GLuint line, const char* message)
+{
+    char buf[512];
+
+    snprintf(buf, sizeof(buf), "glcWavefrontObject::ReadObject(): %s at line %u of \"%s\".",
+             message, line, model->pathname);
+    throw std::runtime_error(buf);
 }
 
 //-----------------------------------------------------------
-void glcWavefrontObject::SecondPass(FILE* file)
+/* ParseOBJ: reads the whole file in a single pass. The arrays grow as
+   the data is found and the faces are split in triangle fans */
+void glcWavefrontObject::ParseOBJ(GLMmodel* model, const char* data, size_t size)
 {
-    GLuint  numvertices;        /* number of vertices in model */
-    GLuint  numnormals;         /* number of normals in model */
-    GLuint  numtexcoords;       /* number of texcoords in model */
-    GLuint  numtriangles;       /* number of triangles in model */
-    GLfloat*    vertices;           /* array of vertices  */
-    GLfloat*    normals;            /* array of normals */
-    GLfloat*    texcoords;          /* array of texture coordinates */
-    GLMgroup* group;            /* current group pointer */
-    GLuint  material;           /* current material */
-    GLuint  v, n, t;
-    char        buf[128];
+    const char* end = data + size;
+    const char* p = data;
+    GLuint line = 0;
+    GLuint vertexCapacity = 0, normalCapacity = 0, texcoordCapacity = 0, triangleCapacity = 0;
+    std::map<GLMgroup*, GLuint> groupCapacity;
+    GLMgroup* group;            /* current group */
+    GLuint* capacity;           /* capacity of the current group's triangle array */
+    GLuint material = 0;        /* current material */
+    bool warnedUnknown = false;
+    GLuint i;
 
-    /* set the pointer shortcuts */
-    vertices   = model->vertices;
-    normals    = model->normals;
-    texcoords  = model->texcoords;
-    group      = model->groups;
+    /* make a default group */
+    group = AddGroup(model, "default");
+    capacity = &groupCapacity[group];
+
+    /* the arrays are indexed from 1 */
+    GrowArray(&model->vertices, &vertexCapacity, 3);
 
-    /* on the second pass through the file, read all the data into the
-    allocated arrays */
-    numvertices = numnormals = numtexcoords = 1;
-    numtriangles = 0;
-    material = 0;
-    while(fscanf(file, "%s", buf) != EOF)
+    while (p < end)
     {
-        switch(buf[0])
+        const char* next;
+        const char* eol = LineEnd(p, end, &next);
+        const char* keyword;
+        const char* q;
+        size_t length;
+
+        line++;
+
+        keyword = SkipBlanks(p, eol);
+        q = TokenEnd(keyword, eol);
+        length = q - keyword;
+
+        if (length == 0)
+        {
+            /* blank line or comment */
+        }
+        else if (keyword[0] == 'v' && length <= 2)
         {
-            case '#':               /* comment */
-                /* eat up rest of line */
-                fgets(buf, sizeof(buf), file);
-                break;
-            case 'v':               /* v, vn, vt */
-                switch(buf[1])
+            GLfloat value[3];
+            int count = 3;
+
+            if (length == 2 && keyword[1] == 't')
+                count = 2;
+            else if (length == 2 && keyword[1] != 'n')
+                count = 0;
+
+            if (count == 0)
+            {
+                /* vp and other vertex data are not used */
+                if (!warnedUnknown)
+                    printf("glcWavefrontObject::ReadObject(): Ignoring unknown token \"%.*s\" at line %u.\n",
+                           (int)length, keyword, line);
+                warnedUnknown = true;
+            }
+            else
+            {
+                for (int k = 0; k < count; k++)
                 {
-                    case '\0':          /* vertex */
-                        fscanf(file, "%f %f %f",
-                               &vertices[3 * numvertices + 0],
-                               &vertices[3 * numvertices + 1],
-                               &vertices[3 * numvertices + 2]);
-                        numvertices++;
-                        break;
-                    case 'n':           /* normal */
-                        fscanf(file, "%f %f %f",
-                               &normals[3 * numnormals + 0],
-                               &normals[3 * numnormals + 1],
-                               &normals[3 * numnormals + 2]);
-                        numnormals++;
-                        break;
-                    case 't':           /* texcoord */
-                        fscanf(file, "%f %f",
-                               &texcoords[2 * numtexcoords + 0],
-                               &texcoords[2 * numtexcoords + 1]);
-                        numtexcoords++;
-                        break;
+                    q = ScanFloat(q, eol, &value[k]);
+                    if (!q)
+                        ParseError(model, line, "Invalid number");
                 }
-                break;
-            case 'u':
-                fgets(buf, sizeof(buf), file);
-                sscanf(buf, "%s %s", buf, buf);
-                group->material = material = FindMaterial(buf);
-                break;
-            case 'g':               /* group */
-                /* eat up rest of line */
-                fgets(buf, sizeof(buf), file);
-#if SINGLE_STRING_GROUP_NAMES
-                sscanf(buf, "%s", buf);
-#else
-                buf[strlen(buf)-1] = '\0';  /* nuke '\n' */
-#endif
-                group = FindGroup(buf);
-                group->material = material;
-                break;
-            case 'f':               /* face */
-                v = n = t = 0;
-                fscanf(file, "%s", buf);
-                /* can be one of %d, %d//%d, %d/%d, %d/%d/%d %d//%d */
-                if (strstr(buf, "//"))
+
+                if (length == 1)                /* vertex */
                 {
-                    /* v//n */
-                    sscanf(buf, "%d//%d", &v, &n);
-                    T(numtriangles).vindices[0] = v;
-                    T(numtriangles).nindices[0] = n;
-                    fscanf(file, "%d//%d", &v, &n);
-                    T(numtriangles).vindices[1] = v;
-                    T(numtriangles).nindices[1] = n;
-                    fscanf(file, "%d//%d", &v, &n);
-                    T(numtriangles).vindices[2] = v;
-                    T(numtriangles).nindices[2] = n;
-                    group->triangles[group->numtriangles++] = numtriangles;
-                    numtriangles++;
-                    while(fscanf(file, "%d//%d", &v, &n) > 0)
+                    model->numvertices++;
+                    GrowArray(&model->vertices, &vertexCapacity, 3 * (size_t)(model->numvertices + 1));
+                    memcpy(&model->vertices[3 * model->numvertices], value, 3 * sizeof(GLfloat));
+
+                    /* the bounding box grows with the vertices */
+                    for (int k = 0; k < 3; k++)
                     {
-                        T(numtriangles).vindices[0] = T(numtriangles-1).vindices[0];
-                        T(numtriangles).nindices[0] = T(numtriangles-1).nindices[0];
-                        T(numtriangles).vindices[1] = T(numtriangles-1).vindices[2];
-                        T(numtriangles).nindices[1] = T(numtriangles-1).nindices[2];
-                        T(numtriangles).vindices[2] = v;
-                        T(numtriangles).nindices[2] = n;
-                        group->triangles[group->numtriangles++] = numtriangles;
-                        numtriangles++;
+                        if (model->numvertices == 1 || value[k] < model->boundingbox[k])
+                            model->boundingbox[k] = value[k];
+                        if (model->numvertices == 1 || value[k] > model->boundingbox[k + 3])
+                            model->boundingbox[k + 3] = value[k];
                     }
                 }
-                else if (sscanf(buf, "%d/%d/%d", &v, &t, &n) == 3)
+                else if (keyword[1] == 'n')     /* normal */
                 {
-                    /* v/t/n */
-                    T(numtriangles).vindices[0] = v;
-                    T(numtriangles).tindices[0] = t;
-                    T(numtriangles).nindices[0] = n;
-                    fscanf(file, "%d/%d/%d", &v, &t, &n);
-                    T(numtriangles).vindices[1] = v;
-                    T(numtriangles).tindices[1] = t;
-                    T(numtriangles).nindices[1] = n;
-                    fscanf(file, "%d/%d/%d", &v, &t, &n);
-                    T(numtriangles).vindices[2] = v;
-                    T(numtriangles).tindices[2] = t;
-                    T(numtriangles).nindices[2] = n;
-                    group->triangles[group->numtriangles++] = numtriangles;
-                    numtriangles++;
-                    while(fscanf(file, "%d/%d/%d", &v, &t, &n) > 0)
-                    {
-                        T(numtriangles).vindices[0] = T(numtriangles-1).vindices[0];
-                        T(numtriangles).tindices[0] = T(numtriangles-1).tindices[0];
-                        T(numtriangles).nindices[0] = T(numtriangles-1).nindices[0];
-                        T(numtriangles).vindices[1] = T(numtriangles-1).vindices[2];
-                        T(numtriangles).tindices[1] = T(numtriangles-1).tindices[2];
-                        T(numtriangles).nindices[1] = T(numtriangles-1).nindices[2];
-                        T(numtriangles).vindices[2] = v;
-                        T(numtriangles).tindices[2] = t;
-                        T(numtriangles).nindices[2] = n;
-                        group->triangles[group->numtriangles++] = numtriangles;
-                        numtriangles++;
-                    }
+                    model->numnormals++;
+                    GrowArray(&model->normals, &normalCapacity, 3 * (size_t)(model->numnormals + 1));
+                    memcpy(&model->normals[3 * model->numnormals], value, 3 * sizeof(GLfloat));
+                }
+                else                            /* texcoord */
+                {
+                    model->numtexcoords++;
+                    GrowArray(&model->texcoords, &texcoordCapacity, 2 * (size_t)(model->numtexcoords + 1));
+                    memcpy(&model->texcoords[2 * model->numtexcoords], value, 2 * sizeof(GLfloat));
+                }
+            }
+        }
+        else if (keyword[0] == 'f' && length == 1)
+        {
+            /* can be one of v, v/t, v//n or v/t/n; negative indices are relative to the current counts */
+            GLuint first[3] = { 0, 0, 0 }, previous[3] = { 0, 0, 0 }, current[3];
+            GLuint counts[3] = { model->numvertices, model->numtexcoords, model->numnormals };
+            int numcorners = 0;
+
+            q = SkipBlanks(q, eol);
+            while (q < eol)
+            {
+                long long value[3] = { 0, 0, 0 };
+
+                q = ScanIndex(q, eol, &value[0]);
+                if (q && q < eol && *q == '/')
+                {
+                    q++;
+                    if (q < eol && *q != '/')
+                        q = ScanIndex(q, eol, &value[1]);
+                    if (q && q < eol && *q == '/')
+                        q = ScanIndex(q + 1, eol, &value[2]);
                 }
-                else if (sscanf(buf, "%d/%d", &v, &t) == 2)
+                if (!q || (q < eol && !IsBlank(*q)) || value[0] == 0)
+                    ParseError(model, line, "Invalid face vertex");
+
+                /* a relative index must resolve to an existing item; the texture and
+                   normal indices are 0 when absent, but the vertex index can't be */
+                for (int k = 0; k < 3; k++)
                 {
-                    /* v/t */
-                    T(numtriangles).vindices[0] = v;
-                    T(numtriangles).tindices[0] = t;
-                    fscanf(file, "%d/%d", &v, &t);
-                    T(numtriangles).vindices[1] = v;
-                    T(numtriangles).tindices[1] = t;
-                    fscanf(file, "%d/%d", &v, &t);
-                    T(numtriangles).vindices[2] = v;
-                    T(numtriangles).tindices[2] = t;
-                    group->triangles[group->numtriangles++] = numtriangles;
-                    numtriangles++;
-                    while(fscanf(file, "%d/%d", &v, &t) > 0)
+                    if (value[k] < 0)
                     {
-                        T(numtriangles).vindices[0] = T(numtriangles-1).vindices[0];
-                        T(numtriangles).tindices[0] = T(numtriangles-1).tindices[0];
-                        T(numtriangles).vindices[1] = T(numtriangles-1).vindices[2];
-                        T(numtriangles).tindices[1] = T(numtriangles-1).tindices[2];
-                        T(numtriangles).vindices[2] = v;
-                        T(numtriangles).tindices[2] = t;
-                        group->triangles[group->numtriangles++] = numtriangles;
-                        numtriangles++;
+                        value[k] += (long long)counts[k] + 1;
+                        if (value[k] <= 0)
+                            ParseError(model, line, "Invalid face vertex");
                     }
+                    if (value[k] > UINT_MAX || (k == 0 && value[k] == 0))
+                        ParseError(model, line, "Invalid face vertex");
+                    current[k] = (GLuint)value[k];
                 }
-                else
+
+                if (numcorners == 0)
+                    memcpy(first, current, sizeof(first));
+                else if (numcorners >= 2)
                 {
-                    /* v */
-                    sscanf(buf, "%d", &v);
-                    T(numtriangles).vindices[0] = v;
-                    fscanf(file, "%d", &v);
-                    T(numtriangles).vindices[1] = v;
-                    fscanf(file, "%d", &v);
-                    T(numtriangles).vindices[2] = v;
-                    group->triangles[group->numtriangles++] = numtriangles;
-                    numtriangles++;
-                    while(fscanf(file, "%d", &v) > 0)
+                    GLMtriangle* triangle;
+
+                    GrowArray(&model->triangles, &triangleCapacity, (size_t)model->numtriangles + 1);
+                    triangle = &model->triangles[model->numtriangles];
+                    for (int k = 0; k < 3; k++)
                     {
-                        T(numtriangles).vindices[0] = T(numtriangles-1).vindices[0];
-                        T(numtriangles).vindices[1] = T(numtriangles-1).vindices[2];
-                        T(numtriangles).vindices[2] = v;
-                        group->triangles[group->numtriangles++] = numtriangles;
-                        numtriangles++;
+                        GLuint* corner = (k == 0) ? first : (k == 1) ? previous : current;
+                        triangle->vindices[k] = corner[0];
+                        triangle->tindices[k] = corner[1];
+                        triangle->nindices[k] = corner[2];
                     }
+                    triangle->findex = 0;
+
+                    GrowArray(&group->triangles, capacity, (size_t)group->numtriangles + 1);
+                    group->triangles[group->numtriangles++] = model->numtriangles;
+                    model->numtriangles++;
                 }
-                break;
 
-            default:
-                /* eat up rest of line */
-                fgets(buf, sizeof(buf), file);
-                break;
+                memcpy(previous, current, sizeof(previous));
+                numcorners++;
+                q = SkipBlanks(q, eol);
+            }
+
+            if (numcorners < 3)
+                ParseError(model, line, "Face with less than three vertices");
+        }
+        else if (keyword[0] == 'g' && length == 1)
+        {
+            /* the group name is the rest of the line */
+            const char* nameEnd = eol;
+            std::string name;
+
+            q = SkipBlanks(q, eol);
+            while (nameEnd > q && IsBlank(nameEnd[-1]))
+                nameEnd--;
+            name.assign(q, nameEnd);
+
+            group = AddGroup(model, name.empty() ? "default" : name.c_str());
+            group->material = material;
+            capacity = &groupCapacity[group];
+        }
+        else if (length == 6 && (!strncmp(keyword, "usemtl", 6) || !strncmp(keyword, "mtllib", 6)))
+        {
+            const char* nameStart = SkipBlanks(q, eol);
+            std::string name(nameStart, TokenEnd(nameStart, eol));
+
+            if (keyword[0] == 'u')
+                group->material = material = FindMaterial(model, name.c_str());
+            else
+            {
+                /* the names of all the libraries are kept, separated by spaces */
+                std::string names = model->mtllibname ? std::string(model->mtllibname) + " " + name : name;
+                free(model->mtllibname);
+                model->mtllibname = strdup(names.c_str());
+                ReadMTL(model, name.c_str());
+            }
+        }
+
+        p = next;
+    }
+
+    /* indices may refer to data defined later in the file, so they are checked at the end */
+    for (i = 0; i < model->numtriangles; i++)
+    {
+        for (int k = 0; k < 3; k++)
+        {
+            if (T(i).vindices[k] > model->numvertices || T(i).tindices[k] > model->numtexcoords ||
+                T(i).nindices[k] > model->numnormals)
+            {
+                char buf[512];
+                snprintf(buf, sizeof(buf), "glcWavefrontObject::ReadObject(): Index out of range in triangle %u of \"%s\".",
+                         i, model->pathname);
+                throw std::runtime_error(buf);
+            }
         }
     }
+
+    /* release the unused capacity */
+    model->vertices = (GLfloat*)realloc(model->vertices, sizeof(GLfloat) * 3 * (model->numvertices + 1));
+    if (model->normals)
+        model->normals = (GLfloat*)realloc(model->normals, sizeof(GLfloat) * 3 * (model->numnormals + 1));
+    if (model->texcoords)
+        model->texcoords = (GLfloat*)realloc(model->texcoords, sizeof(GLfloat) * 2 * (model->numtexcoords + 1));
 }
 
 //-----------------------------------------------------------
@@ -1093,57 +2612,60 @@ char* glcWavefrontObject::DirName(char* path)
 }
 
 //-----------------------------------------------------------
-void glcWavefrontObject::ReadMTL(char* name)
+void glcWavefrontObject::ReadMTL(GLMmodel* model, const char* name)
 {
-    FILE* file;
+    std::unique_ptr<MappedFile> file;
+    const char* data;
+    const char* end;
+    const char* p;
     char* dir;
-    char* filename;
-    char  buf[128];
-    GLuint nummaterials, i;
+    GLuint nummaterials, first, current, i;
 
     dir = DirName(model->pathname);
-    filename = (char*)malloc(sizeof(char) * (strlen(dir) + strlen(name) + 1));
-    strcpy(filename, dir);
-    strcat(filename, name);
-    free(dir);
 
-    file = fopen(filename, "r");
-    if (!file)
+    try
+    {
+        file.reset(new MappedFile(std::string(dir) + name));
+    }
+    catch (std::exception&)
     {
-        fprintf(stderr, "glcWavefrontObject::ReadMTL() failed: can't open material file \"%s\".\n", filename);
-        exit(1);
+        /* the model is still usable with the default material */
+        fprintf(stderr, "glcWavefrontObject::ReadMTL() warning: can't open material file \"%s%s\".\n", dir, name);
+        free(dir);
+        return;
     }
-    free(filename);
+
+    data = file->getData();
+    end = data + file->getSize();
 
     /* count the number of materials in the file */
     nummaterials = 1;
-    while(fscanf(file, "%s", buf) != EOF)
+    for (p = data; p < end; )
     {
-        switch(buf[0])
-        {
-            case '#':               /* comment */
-                /* eat up rest of line */
-                fgets(buf, sizeof(buf), file);
-                break;
-            case 'n':               /* newmtl */
-                fgets(buf, sizeof(buf), file);
-                nummaterials++;
-                sscanf(buf, "%s %s", buf, buf);
-                break;
-            default:
-                /* eat up rest of line */
-                fgets(buf, sizeof(buf), file);
-                break;
-        }
+        const char* next;
+        const char* eol = LineEnd(p, end, &next);
+        const char* keyword = SkipBlanks(p, eol);
+
+        if (TokenEnd(keyword, eol) - keyword == 6 && !strncmp(keyword, "newmtl", 6))
+            nummaterials++;
+        p = next;
     }
 
-    rewind(file);
+    /* the materials of another mtllib are appended, so the indices already
+       given to the groups stay valid (the default material is only created once) */
+    if (model->materials)
+    {
+        first = model->nummaterials;
+        nummaterials += model->nummaterials - 1;
+    }
+    else
+        first = 0;
 
-    model->materials = (GLMmaterial*)malloc(sizeof(GLMmaterial) * nummaterials);
+    model->materials = (GLMmaterial*)realloc(model->materials, sizeof(GLMmaterial) * nummaterials);
     model->nummaterials = nummaterials;
 
     /* set the default material */
-    for (i = 0; i < nummaterials; i++)
+    for (i = first; i < nummaterials; i++)
     {
         model->materials[i].name = NULL;
         model->materials[i].shininess = 65.0;
@@ -1159,69 +2681,95 @@ void glcWavefrontObject::ReadMTL(char* name)
         model->materials[i].specular[1] = 0.0;
         model->materials[i].specular[2] = 0.0;
         model->materials[i].specular[3] = 1.0;
+        model->materials[i].map_diffuse = NULL;
+        model->materials[i].texture = 0;
+    }
+    if (first == 0)
+    {
+        model->materials[0].name = strdup("default");
+        first = 1;
     }
-    model->materials[0].name = strdup("default");
 
-    /* now, read in the data */
-    nummaterials = 0;
-    while(fscanf(file, "%s", buf) != EOF)
+    /* now, read in the data (the lines before the first newmtl change the default material);
+       a malformed value leaves the material unchanged */
+    current = 0;
+    for (p = data; p < end; )
     {
-        switch(buf[0])
+        const char* next;
+        const char* eol = LineEnd(p, end, &next);
+        const char* keyword = SkipBlanks(p, eol);
+        const char* q = TokenEnd(keyword, eol);
+        size_t length = q - keyword;
+        GLMmaterial* material = &model->materials[current];
+
+        p = next;
+
+        if (length == 6 && !strncmp(keyword, "newmtl", 6))
         {
-            case '#':               /* comment */
-                /* eat up rest of line */
-                fgets(buf, sizeof(buf), file);
-                break;
-            case 'n':               /* newmtl */
-                fgets(buf, sizeof(buf), file);
-                sscanf(buf, "%s %s", buf, buf);
-                nummaterials++;
-                model->materials[nummaterials].name = strdup(buf);
-                break;
-            case 'N':
-                fscanf(file, "%f", &model->materials[nummaterials].shininess);
-                /* wavefront shininess is from [0, 1000], so scale for OpenGL */
-                model->materials[nummaterials].shininess /= 1000.0;
-                model->materials[nummaterials].shininess *= 128.0;
-                break;
-            case 'K':
-                switch(buf[1])
-                {
-                    case 'd':
-                        fscanf(file, "%f %f %f",
-                               &model->materials[nummaterials].diffuse[0],
-                               &model->materials[nummaterials].diffuse[1],
-                               &model->materials[nummaterials].diffuse[2]);
-                        break;
-                    case 's':
-                        fscanf(file, "%f %f %f",
-                               &model->materials[nummaterials].specular[0],
-                               &model->materials[nummaterials].specular[1],
-                               &model->materials[nummaterials].specular[2]);
-                        break;
-                    case 'a':
-                        fscanf(file, "%f %f %f",
-                               &model->materials[nummaterials].ambient[0],
-                               &model->materials[nummaterials].ambient[1],
-                               &model->materials[nummaterials].ambient[2]);
-                        break;
-                    default:
-                        /* eat up rest of line */
-                        fgets(buf, sizeof(buf), file);
-                        break;
-                }
-                break;
-            default:
-                /* eat up rest of line */
-                fgets(buf, sizeof(buf), file);
-                break;
+            const char* nameStart = SkipBlanks(q, eol);
+
+            current = first++;
+            model->materials[current].name = strdup(std::string(nameStart, TokenEnd(nameStart, eol)).c_str());
+        }
+        else if (length == 2 && !strncmp(keyword, "Ns", 2))
+        {
+            GLfloat shininess;
+
+            /* wavefront shininess is from [0, 1000], so scale for OpenGL */
+            if (ScanFloat(q, eol, &shininess))
+                material->shininess = shininess / 1000.0 * 128.0;
+        }
+        else if (length == 2 && keyword[0] == 'K' && (keyword[1] == 'd' || keyword[1] == 's' || keyword[1] == 'a'))
+        {
+            GLfloat* color = (keyword[1] == 'd') ? material->diffuse :
+                             (keyword[1] == 's') ? material->specular : material->ambient;
+            GLfloat value[3];
+            int count = 0;
+
+            q = SkipBlanks(q, eol);
+            while (q && q < eol)
+            {
+                q = (count < 3) ? ScanFloat(q, eol, &value[count++]) : NULL;
+                if (q)
+                    q = SkipBlanks(q, eol);
+            }
+
+            /* a single value is used for the three components */
+            if (q && count == 1)
+                value[1] = value[2] = value[0];
+            if (q && (count == 1 || count == 3))
+                memcpy(color, value, sizeof(value));
+        }
+        else if (length == 6 && !strncmp(keyword, "map_Kd", 6))
+        {
+            /* the file name is the last token (it may follow options such as -s or -o),
+               and a relative path is relative to the material file */
+            const char* mapEnd = eol;
+            const char* map;
+            std::string path;
+
+            while (mapEnd > q && IsBlank(mapEnd[-1]))
+                mapEnd--;
+            map = mapEnd;
+            while (map > q && !IsBlank(map[-1]))
+                map--;
+            if (map == mapEnd)
+                continue;
+
+            path.assign(map, mapEnd);
+            if (map[0] != '/')
+                path.insert(0, dir);
+            free(material->map_diffuse);
+            material->map_diffuse = strdup(path.c_str());
         }
     }
+
+    free(dir);
 }
 
 //-----------------------------------------------------------
 // Find a group in the model
-GLMgroup* glcWavefrontObject::FindGroup(char* name)
+GLMgroup* glcWavefrontObject::FindGroup(GLMmodel* model, const char* name)
 {
     GLMgroup* group;
 
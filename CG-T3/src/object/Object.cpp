@@ -1,9 +1,18 @@
 #include "object/Object.h"
+#include "primitive/VertexCacheOptimizer.h"
+#include "primitive/VertexWelder.h"
 
 #include <iostream>
 
 using namespace std;
 
+// Cosseno do maior ngulo entre as normais de dois vrtices soldados (1 grau)
+#define WELD_NORMAL_COS 0.9998477
+// Maior diferena entre as cores e as coordenadas de textura de dois vrtices soldados
+#define WELD_ATTRIBUTE_EPSILON 1e-5
+
+atomic<unsigned long> Object::revision(0);
+
 Object::Object()
 {
     this->minX = 0.0;
@@ -33,14 +42,24 @@ Object::Object()
 
     this->objIsDrawable = true;
     this->objIsCollisible = true;
+
+    this->triangleMesh = true;
 }
 
 Object::~Object()
 {
+    // Os vrtices so compartilhados pelas faces e pertencem ao objeto, ento so retirados
+    // das faces antes que elas sejam liberadas
     for(unsigned int i = 0; i < faceList.size(); i++)
     {
+        faceList[i]->getVertexList()->clear();
         delete faceList[i];
     }
+
+    for(unsigned int i = 0; i < vertexList.size(); i++)
+    {
+        delete vertexList[i];
+    }
 }
 
 Object* Object::clone()
@@ -103,6 +122,16 @@ Object* Object::clone()
     objClone->objIsDrawable = objIsDrawable;
     objClone->objIsCollisible = objIsCollisible;
 
+    // A cpia compartilha a BVH da malha original
+    objClone->meshBVH = meshBVH;
+    objClone->convexHullList = convexHullList;
+    objClone->quantizedMesh = quantizedMesh;
+    objClone->meshTransform = meshTransform;
+
+    objClone->vertexNormalList = vertexNormalList;
+    objClone->vertexColorList = vertexColorList;
+    objClone->vertexTexCoordList = vertexTexCoordList;
+
     objClone->setEnableTexture(hasTexture());
     objClone->setTextureId(getTextureId());
 
@@ -113,6 +142,15 @@ void Object::getMinMaxAxis()
 {
     if(vertexList.size() == 0)
     {
+        // Sem vrtices prprios, os limites so os da malha compacta transformada
+        if(quantizedMesh)
+        {
+            double min[3], max[3];
+            quantizedMesh->getBounds(meshTransform, min, max);
+
+            setExtents(min, max);
+        }
+
         return;
     }
 
@@ -180,10 +218,25 @@ void Object::rescaling()
 {
     getMinMaxAxis();
 
+    double min[3] = { minX, minY, minZ };
+    double max[3] = { maxX, maxY, maxZ };
+
+    rescaling(min, max);
+}
+
+void Object::rescaling(const double min[3], const double max[3])
+{
+    notifyChange();
+
+    if((vertexList.size() == 0) && !quantizedMesh)
+    {
+        return;
+    }
+
     // Obtm os intervalos de cada eixo
-    double intervalX = (maxX - minX);
-    double intervalY = (maxY - minY);
-    double intervalZ = (maxZ - minZ);
+    double intervalX = (max[0] - min[0]);
+    double intervalY = (max[1] - min[1]);
+    double intervalZ = (max[2] - min[2]);
 
     // Define o valor de escala do objeto como o maior intervalo
     double scaleObj = intervalX;
@@ -198,28 +251,38 @@ void Object::rescaling()
         scaleObj = intervalZ;
     }
 
-    double currX, currY, currZ;
-    double newX, newY, newZ;
+    double factor = (scaleObj > 0.0) ? (2.0 / scaleObj) : 1.0;
 
-    // Escala o modelo para o intervalo [-1, 1]
+    // Centro do modelo, levado para a origem
+    double centerX = (min[0] + max[0]) / 2.0;
+    double centerY = (min[1] + max[1]) / 2.0;
+    double centerZ = (min[2] + max[2]) / 2.0;
+
+    // Centraliza e escala o modelo para o intervalo [-1, 1] em uma nica passada pelos vrtices
     for(unsigned int i = 0; i < vertexList.size(); i++)
     {
-        currX = vertexList.at(i)->getX();
-        currY = vertexList.at(i)->getY();
-        currZ = vertexList.at(i)->getZ();
-
-        newX = (2 * ((currX - minX) / scaleObj)) - 1;
-        newY = (2 * ((currY - minY) / scaleObj)) - 1;
-        newZ = (2 * ((currZ - minZ) / scaleObj)) - 1;
+        Vertex3D *vertex = vertexList[i];
 
-        vertexList.at(i)->setX(newX);
-        vertexList.at(i)->setY(newY);
-        vertexList.at(i)->setZ(newZ);
+        vertex->setX((vertex->getX() - centerX) * factor);
+        vertex->setY((vertex->getY() - centerY) * factor);
+        vertex->setZ((vertex->getZ() - centerZ) * factor);
     }
 
-    getMinMaxAxis();
+    meshTransform.translate(-centerX, -centerY, -centerZ);
+    meshTransform.scale(factor, factor, factor);
+
+    width = intervalX * factor;
+    height = intervalY * factor;
+    length = intervalZ * factor;
 
-    translate(1.0 - (width / 2.0), 1.0 - (height / 2.0), 1.0 - (length / 2.0));
+    // Limites do modelo j centralizado
+    minX = -width / 2.0;
+    minY = -height / 2.0;
+    minZ = -length / 2.0;
+
+    maxX = width / 2.0;
+    maxY = height / 2.0;
+    maxZ = length / 2.0;
 
     translationX = 0.0;
     translationY = 0.0;
@@ -228,6 +291,8 @@ void Object::rescaling()
 
 void Object::rescaling(double scaleX, double scaleY, double scaleZ)
 {
+    notifyChange();
+
     double currX, currY, currZ;
     double newX, newY, newZ;
 
@@ -247,6 +312,24 @@ void Object::rescaling(double scaleX, double scaleY, double scaleZ)
         vertexList.at(i)->setZ(newZ);
     }
 
+    meshTransform.scale(scaleX, scaleY, scaleZ);
+
+    // As normais so transformadas pela inversa da escala e normalizadas novamente
+    for(unsigned int i = 0; i < vertexNormalList.size(); i += 3)
+    {
+        double nx = vertexNormalList[i] / scaleX;
+        double ny = vertexNormalList[i + 1] / scaleY;
+        double nz = vertexNormalList[i + 2] / scaleZ;
+        double len = sqrt(nx * nx + ny * ny + nz * nz);
+
+        if(len > 0.0)
+        {
+            vertexNormalList[i] = nx / len;
+            vertexNormalList[i + 1] = ny / len;
+            vertexNormalList[i + 2] = nz / len;
+        }
+    }
+
     getMinMaxAxis();
 
     this->scaleX += scaleX;
@@ -265,6 +348,8 @@ void Object::centralize()
 
 void Object::translate(double dx, double dy, double dz)
 {
+    notifyChange();
+
     double currX, currY, currZ;
 
     // Centraliza o objeto na origem (0, 0, 0)
@@ -279,6 +364,8 @@ void Object::translate(double dx, double dy, double dz)
         vertexList.at(i)->setZ(currZ + dz);
     }
 
+    meshTransform.translate(dx, dy, dz);
+
     translationX += dx;
     translationY += dy;
     translationZ += dz;
@@ -286,6 +373,8 @@ void Object::translate(double dx, double dy, double dz)
 
 void Object::rotateXAxis(double angle)
 {
+    notifyChange();
+
     double currX, currY, currZ;
     double newX, newY, newZ;
 
@@ -308,11 +397,16 @@ void Object::rotateXAxis(double angle)
         vertexList.at(i)->setZ(newZ);
     }
 
+    meshTransform.rotateX(convertDegreeToRadians(angle));
+    rotateVertexNormals(1, 2, sinVal, cosVal);
+
     rotationX = angle;
 }
 
 void Object::rotateYAxis(double angle)
 {
+    notifyChange();
+
     double currX, currY, currZ;
     double newX, newY, newZ;
 
@@ -335,11 +429,16 @@ void Object::rotateYAxis(double angle)
         vertexList.at(i)->setZ(newZ);
     }
 
+    meshTransform.rotateY(convertDegreeToRadians(angle));
+    rotateVertexNormals(2, 0, sinVal, cosVal);
+
     rotationY = angle;
 }
 
 void Object::rotateZAxis(double angle)
 {
+    notifyChange();
+
     double currX, currY, currZ;
     double newX, newY, newZ;
 
@@ -362,12 +461,54 @@ void Object::rotateZAxis(double angle)
         vertexList.at(i)->setZ(newZ);
     }
 
+    meshTransform.rotateZ(convertDegreeToRadians(angle));
+    rotateVertexNormals(0, 1, sinVal, cosVal);
+
     rotationZ = angle;
 }
 
+void Object::rotateVertexNormals(int a, int b, double sinVal, double cosVal)
+{
+    for(unsigned int i = 0; i < vertexNormalList.size(); i += 3)
+    {
+        double currA = vertexNormalList[i + a];
+        double currB = vertexNormalList[i + b];
+
+        vertexNormalList[i + a] = currA * cosVal - currB * sinVal;
+        vertexNormalList[i + b] = currA * sinVal + currB * cosVal;
+    }
+}
+
+std::vector<float>* Object::getVertexNormalList()
+{
+    return &this->vertexNormalList;
+}
+
+std::vector<float>* Object::getVertexColorList()
+{
+    return &this->vertexColorList;
+}
+
+std::vector<float>* Object::getVertexTexCoordList()
+{
+    return &this->vertexTexCoordList;
+}
+
+void Object::reserve(int vertexCount, int faceCount)
+{
+    this->vertexList.reserve(vertexCount);
+    this->faceList.reserve(faceCount);
+}
+
 void Object::addFace(Primitive *face)
 {
+    notifyChange();
     this->faceList.push_back(face);
+
+    if((face->getVertexCount() != 3) || face->hasTexture())
+    {
+        this->triangleMesh = false;
+    }
 }
 
 Primitive* Object::getFace(int idFace)
@@ -387,6 +528,7 @@ int Object::getFaceCount()
 
 void Object::addVertex(Vertex3D *vertex)
 {
+    notifyChange();
     this->vertexList.push_back(vertex);
 }
 
@@ -470,6 +612,32 @@ double Object::getTranslationZ()
     return translationZ;
 }
 
+void Object::getExtents(double min[3], double max[3])
+{
+    min[0] = minX;
+    min[1] = minY;
+    min[2] = minZ;
+
+    max[0] = maxX;
+    max[1] = maxY;
+    max[2] = maxZ;
+}
+
+void Object::setExtents(const double min[3], const double max[3])
+{
+    minX = min[0];
+    minY = min[1];
+    minZ = min[2];
+
+    maxX = max[0];
+    maxY = max[1];
+    maxZ = max[2];
+
+    width = (maxX - minX);
+    length = (maxZ - minZ);
+    height = (maxY - minY);
+}
+
 void Object::setCenter(Vertex3D center)
 {
     translationX = center.getX();
@@ -497,6 +665,710 @@ BoundingBox* Object::getCollider()
     return getBoundingBox(getCenter(), getWidth(), getLength(), getHeight());
 }
 
+// Verifica se a caixa envolvente [min, max] colide com a bounding box
+static bool boundsHit(const double min[3], const double max[3], BoundingBox *box)
+{
+    BoundingBox boundsBox(Vertex3D(-1, (min[0] + max[0]) / 2.0, (min[1] + max[1]) / 2.0, (min[2] + max[2]) / 2.0),
+                          (max[0] - min[0]), (max[2] - min[2]), (max[1] - min[1]));
+
+    return boundsBox.hit(box);
+}
+
+bool Object::collide(BoundingBox *box, CollisionDetail detail)
+{
+    double min[3], max[3];
+
+    if((detail >= MeshCollision) && meshBVH)
+    {
+        // Fase ampla: caixa envolvente da BVH transformada para o espao do mundo
+        meshBVH->getBounds(meshTransform, min, max);
+
+        if(!boundsHit(min, max, box))
+        {
+            return false;
+        }
+
+        // Fase estreita: tringulos da malha
+        return meshBVH->hit(box, meshTransform);
+    }
+
+    if((detail >= HullCollision) && !convexHullList.empty())
+    {
+        for(unsigned int i = 0; i < convexHullList.size(); i++)
+        {
+            // Fase ampla: caixa envolvente da envoltria no espao do mundo
+            convexHullList[i]->getBounds(meshTransform, min, max);
+
+            // Fase estreita: GJK entre a envoltria e a bounding box
+            if(boundsHit(min, max, box) && convexHullList[i]->hit(box, meshTransform))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    return Collider::collide(box, detail);
+}
+
+void Object::getMeshLocalTransform(AffineTransform &toLocal)
+{
+    // Sem estruturas de coliso nem malha compacta, o espao local passa a ser o espao atual dos vrtices
+    if(!meshBVH && convexHullList.empty() && !quantizedMesh)
+    {
+        meshTransform.setIdentity();
+    }
+
+    if(!meshTransform.inverse(toLocal))
+    {
+        meshTransform.setIdentity();
+        toLocal.setIdentity();
+
+        meshBVH.reset();
+        convexHullList.clear();
+        quantizedMesh.reset();
+    }
+}
+
+int Object::weldVertices(double epsilon)
+{
+    vector<double> positionList(3 * vertexList.size());
+
+    for(unsigned int i = 0; i < vertexList.size(); i++)
+    {
+        // Os ids devem ser as posies dos vrtices na lista, pois indexam os atributos
+        if(vertexList[i]->getId() != (int)i)
+        {
+            return 0;
+        }
+
+        positionList[3 * i] = vertexList[i]->getX();
+        positionList[3 * i + 1] = vertexList[i]->getY();
+        positionList[3 * i + 2] = vertexList[i]->getZ();
+    }
+
+    int normalSize = vertexNormalList.empty() ? 0 : 3;
+    int colorSize = vertexColorList.empty() ? 0 : 3;
+    int texCoordSize = vertexTexCoordList.empty() ? 0 : 2;
+
+    // Vrtices na mesma posio com atributos diferentes (arestas vivas, costuras da textura) continuam separados
+    auto compatible = [&](unsigned int i, unsigned int j)
+    {
+        if(normalSize > 0)
+        {
+            const float *a = &vertexNormalList[3 * i];
+            const float *b = &vertexNormalList[3 * j];
+            double lengthA = a[0] * a[0] + a[1] * a[1] + a[2] * a[2];
+            double lengthB = b[0] * b[0] + b[1] * b[1] + b[2] * b[2];
+            double dot = a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+
+            // Normais nulas s so compatveis entre si
+            if(((lengthA > 0.0) != (lengthB > 0.0)) || (dot < WELD_NORMAL_COS * sqrt(lengthA * lengthB)))
+            {
+                return false;
+            }
+        }
+
+        for(int k = 0; k < colorSize; k++)
+        {
+            if(fabs(vertexColorList[3 * i + k] - vertexColorList[3 * j + k]) > WELD_ATTRIBUTE_EPSILON)
+            {
+                return false;
+            }
+        }
+
+        for(int k = 0; k < texCoordSize; k++)
+        {
+            if(fabs(vertexTexCoordList[2 * i + k] - vertexTexCoordList[2 * j + k]) > WELD_ATTRIBUTE_EPSILON)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    };
+
+    vector<unsigned int> remapList;
+    unsigned int keptCount = VertexWelder::weld(positionList.data(), vertexList.size(), epsilon, compatible, remapList);
+
+    if(keptCount == vertexList.size())
+    {
+        return 0;
+    }
+
+    // Vrtices mantidos (o primeiro de cada grupo soldado) com os seus atributos
+    vector<Vertex3D*> weldedVertexList(keptCount, NULL);
+    vector<float> normalList(normalSize * keptCount);
+    vector<float> colorList(colorSize * keptCount);
+    vector<float> texCoordList(texCoordSize * keptCount);
+
+    for(unsigned int i = 0; i < vertexList.size(); i++)
+    {
+        unsigned int id = remapList[i];
+
+        if(weldedVertexList[id])
+        {
+            continue;
+        }
+
+        weldedVertexList[id] = vertexList[i];
+
+        for(int k = 0; k < normalSize; k++)
+        {
+            normalList[3 * id + k] = vertexNormalList[3 * i + k];
+        }
+
+        for(int k = 0; k < colorSize; k++)
+        {
+            colorList[3 * id + k] = vertexColorList[3 * i + k];
+        }
+
+        for(int k = 0; k < texCoordSize; k++)
+        {
+            texCoordList[2 * id + k] = vertexTexCoordList[2 * i + k];
+        }
+    }
+
+    // As faces passam a usar os vrtices mantidos; os tringulos com dois vrtices soldados so removidos
+    unsigned int faceCount = 0;
+
+    for(unsigned int i = 0; i < faceList.size(); i++)
+    {
+        vector<Vertex3D*> *faceVertexList = faceList[i]->getVertexList();
+
+        for(unsigned int j = 0; j < faceVertexList->size(); j++)
+        {
+            faceVertexList->at(j) = weldedVertexList[remapList[faceVertexList->at(j)->getId()]];
+        }
+
+        if((faceVertexList->size() == 3) &&
+           ((faceVertexList->at(0) == faceVertexList->at(1)) || (faceVertexList->at(1) == faceVertexList->at(2)) || (faceVertexList->at(2) == faceVertexList->at(0))))
+        {
+            // A face apaga os seus vrtices, que continuam em uso pelas outras faces
+            faceVertexList->clear();
+            delete faceList[i];
+            continue;
+        }
+
+        faceList[faceCount++] = faceList[i];
+    }
+
+    faceList.resize(faceCount);
+
+    for(unsigned int i = 0; i < vertexList.size(); i++)
+    {
+        if(weldedVertexList[remapList[i]] != vertexList[i])
+        {
+            delete vertexList[i];
+        }
+    }
+
+    for(unsigned int id = 0; id < keptCount; id++)
+    {
+        weldedVertexList[id]->setId(id);
+    }
+
+    int removedCount = vertexList.size() - keptCount;
+
+    vertexList.swap(weldedVertexList);
+    vertexNormalList.swap(normalList);
+    vertexColorList.swap(colorList);
+    vertexTexCoordList.swap(texCoordList);
+
+    // A BVH guarda os ndices das faces, e a malha compacta construda a partir delas fica desatualizada
+    meshBVH.reset();
+
+    if(!vertexList.empty())
+    {
+        quantizedMesh.reset();
+    }
+
+    notifyChange();
+
+    return removedCount;
+}
+
+bool Object::optimizeVertexCache(double &acmrBefore, double &acmrAfter)
+{
+    vector<unsigned int> indexList(3 * faceList.size());
+
+    for(unsigned int i = 0; i < faceList.size(); i++)
+    {
+        vector<Vertex3D*> *faceVertexList = faceList[i]->getVertexList();
+
+        if(faceVertexList->size() != 3)
+        {
+            return false;
+        }
+
+        // Os ndices dos tringulos so os ids, que devem ser as posies dos vrtices na lista
+        for(int j = 0; j < 3; j++)
+        {
+            int id = faceVertexList->at(j)->getId();
+
+            if((id < 0) || (id >= (int)vertexList.size()) || (vertexList[id] != faceVertexList->at(j)))
+            {
+                return false;
+            }
+
+            indexList[3 * i + j] = id;
+        }
+    }
+
+    acmrBefore = VertexCacheOptimizer::getACMR(indexList.data(), indexList.size(), vertexList.size());
+
+    // Ordem dos tringulos
+    vector<unsigned int> triangleOrderList;
+    VertexCacheOptimizer::optimizeTriangleOrder(indexList.data(), indexList.size(), vertexList.size(), triangleOrderList);
+
+    vector<Primitive*> orderedFaceList(faceList.size());
+
+    for(unsigned int i = 0; i < faceList.size(); i++)
+    {
+        orderedFaceList[i] = faceList[triangleOrderList[i]];
+    }
+
+    faceList.swap(orderedFaceList);
+
+    // Ordem dos vrtices (as faces guardam ponteiros, ento basta mover os vrtices e atualizar os ids)
+    vector<unsigned int> remapList;
+    VertexCacheOptimizer::optimizeVertexOrder(indexList.data(), indexList.size(), vertexList.size(), remapList);
+
+    vector<Vertex3D*> orderedVertexList(vertexList.size());
+
+    for(unsigned int i = 0; i < vertexList.size(); i++)
+    {
+        orderedVertexList[remapList[i]] = vertexList[i];
+        vertexList[i]->setId(remapList[i]);
+    }
+
+    vertexList.swap(orderedVertexList);
+
+    if(!vertexNormalList.empty())
+    {
+        VertexCacheOptimizer::remapAttribute(vertexNormalList.data(), remapList, 3);
+    }
+
+    if(!vertexColorList.empty())
+    {
+        VertexCacheOptimizer::remapAttribute(vertexColorList.data(), remapList, 3);
+    }
+
+    if(!vertexTexCoordList.empty())
+    {
+        VertexCacheOptimizer::remapAttribute(vertexTexCoordList.data(), remapList, 2);
+    }
+
+    acmrAfter = VertexCacheOptimizer::getACMR(indexList.data(), indexList.size(), vertexList.size());
+
+    // A BVH guarda os ndices das faces, e a malha compacta construda a partir delas fica desatualizada
+    meshBVH.reset();
+
+    if(!vertexList.empty())
+    {
+        quantizedMesh.reset();
+    }
+
+    notifyChange();
+
+    return true;
+}
+
+void Object::buildMeshBVH()
+{
+    AffineTransform toLocal;
+    getMeshLocalTransform(toLocal);
+
+    meshBVH = make_shared<MeshBVH>(&faceList, toLocal);
+}
+
+MeshBVH* Object::getMeshBVH()
+{
+    return meshBVH.get();
+}
+
+void Object::buildConvexHulls(int maxVertices, int hullCount)
+{
+    AffineTransform toLocal;
+    getMeshLocalTransform(toLocal);
+
+    convexHullList.clear();
+
+    if(hullCount < 1)
+    {
+        return;
+    }
+
+    // Sem faces prprias, as envoltrias vm da malha compacta, que j est no espao local
+    if(faceList.empty() && quantizedMesh && (quantizedMesh->getTriangleCount() > 0))
+    {
+        QuantizedMesh *mesh = quantizedMesh.get();
+
+        vector<ConvexHull*> hullList = ConvexHull::fromIndexedTriangles([mesh](unsigned int idVertex, double *vertex)
+        {
+            mesh->getVertex(idVertex, vertex);
+        }, mesh->getVertexCount(), mesh->getTriangle(0), mesh->getTriangleCount(), maxVertices, hullCount);
+
+        for(unsigned int i = 0; i < hullList.size(); i++)
+        {
+            convexHullList.push_back(shared_ptr<ConvexHull>(hullList[i]));
+        }
+        return;
+    }
+
+    // Tringulos da malha (leque a partir do primeiro vrtice) no espao local
+    vector<double> triangleList;
+
+    for(unsigned int i = 0; i < faceList.size(); i++)
+    {
+        vector<Vertex3D*> *faceVertexList = faceList[i]->getVertexList();
+
+        for(unsigned int j = 2; j < faceVertexList->size(); j++)
+        {
+            Vertex3D *v[3] = { faceVertexList->at(0), faceVertexList->at(j - 1), faceVertexList->at(j) };
+
+            for(int k = 0; k < 3; k++)
+            {
+                double current[3] = { v[k]->getX(), v[k]->getY(), v[k]->getZ() };
+                double local[3];
+                toLocal.transformPoint(current, local);
+
+                triangleList.insert(triangleList.end(), local, local + 3);
+            }
+        }
+    }
+
+    // Malha sem faces: uma nica envoltria dos vrtices
+    if(triangleList.empty())
+    {
+        vector<double> pointList;
+
+        for(unsigned int i = 0; i < vertexList.size(); i++)
+        {
+            double current[3] = { vertexList[i]->getX(), vertexList[i]->getY(), vertexList[i]->getZ() };
+            double local[3];
+            toLocal.transformPoint(current, local);
+
+            pointList.insert(pointList.end(), local, local + 3);
+        }
+
+        if(!pointList.empty())
+        {
+            convexHullList.push_back(make_shared<ConvexHull>(pointList, maxVertices));
+        }
+        return;
+    }
+
+    vector<ConvexHull*> hullList = ConvexHull::fromTriangles(triangleList, maxVertices, hullCount);
+
+    for(unsigned int i = 0; i < hullList.size(); i++)
+    {
+        convexHullList.push_back(shared_ptr<ConvexHull>(hullList[i]));
+    }
+}
+
+ConvexHull* Object::getConvexHull(int idHull)
+{
+    return convexHullList[idHull].get();
+}
+
+int Object::getConvexHullCount()
+{
+    return convexHullList.size();
+}
+
+void Object::getConvexHullVertexList(int idHull, vector<double> &hullVertexList)
+{
+    vector<double> *localVertexList = convexHullList[idHull]->getVertexList();
+
+    hullVertexList.resize(localVertexList->size());
+
+    // Leva os vrtices do espao local da envoltria para o espao atual dos vrtices
+    for(unsigned int i = 0; i + 2 < localVertexList->size(); i += 3)
+    {
+        meshTransform.transformPoint(&localVertexList->at(i), &hullVertexList[i]);
+    }
+}
+
+void Object::addConvexHull(const vector<double> &hullVertexList)
+{
+    AffineTransform toLocal;
+    getMeshLocalTransform(toLocal);
+
+    vector<double> localVertexList(hullVertexList.size());
+
+    for(unsigned int i = 0; i + 2 < hullVertexList.size(); i += 3)
+    {
+        toLocal.transformPoint(&hullVertexList[i], &localVertexList[i]);
+    }
+
+    // Os vrtices j formam uma envoltria, ento todos so mantidos
+    convexHullList.push_back(make_shared<ConvexHull>(localVertexList, localVertexList.size() / 3));
+}
+
+void Object::setQuantizedMesh(shared_ptr<QuantizedMesh> quantizedMesh)
+{
+    notifyChange();
+
+    meshTransform.setIdentity();
+    meshBVH.reset();
+    convexHullList.clear();
+
+    this->quantizedMesh = quantizedMesh;
+
+    getMinMaxAxis();
+}
+
+QuantizedMesh* Object::getQuantizedMesh()
+{
+    return quantizedMesh.get();
+}
+
+void Object::getQuantizedVertexList(vector<double> &vertexList)
+{
+    int vertexCount = quantizedMesh ? quantizedMesh->getVertexCount() : 0;
+
+    vertexList.resize(3 * (size_t)vertexCount);
+
+    // Leva os vrtices do espao local da malha para o espao atual dos vrtices
+    for(int i = 0; i < vertexCount; i++)
+    {
+        double local[3];
+        quantizedMesh->getVertex(i, local);
+
+        meshTransform.transformPoint(local, &vertexList[3 * (size_t)i]);
+    }
+}
+
+bool Object::buildQuantizedMesh()
+{
+    // Tringulos das faces (leque a partir do primeiro vrtice), indexados pelos ids dos vrtices
+    vector<unsigned int> indexList;
+
+    for(unsigned int i = 0; i < faceList.size(); i++)
+    {
+        vector<Vertex3D*> *faceVertexList = faceList[i]->getVertexList();
+
+        if(faceList[i]->hasTexture())
+        {
+            return false;
+        }
+
+        for(unsigned int j = 0; j < faceVertexList->size(); j++)
+        {
+            int id = faceVertexList->at(j)->getId();
+
+            if((id < 0) || (id >= (int)vertexList.size()) || (vertexList[id] != faceVertexList->at(j)))
+            {
+                return false;
+            }
+        }
+
+        for(unsigned int j = 2; j < faceVertexList->size(); j++)
+        {
+            indexList.push_back(faceVertexList->at(0)->getId());
+            indexList.push_back(faceVertexList->at(j - 1)->getId());
+            indexList.push_back(faceVertexList->at(j)->getId());
+        }
+    }
+
+    if(indexList.empty())
+    {
+        return false;
+    }
+
+    AffineTransform toLocal;
+    getMeshLocalTransform(toLocal);
+
+    // Posies no espao local
+    vector<float> positionList(3 * vertexList.size());
+
+    for(unsigned int i = 0; i < vertexList.size(); i++)
+    {
+        double current[3] = { vertexList[i]->getX(), vertexList[i]->getY(), vertexList[i]->getZ() };
+        double local[3];
+        toLocal.transformPoint(current, local);
+
+        for(int k = 0; k < 3; k++)
+        {
+            positionList[3 * i + k] = (float)local[k];
+        }
+    }
+
+    shared_ptr<QuantizedMesh> mesh = make_shared<QuantizedMesh>();
+    mesh->setGeometry(positionList.data(), vertexList.size(), indexList);
+
+    if(!vertexNormalList.empty())
+    {
+        // As normais vo para o espao local pela transposta da parte linear de meshTransform
+        // (a inversa da transposta da inversa), e a codificao as normaliza
+        vector<float> normalList(vertexNormalList.size());
+
+        for(unsigned int i = 0; i + 2 < vertexNormalList.size(); i += 3)
+        {
+            double current[3] = { vertexNormalList[i], vertexNormalList[i + 1], vertexNormalList[i + 2] };
+            double local[3];
+            meshTransform.transformVectorTransposed(current, local);
+
+            for(int k = 0; k < 3; k++)
+            {
+                normalList[i + k] = (float)local[k];
+            }
+        }
+
+        mesh->setNormals(normalList.data());
+    }
+    else
+    {
+        // Sem normais nos vrtices, as faces continuam facetadas. As normais vm das posies antes
+        // da quantizao, que inclinaria os tringulos finos
+        vector<float> faceNormalList(indexList.size());
+
+        for(unsigned int i = 0; i + 2 < indexList.size(); i += 3)
+        {
+            const float *p0 = &positionList[3 * indexList[i]];
+            const float *p1 = &positionList[3 * indexList[i + 1]];
+            const float *p2 = &positionList[3 * indexList[i + 2]];
+
+            double u[3] = { (double)p1[0] - p0[0], (double)p1[1] - p0[1], (double)p1[2] - p0[2] };
+            double v[3] = { (double)p2[0] - p0[0], (double)p2[1] - p0[1], (double)p2[2] - p0[2] };
+
+            faceNormalList[i] = (float)(u[1] * v[2] - u[2] * v[1]);
+            faceNormalList[i + 1] = (float)(u[2] * v[0] - u[0] * v[2]);
+            faceNormalList[i + 2] = (float)(u[0] * v[1] - u[1] * v[0]);
+        }
+
+        mesh->setFaceNormals(faceNormalList.data());
+    }
+
+    if(!vertexColorList.empty())
+    {
+        mesh->setColors(vertexColorList.data());
+    }
+
+    if(!vertexTexCoordList.empty())
+    {
+        mesh->setTexCoords(vertexTexCoordList.data());
+    }
+
+    quantizedMesh = mesh;
+
+    return true;
+}
+
+void Object::releaseVertexData()
+{
+    if(!quantizedMesh)
+    {
+        return;
+    }
+
+    // Os vrtices so retirados das faces antes que elas sejam liberadas, como no destrutor
+    for(unsigned int i = 0; i < faceList.size(); i++)
+    {
+        faceList[i]->getVertexList()->clear();
+        delete faceList[i];
+    }
+
+    for(unsigned int i = 0; i < vertexList.size(); i++)
+    {
+        delete vertexList[i];
+    }
+
+    vector<Primitive*>().swap(faceList);
+    vector<Vertex3D*>().swap(vertexList);
+
+    vector<float>().swap(vertexNormalList);
+    vector<float>().swap(vertexColorList);
+    vector<float>().swap(vertexTexCoordList);
+}
+
+bool Object::raycast(const double origin[3], const double direction[3], double &distance, int &faceIndex)
+{
+    if(meshBVH)
+    {
+        return meshBVH->raycast(origin, direction, meshTransform, distance, faceIndex);
+    }
+
+    // Sem faces prprias, testa os tringulos da malha compacta
+    if(faceList.empty() && quantizedMesh)
+    {
+        return quantizedMesh->raycast(origin, direction, meshTransform, distance, faceIndex);
+    }
+
+    bool hasHit = false;
+
+    // Sem BVH, testa cada face dividida em leque
+    for(unsigned int i = 0; i < faceList.size(); i++)
+    {
+        vector<Vertex3D*> *faceVertexList = faceList[i]->getVertexList();
+
+        for(unsigned int j = 2; j < faceVertexList->size(); j++)
+        {
+            Vertex3D *tri[3] = { faceVertexList->at(0), faceVertexList->at(j - 1), faceVertexList->at(j) };
+            double v[3][3];
+
+            for(int k = 0; k < 3; k++)
+            {
+                v[k][0] = tri[k]->getX();
+                v[k][1] = tri[k]->getY();
+                v[k][2] = tri[k]->getZ();
+            }
+
+            if(MeshBVH::intersectRayTriangle(origin, direction, v, distance))
+            {
+                faceIndex = i;
+                hasHit = true;
+            }
+        }
+    }
+
+    return hasHit;
+}
+
+void Object::getBounds(double min[3], double max[3])
+{
+    if(meshBVH)
+    {
+        meshBVH->getBounds(meshTransform, min, max);
+        return;
+    }
+
+    if(vertexList.empty() && quantizedMesh)
+    {
+        quantizedMesh->getBounds(meshTransform, min, max);
+        return;
+    }
+
+    for(int axis = 0; axis < 3; axis++)
+    {
+        min[axis] = 1e30;
+        max[axis] = -1e30;
+    }
+
+    for(unsigned int i = 0; i < vertexList.size(); i++)
+    {
+        double v[3] = { vertexList[i]->getX(), vertexList[i]->getY(), vertexList[i]->getZ() };
+
+        for(int axis = 0; axis < 3; axis++)
+        {
+            min[axis] = (v[axis] < min[axis]) ? v[axis] : min[axis];
+            max[axis] = (v[axis] > max[axis]) ? v[axis] : max[axis];
+        }
+    }
+}
+
+unsigned long Object::getRevision()
+{
+    return revision;
+}
+
+void Object::notifyChange()
+{
+    revision++;
+}
+
 void Object::setMaterialType(MaterialType materialType)
 {
     Drawable::setMaterialType(materialType);
@@ -519,43 +1391,19 @@ void Object::setColor(RGBColor color)
 
 void Object::draw()
 {
-    switch(getMaterialType())
-    {
-        case PolishedBronze:
-            setPolishedBronzeMaterial();
-            break;
-        case PolishedCopper:
-            setPolishedCopperMaterial();
-            break;
-        case PolishedGold:
-            setPolishedGoldMaterial();
-            break;
-        case PolishedSilver:
-            setPolishedSilverMaterial();
-            break;
-        case Pewter:
-            setPewterMaterial();
-            break;
-        case Emerald:
-            setEmeraldMaterial();
-            break;
-        case Ruby:
-            setRubyMaterial();
-            break;
-        case Turquoise:
-            setTurquoiseMaterial();
-            break;
-        case BlackRubber:
-            setBlackRubberMaterial();
-            break;
-        case Grass:
-            setGrassMaterial();
-            break;
-        case White:
-            setWhiteMaterial();
-            break;
-        default:
-            setWhiteMaterial();
+    setMaterial(getMaterialType());
+
+    if(quantizedMesh)
+    {
+        drawQuantizedMesh();
+        return;
+    }
+
+    // Malhas de tringulos e modelos com atributos por vrtice so desenhados em um nico bloco
+    if(triangleMesh || !vertexNormalList.empty() || !vertexColorList.empty() || !vertexTexCoordList.empty())
+    {
+        drawTriangleBatch();
+        return;
     }
 
     for(unsigned int i = 0; i < faceList.size(); i++)
@@ -564,8 +1412,102 @@ void Object::draw()
     }
 }
 
+void Object::drawTriangleBatch()
+{
+    bool hasNormals = !vertexNormalList.empty();
+    bool hasColors = !vertexColorList.empty();
+    bool hasTexCoords = !vertexTexCoordList.empty();
+
+    // As cores dos vrtices substituem a componente ambiente e difusa do material
+    if(hasColors)
+    {
+        glColorMaterial(GL_FRONT, GL_AMBIENT_AND_DIFFUSE);
+        glEnable(GL_COLOR_MATERIAL);
+    }
+
+    // Todas as faces so desenhadas em um nico bloco de tringulos (faces maiores em leque)
+    glBegin(GL_TRIANGLES);
+
+    for(unsigned int i = 0; i < faceList.size(); i++)
+    {
+        Primitive *face = faceList[i];
+        vector<Vertex3D*> *faceVertexList = face->getVertexList();
+
+        if(!hasNormals)
+        {
+            Vertex3D *normal = face->getNormalVector();
+            glNormal3d(normal->getX(), normal->getY(), normal->getZ());
+        }
+
+        if(!hasColors)
+        {
+            RGBColor color = face->getColor();
+            glColor3d(color.r, color.g, color.b);
+        }
+
+        for(unsigned int j = 2; j < faceVertexList->size(); j++)
+        {
+            Vertex3D *triangle[3] = { faceVertexList->at(0), faceVertexList->at(j - 1), faceVertexList->at(j) };
+
+            for(int k = 0; k < 3; k++)
+            {
+                int id = triangle[k]->getId();
+
+                if(hasNormals)
+                {
+                    glNormal3fv(&vertexNormalList[3 * id]);
+                }
+
+                if(hasColors)
+                {
+                    glColor3fv(&vertexColorList[3 * id]);
+                }
+
+                if(hasTexCoords)
+                {
+                    glTexCoord2fv(&vertexTexCoordList[2 * id]);
+                }
+
+                glVertex3d(triangle[k]->getX(), triangle[k]->getY(), triangle[k]->getZ());
+            }
+        }
+    }
+
+    glEnd();
+
+    if(hasColors)
+    {
+        glDisable(GL_COLOR_MATERIAL);
+    }
+}
+
+void Object::drawQuantizedMesh()
+{
+    RGBColor color = getColor();
+    glColor3d(color.r, color.g, color.b);
+
+    // A malha est no espao local, levado ao espao atual do objeto pela matriz de modelo
+    double matrix[16];
+    meshTransform.getMatrix(matrix);
+
+    glPushMatrix();
+    glMultMatrixd(matrix);
+
+    quantizedMesh->draw();
+
+    glPopMatrix();
+}
+
 void Object::drawWireFrame()
 {
+    if(quantizedMesh)
+    {
+        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+        drawQuantizedMesh();
+        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+        return;
+    }
+
     for(unsigned int i = 0; i < faceList.size(); i++)
     {
         faceList[i]->drawWireFrame();
@@ -22,6 +22,7 @@ MaterialType ObjectGroup::getGroupMaterialType()
 void ObjectGroup::addObject(Object *obj, bool isDrawable, bool isCollisible)
 {
     objectList.push_back(obj);
+    Object::notifyChange();
 
     if(isDrawable)
     {
@@ -4,6 +4,7 @@ Player::Player(double x, double y, double z)
 {
     this->nav_cam.Init();
     this->nav_cam.SetPos(x, y, z);
+    storePreviousPosition();
 
     setCenter(Vertex3D(-1, x, y / 2.0, z));
     setWidth(0.1);
@@ -11,38 +12,46 @@ Player::Player(double x, double y, double z)
     setHeight(0.3);
 }
 
-void Player::refresh()
+void Player::refresh(double alpha)
 {
-    nav_cam.Refresh();
+    float x, y, z;
+    nav_cam.GetPos(x, y, z);
+
+    nav_cam.Refresh(prevX + (x - prevX) * alpha, prevY + (y - prevY) * alpha, prevZ + (z - prevZ) * alpha);
 }
 
-void Player::forward()
+void Player::storePreviousPosition()
 {
-    nav_cam.Move(nav_cam_speed, false);
-
-    Vertex3D cam_pos = nav_cam.GetPos();
-    setCenter(Vertex3D(-1, cam_pos.getX(), cam_pos.getY() / 2.0, cam_pos.getZ()));
+    nav_cam.GetPos(prevX, prevY, prevZ);
 }
 
-void Player::backward()
+bool Player::isMoving()
 {
-    nav_cam.Move(-nav_cam_speed, false);
+    float x, y, z;
+    nav_cam.GetPos(x, y, z);
 
-    Vertex3D cam_pos = nav_cam.GetPos();
-    setCenter(Vertex3D(-1, cam_pos.getX(), cam_pos.getY() / 2.0, cam_pos.getZ()));
+    return ((x != prevX) || (y != prevY) || (z != prevZ));
 }
 
-void Player::left()
+void Player::getDisplacement(int forwardAxis, int strafeAxis, double speedFactor, double deltaTime, double displacement[3])
 {
-    nav_cam.Strafe(nav_cam_speed);
+    float lx, ly, lz, strafe_lx, strafe_lz;
+    nav_cam.GetDirectionVector(lx, ly, lz);
+    nav_cam.GetStrafeVector(strafe_lx, strafe_lz);
 
-    Vertex3D cam_pos = nav_cam.GetPos();
-    setCenter(Vertex3D(-1, cam_pos.getX(), cam_pos.getY() / 2.0, cam_pos.getZ()));
+    // Mesmo deslocamento de NavigatorCamera::Move (sem voo) e NavigatorCamera::Strafe
+    double distance = nav_cam_speed * speedFactor * deltaTime;
+
+    displacement[0] = distance * (forwardAxis * lx + strafeAxis * strafe_lx);
+    displacement[1] = 0.0;
+    displacement[2] = distance * (forwardAxis * lz + strafeAxis * strafe_lz);
 }
 
-void Player::right()
+void Player::move(const double displacement[3])
 {
-    nav_cam.Strafe(-nav_cam_speed);
+    float x, y, z;
+    nav_cam.GetPos(x, y, z);
+    nav_cam.SetPos(x + displacement[0], y + displacement[1], z + displacement[2]);
 
     Vertex3D cam_pos = nav_cam.GetPos();
     setCenter(Vertex3D(-1, cam_pos.getX(), cam_pos.getY() / 2.0, cam_pos.getZ()));
@@ -0,0 +1,324 @@
+#include "ply/PLYLoader.h"
+
+#include <exception>
+#include <algorithm>
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+// Fração do progresso de um arquivo correspondente à leitura (o restante corresponde à construção da BVH)
+#define PLY_LOADER_READ_PROGRESS 0.9
+
+using namespace std;
+
+PLYLoader::PLYLoader()
+{
+    this->workerCount = 1;
+    this->hullMaxVertices = 0;
+    this->hullCount = 1;
+    this->weldEnabled = false;
+    this->weldEpsilon = 0.0;
+    this->streamThreshold = 0;
+    this->pendingCount = 0;
+    this->requestedCount = 0;
+    this->finishedCount = 0;
+    this->stopWorker = false;
+}
+
+PLYLoader::~PLYLoader()
+{
+    {
+        lock_guard<mutex> lock(loaderMutex);
+        stopWorker = true;
+    }
+
+    requestCondition.notify_all();
+
+    for(unsigned int i = 0; i < workerList.size(); i++)
+    {
+        workerList[i].join();
+    }
+
+    // Os objetos lidos que não foram entregues pertencem ao leitor
+    for(unsigned int i = 0; i < resultQueue.size(); i++)
+    {
+        delete resultQueue[i].plyObject;
+    }
+}
+
+void PLYLoader::setWorkerCount(int workerCount)
+{
+    this->workerCount = max(1, workerCount);
+}
+
+void PLYLoader::setConvexHullGeneration(int maxVertices, int hullCount)
+{
+    this->hullMaxVertices = maxVertices;
+    this->hullCount = hullCount;
+}
+
+void PLYLoader::setVertexWelding(bool enabled, double epsilon)
+{
+    this->weldEnabled = enabled;
+    this->weldEpsilon = epsilon;
+}
+
+void PLYLoader::setStreamThreshold(size_t streamThreshold)
+{
+    this->streamThreshold = streamThreshold;
+}
+
+bool PLYLoader::isStreamed(string path)
+{
+    struct stat fileStatus;
+
+    return (streamThreshold > 0) && (stat(path.c_str(), &fileStatus) == 0) && ((size_t)fileStatus.st_size > streamThreshold);
+}
+
+void PLYLoader::requestLoad(string path, string name)
+{
+    {
+        lock_guard<mutex> lock(loaderMutex);
+
+        requestQueue.push_back(PLYLoadRequest(path, name));
+        pendingCount++;
+        requestedCount++;
+
+        // As threads de trabalho são criadas na primeira solicitação
+        if(workerList.empty())
+        {
+            workerProgress.reset(new atomic<int>[workerCount]);
+
+            for(int i = 0; i < workerCount; i++)
+            {
+                workerProgress[i] = 0;
+                workerList.push_back(thread(&PLYLoader::run, this, i));
+            }
+        }
+    }
+
+    requestCondition.notify_one();
+}
+
+void PLYLoader::findPLYFiles(string directory, vector<string> &pathList)
+{
+    DIR *dir = opendir(directory.c_str());
+
+    if(!dir)
+    {
+        return;
+    }
+
+    vector<string> entryList;
+    struct dirent *entry;
+
+    while((entry = readdir(dir)) != NULL)
+    {
+        string entryName = entry->d_name;
+
+        if((entryName != ".") && (entryName != ".."))
+        {
+            entryList.push_back(entryName);
+        }
+    }
+
+    closedir(dir);
+    sort(entryList.begin(), entryList.end());
+
+    for(unsigned int i = 0; i < entryList.size(); i++)
+    {
+        string path = directory + "/" + entryList[i];
+        struct stat fileStatus;
+
+        if(stat(path.c_str(), &fileStatus) < 0)
+        {
+            continue;
+        }
+
+        if(S_ISDIR(fileStatus.st_mode))
+        {
+            findPLYFiles(path, pathList);
+        }
+        else if((path.size() > 4) && (path.compare(path.size() - 4, 4, ".ply") == 0))
+        {
+            pathList.push_back(path);
+        }
+    }
+}
+
+int PLYLoader::requestDirectory(string directory, size_t memoryBudget)
+{
+    vector<string> pathList;
+    findPLYFiles(directory, pathList);
+
+    size_t memorySize = 0;
+    int requestCount = 0;
+
+    for(unsigned int i = 0; i < pathList.size(); i++)
+    {
+        PLYLoadResult result;
+        result.path = pathList[i];
+        result.name = pathList[i].substr(pathList[i].find_last_of('/') + 1);
+        result.name = result.name.substr(0, result.name.size() - 4);
+
+        // A memória de cada arquivo é estimada pelo cabeçalho antes de solicitar a leitura
+        size_t fileMemorySize = 0;
+
+        try
+        {
+            fileMemorySize = PLYReader::estimateMemorySize(result.path, isStreamed(result.path));
+        }
+        catch(exception &ex)
+        {
+            result.error = ex.what();
+        }
+
+        if(result.error.empty() && (memorySize + fileMemorySize > memoryBudget))
+        {
+            result.error = "Limite de memória da leitura excedido";
+        }
+
+        if(!result.error.empty())
+        {
+            lock_guard<mutex> lock(loaderMutex);
+
+            pendingCount++;
+            requestedCount++;
+            pushResult(result);
+            continue;
+        }
+
+        memorySize += fileMemorySize;
+        requestLoad(result.path, result.name);
+        requestCount++;
+    }
+
+    return requestCount;
+}
+
+void PLYLoader::pushResult(const PLYLoadResult &result)
+{
+    resultQueue.push_back(result);
+    finishedCount++;
+}
+
+bool PLYLoader::popResult(PLYLoadResult &result)
+{
+    lock_guard<mutex> lock(loaderMutex);
+
+    if(resultQueue.empty())
+    {
+        return false;
+    }
+
+    result = resultQueue.front();
+    resultQueue.pop_front();
+
+    // O progresso volta a contar do zero no próximo conjunto de leituras
+    if(--pendingCount == 0)
+    {
+        requestedCount = 0;
+        finishedCount = 0;
+    }
+
+    return true;
+}
+
+int PLYLoader::getPendingCount()
+{
+    lock_guard<mutex> lock(loaderMutex);
+
+    return pendingCount;
+}
+
+double PLYLoader::getProgress()
+{
+    lock_guard<mutex> lock(loaderMutex);
+
+    if(requestedCount == 0)
+    {
+        return 0.0;
+    }
+
+    double progress = finishedCount;
+
+    for(unsigned int i = 0; i < workerList.size(); i++)
+    {
+        progress += workerProgress[i] / 1000.0;
+    }
+
+    return progress / requestedCount;
+}
+
+void PLYLoader::run(int workerIndex)
+{
+    atomic<int> &progress = workerProgress[workerIndex];
+
+    // Cada thread tem seu leitor; os núcleos são divididos entre as threads na leitura paralela
+    PLYReader plyReader;
+    plyReader.setConvexHullGeneration(hullMaxVertices, hullCount);
+    plyReader.setVertexWelding(weldEnabled, weldEpsilon);
+    plyReader.setThreadCount(max(1, (int)thread::hardware_concurrency() / workerCount));
+    plyReader.setProgressCallback([&progress](double readProgress)
+    {
+        progress = (int)(1000.0 * PLY_LOADER_READ_PROGRESS * readProgress);
+    });
+
+    while(true)
+    {
+        PLYLoadResult result;
+
+        {
+            unique_lock<mutex> lock(loaderMutex);
+
+            requestCondition.wait(lock, [this]() { return stopWorker || !requestQueue.empty(); });
+
+            if(stopWorker)
+            {
+                return;
+            }
+
+            result.path = requestQueue.front().path;
+            result.name = requestQueue.front().name;
+            requestQueue.pop_front();
+        }
+
+        // O objeto é liberado se algum passo falhar antes de ele entrar na fila de entrega
+        unique_ptr<PLYObject> plyObject;
+
+        try
+        {
+            // Os arquivos grandes ficam apenas com a malha compacta e as envoltórias, sem a BVH
+            if(isStreamed(result.path))
+            {
+                plyObject.reset(plyReader.stream_ply_object(result.path));
+            }
+            else
+            {
+                plyObject.reset(plyReader.read_ply_file(result.path));
+                // A BVH é construída uma única vez e compartilhada pelas cópias posicionadas no cenário
+                plyObject->buildMeshBVH();
+
+                // O desenho passa para a malha compacta; os vértices em double só eram necessários
+                // para a BVH e as envoltórias, que guardam as suas próprias cópias
+                if(plyObject->buildQuantizedMesh())
+                {
+                    plyObject->releaseVertexData();
+                }
+            }
+
+            result.plyObject = plyObject.get();
+        }
+        catch(exception &ex)
+        {
+            plyObject.reset();
+            result.error = ex.what();
+        }
+
+        lock_guard<mutex> lock(loaderMutex);
+
+        progress = 0;
+        pushResult(result);
+        plyObject.release();
+    }
+}
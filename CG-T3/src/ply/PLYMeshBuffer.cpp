@@ -0,0 +1,88 @@
+#include "ply/PLYMeshBuffer.h"
+#include "primitive/VertexCacheOptimizer.h"
+
+using namespace std;
+
+PLYMeshBuffer::PLYMeshBuffer()
+{
+    for(int i = 0; i < 3; i++)
+    {
+        this->min[i] = 0.0;
+        this->max[i] = 0.0;
+    }
+
+    this->acmrBefore = 0.0;
+    this->acmrAfter = 0.0;
+}
+
+void PLYMeshBuffer::beginMesh(int vertexCount, int faceCount, const double min[3], const double max[3])
+{
+    positionList.clear();
+    indexList.clear();
+    quantizedMesh.reset();
+
+    // Reserva o tamanho final para que os buffers não sejam realocados durante a leitura
+    // (faces com mais de três vértices ainda podem aumentar a lista de índices)
+    positionList.reserve(3 * (size_t)vertexCount);
+    indexList.reserve(3 * (size_t)faceCount);
+
+    for(int i = 0; i < 3; i++)
+    {
+        this->min[i] = min[i];
+        this->max[i] = max[i];
+    }
+}
+
+void PLYMeshBuffer::addVertexBatch(const short *positionList, int vertexCount)
+{
+    this->positionList.insert(this->positionList.end(), positionList, positionList + 3 * vertexCount);
+}
+
+void PLYMeshBuffer::addTriangleBatch(const unsigned int *indexList, int triangleCount)
+{
+    this->indexList.insert(this->indexList.end(), indexList, indexList + 3 * triangleCount);
+}
+
+void PLYMeshBuffer::endMesh()
+{
+    int vertexCount = positionList.size() / 3;
+
+    acmrBefore = VertexCacheOptimizer::getACMR(indexList.data(), indexList.size(), vertexCount);
+
+    // Reordena os triângulos para a cache de vértices transformados e os vértices pela ordem de uso
+    vector<unsigned int> triangleOrderList, remapList;
+
+    VertexCacheOptimizer::optimizeTriangleOrder(indexList.data(), indexList.size(), vertexCount, triangleOrderList);
+    VertexCacheOptimizer::optimizeVertexOrder(indexList.data(), indexList.size(), vertexCount, remapList);
+    VertexCacheOptimizer::remapAttribute(positionList.data(), remapList, 3);
+
+    acmrAfter = VertexCacheOptimizer::getACMR(indexList.data(), indexList.size(), vertexCount);
+
+    // As coordenadas normalizadas voltam para [-1, 1] pela escala da quantização
+    float offset[3] = { 0.0f, 0.0f, 0.0f };
+    float scale[3] = { 1.0f / VERTEX_QUANTIZATION_SCALE, 1.0f / VERTEX_QUANTIZATION_SCALE, 1.0f / VERTEX_QUANTIZATION_SCALE };
+
+    quantizedMesh = make_shared<QuantizedMesh>();
+    quantizedMesh->setQuantizedGeometry(positionList, offset, scale, indexList);
+    quantizedMesh->computeNormals();
+}
+
+shared_ptr<QuantizedMesh> PLYMeshBuffer::getQuantizedMesh()
+{
+    return quantizedMesh;
+}
+
+void PLYMeshBuffer::getOriginalBounds(double min[3], double max[3])
+{
+    for(int i = 0; i < 3; i++)
+    {
+        min[i] = this->min[i];
+        max[i] = this->max[i];
+    }
+}
+
+void PLYMeshBuffer::getVertexCacheStats(double &acmrBefore, double &acmrAfter)
+{
+    acmrBefore = this->acmrBefore;
+    acmrAfter = this->acmrAfter;
+}
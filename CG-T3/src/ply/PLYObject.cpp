@@ -2,6 +2,13 @@
 
 using namespace std;
 
+PLYObject::PLYObject()
+{
+    this->acmrBefore = 0.0;
+    this->acmrAfter = 0.0;
+    this->weldedVertexCount = 0;
+}
+
 PLYFormatVersion PLYObject::getFileFormat()
 {
     return this->fileFormat;
@@ -31,3 +38,25 @@ std::list<PLYElement> PLYObject::getElementList()
 {
     return this->elementList;
 }
+
+void PLYObject::setVertexCacheStats(double acmrBefore, double acmrAfter)
+{
+    this->acmrBefore = acmrBefore;
+    this->acmrAfter = acmrAfter;
+}
+
+void PLYObject::getVertexCacheStats(double &acmrBefore, double &acmrAfter)
+{
+    acmrBefore = this->acmrBefore;
+    acmrAfter = this->acmrAfter;
+}
+
+void PLYObject::setWeldedVertexCount(int weldedVertexCount)
+{
+    this->weldedVertexCount = weldedVertexCount;
+}
+
+int PLYObject::getWeldedVertexCount()
+{
+    return this->weldedVertexCount;
+}
@@ -1,11 +1,1539 @@
 #include "ply/PLYReader.h"
+#include "thread/ThreadPool.h"
+#include "io/NumberParser.h"
+#include "ply/PLYMeshBuffer.h"
+
+#include <cstdio>
+#include <thread>
+#include <exception>
+#include <algorithm>
+
+// Tamanho mínimo (em bytes) de cada bloco do corpo ASCII lido em paralelo
+#define PLY_PARALLEL_MIN_CHUNK_SIZE (64 * 1024)
+// Tamanho padrão da janela e quantidade de vértices ou triângulos de cada lote da leitura em fluxo
+#define PLY_STREAM_WINDOW_SIZE (1024 * 1024)
+#define PLY_STREAM_BATCH_SIZE 4096
+// Quantidade de registros lidos entre dois avisos de progresso
+#define PLY_PROGRESS_STEP 65536
+// Fração do progresso correspondente à leitura do corpo (o restante corresponde ao processamento da malha)
+#define PLY_PROGRESS_PARSE 0.8
+// Memória aproximada (em bytes) de cada vértice e de cada face de um objeto lido, incluindo
+// atributos, envoltórias e BVH (medida nos modelos de data/ply)
+#define PLY_VERTEX_MEMORY_SIZE 96
+#define PLY_FACE_MEMORY_SIZE 300
+// Memória (em bytes) de cada vértice e de cada triângulo da malha compacta da leitura em fluxo
+#define PLY_COMPACT_VERTEX_MEMORY_SIZE 10
+#define PLY_COMPACT_FACE_MEMORY_SIZE 12
 
 using namespace std;
 
+PLYReader::PLYReader()
+{
+    this->hullMaxVertices = 0;
+    this->hullCount = 1;
+    this->threadCount = max(1, (int)thread::hardware_concurrency());
+    this->cacheEnabled = true;
+    this->weldEnabled = false;
+    this->weldEpsilon = 0.0;
+    this->streamWindowSize = PLY_STREAM_WINDOW_SIZE;
+}
+
+void PLYReader::setConvexHullGeneration(int maxVertices, int hullCount)
+{
+    this->hullMaxVertices = maxVertices;
+    this->hullCount = hullCount;
+}
+
+void PLYReader::setThreadCount(int threadCount)
+{
+    this->threadCount = max(1, threadCount);
+}
+
+void PLYReader::setCacheEnabled(bool cacheEnabled)
+{
+    this->cacheEnabled = cacheEnabled;
+}
+
+void PLYReader::setVertexWelding(bool enabled, double epsilon)
+{
+    this->weldEnabled = enabled;
+    this->weldEpsilon = epsilon;
+}
+
+void PLYReader::setStreamWindowSize(size_t streamWindowSize)
+{
+    this->streamWindowSize = streamWindowSize;
+}
+
+void PLYReader::setProgressCallback(const function<void(double)> &progressCallback)
+{
+    this->progressCallback = progressCallback;
+}
+
+void PLYReader::reportProgress(double progress)
+{
+    if(progressCallback)
+    {
+        progressCallback(progress);
+    }
+}
+
+void PLYReader::reportParseProgress(size_t offset, size_t dataSize)
+{
+    if(dataSize > 0)
+    {
+        reportProgress(PLY_PROGRESS_PARSE * offset / dataSize);
+    }
+}
+
+PLYPropertyType PLYReader::parsePropertyType(string typeName)
+{
+    if((typeName == "char") || (typeName == "int8"))
+    {
+        return PLY_CHAR;
+    }
+    else if((typeName == "uchar") || (typeName == "uint8"))
+    {
+        return PLY_UCHAR;
+    }
+    else if((typeName == "short") || (typeName == "int16"))
+    {
+        return PLY_SHORT;
+    }
+    else if((typeName == "ushort") || (typeName == "uint16"))
+    {
+        return PLY_USHORT;
+    }
+    else if((typeName == "int") || (typeName == "int32"))
+    {
+        return PLY_INT;
+    }
+    else if((typeName == "uint") || (typeName == "uint32"))
+    {
+        return PLY_UINT;
+    }
+    else if((typeName == "float") || (typeName == "float32"))
+    {
+        return PLY_FLOAT;
+    }
+    else if((typeName == "double") || (typeName == "float64"))
+    {
+        return PLY_DOUBLE;
+    }
+
+    throw runtime_error("Tipo de propriedade PLY não suportado");
+}
+
+int PLYReader::getPropertyTypeSize(PLYPropertyType type)
+{
+    switch(type)
+    {
+        case PLY_CHAR:
+        case PLY_UCHAR:
+            return 1;
+        case PLY_SHORT:
+        case PLY_USHORT:
+            return 2;
+        case PLY_INT:
+        case PLY_UINT:
+        case PLY_FLOAT:
+            return 4;
+        case PLY_DOUBLE:
+            return 8;
+    }
+
+    return 0;
+}
+
+double PLYReader::readBinaryValue(const char *data, PLYPropertyType type, bool swapBytes)
+{
+    // Copia os bytes do valor (na ordem da máquina) para evitar leituras desalinhadas
+    char bytes[8];
+    int size = getPropertyTypeSize(type);
+
+    for(int i = 0; i < size; i++)
+    {
+        bytes[i] = swapBytes ? data[size - 1 - i] : data[i];
+    }
+
+    switch(type)
+    {
+        case PLY_CHAR:
+            return (signed char)bytes[0];
+        case PLY_UCHAR:
+            return (unsigned char)bytes[0];
+        case PLY_SHORT:
+        {
+            short value;
+            memcpy(&value, bytes, sizeof(value));
+            return value;
+        }
+        case PLY_USHORT:
+        {
+            unsigned short value;
+            memcpy(&value, bytes, sizeof(value));
+            return value;
+        }
+        case PLY_INT:
+        {
+            int value;
+            memcpy(&value, bytes, sizeof(value));
+            return value;
+        }
+        case PLY_UINT:
+        {
+            unsigned int value;
+            memcpy(&value, bytes, sizeof(value));
+            return value;
+        }
+        case PLY_FLOAT:
+        {
+            float value;
+            memcpy(&value, bytes, sizeof(value));
+            return value;
+        }
+        case PLY_DOUBLE:
+        {
+            double value;
+            memcpy(&value, bytes, sizeof(value));
+            return value;
+        }
+    }
+
+    return 0.0;
+}
+
+void PLYReader::swapBytes4(char *data, int valueCount)
+{
+    for(int i = 0; i < valueCount; i++)
+    {
+        char *value = &data[4 * i];
+        swap(value[0], value[3]);
+        swap(value[1], value[2]);
+    }
+}
+
+void PLYReader::checkBinarySize(size_t offset, size_t size, size_t dataSize)
+{
+    // Comparação feita sem somar offset e size, que poderia ultrapassar o limite de size_t
+    if((offset > dataSize) || (size > dataSize - offset))
+    {
+        throw runtime_error("Arquivo PLY incompleto");
+    }
+}
+
+int PLYReader::readListCount(const char *data, PLYPropertyType countType, bool swapBytes)
+{
+    double count = readBinaryValue(data, countType, swapBytes);
+
+    // Contadores com sinal podem trazer valores negativos
+    if(!(count >= 0.0) || (count > INT_MAX))
+    {
+        throw runtime_error("Tamanho de lista inválido no arquivo PLY");
+    }
+
+    return (int)count;
+}
+
+const char* PLYReader::parseListCount(const char *data, const char *end, int &count)
+{
+    data = parseInt(data, end, count);
+
+    if(count < 0)
+    {
+        throw runtime_error("Tamanho de lista inválido no arquivo PLY");
+    }
+
+    return data;
+}
+
+bool PLYReader::isByteSwapped(PLYType plyType)
+{
+    // A ordem dos bytes do arquivo é invertida quando difere da ordem da máquina
+    unsigned short endianTest = 1;
+    bool littleEndianHost = (*(unsigned char*)&endianTest == 1);
+
+    return (plyType != ASCII) && (littleEndianHost != (plyType == BINARY_LITTLE_ENDIAN));
+}
+
+void PLYReader::createFaces(vector<Vertex3D*> *vertexList, const int *vertexIdList, int vertexCount, vector<Primitive*> &faceList)
+{
+    // Verifica se a face tem vértices suficientes para formar um polígono
+    if(vertexCount < 3)
+    {
+        // Caso contrário, lança exceção
+        throw runtime_error("Primitiva não suportada");
+    }
+
+    // Verifica se a quantidade de vértices é a de um triângulo
+    if(vertexCount == 3)
+    {
+        // Obtém os vértices a partir dos índices
+        Vertex3D *v0 = vertexList->at(vertexIdList[0]);
+        Vertex3D *v1 = vertexList->at(vertexIdList[1]);
+        Vertex3D *v2 = vertexList->at(vertexIdList[2]);
+
+        // Cria uma face triângular
+        faceList.push_back(new Triangle(v0, v1, v2));
+        return;
+    }
+
+    // Polígonos maiores são divididos em triângulos (em leque se forem convexos)
+    vector<double> positionList(3 * vertexCount);
+    vector<int> triangleList;
+    triangleList.reserve(3 * (vertexCount - 2));
+
+    for(int i = 0; i < vertexCount; i++)
+    {
+        Vertex3D *vertex = vertexList->at(vertexIdList[i]);
+
+        positionList[3 * i] = vertex->getX();
+        positionList[3 * i + 1] = vertex->getY();
+        positionList[3 * i + 2] = vertex->getZ();
+    }
+
+    Triangulator::triangulate(positionList.data(), vertexCount, triangleList);
+
+    for(unsigned int i = 0; i < triangleList.size(); i += 3)
+    {
+        Vertex3D *v0 = vertexList->at(vertexIdList[triangleList[i]]);
+        Vertex3D *v1 = vertexList->at(vertexIdList[triangleList[i + 1]]);
+        Vertex3D *v2 = vertexList->at(vertexIdList[triangleList[i + 2]]);
+
+        faceList.push_back(new Triangle(v0, v1, v2));
+    }
+}
+
+void PLYReader::addFace(PLYObject *plyObject, const int *vertexIdList, int vertexCount)
+{
+    vector<Vertex3D*> *vertexList = plyObject->getVertexList();
+
+    // Triângulos são adicionados diretamente, sem a lista temporária
+    if(vertexCount == 3)
+    {
+        plyObject->addFace(new Triangle(vertexList->at(vertexIdList[0]), vertexList->at(vertexIdList[1]), vertexList->at(vertexIdList[2])));
+        return;
+    }
+
+    vector<Primitive*> faceList;
+    createFaces(vertexList, vertexIdList, vertexCount, faceList);
+
+    for(unsigned int i = 0; i < faceList.size(); i++)
+    {
+        plyObject->addFace(faceList[i]);
+    }
+}
+
+PLYVertexLayout PLYReader::getVertexLayout(const vector<PLYProperty> &propertyList)
+{
+    PLYVertexLayout layout;
+    layout.attributeIndexList.assign(propertyList.size(), -1);
+    layout.attributeScaleList.assign(propertyList.size(), 1.0);
+
+    bool attributeFound[PLY_VERTEX_ATTRIBUTE_COUNT] = { false };
+
+    for(unsigned int i = 0; i < propertyList.size(); i++)
+    {
+        const string &propertyName = propertyList[i].propertyName;
+        int attribute = -1;
+
+        if(propertyList[i].isList)
+        {
+            continue;
+        }
+
+        if(propertyName == "x") attribute = PLY_VERTEX_X;
+        else if(propertyName == "y") attribute = PLY_VERTEX_Y;
+        else if(propertyName == "z") attribute = PLY_VERTEX_Z;
+        else if(propertyName == "nx") attribute = PLY_VERTEX_NX;
+        else if(propertyName == "ny") attribute = PLY_VERTEX_NY;
+        else if(propertyName == "nz") attribute = PLY_VERTEX_NZ;
+        else if((propertyName == "red") || (propertyName == "diffuse_red")) attribute = PLY_VERTEX_RED;
+        else if((propertyName == "green") || (propertyName == "diffuse_green")) attribute = PLY_VERTEX_GREEN;
+        else if((propertyName == "blue") || (propertyName == "diffuse_blue")) attribute = PLY_VERTEX_BLUE;
+        else if((propertyName == "u") || (propertyName == "s") || (propertyName == "texture_u") || (propertyName == "texture_s")) attribute = PLY_VERTEX_U;
+        else if((propertyName == "v") || (propertyName == "t") || (propertyName == "texture_v") || (propertyName == "texture_t")) attribute = PLY_VERTEX_V;
+
+        if((attribute < 0) || attributeFound[attribute])
+        {
+            continue;
+        }
+
+        layout.attributeIndexList[i] = attribute;
+        attributeFound[attribute] = true;
+
+        // Cores inteiras são normalizadas pelo maior valor do tipo
+        if((attribute >= PLY_VERTEX_RED) && (attribute <= PLY_VERTEX_BLUE))
+        {
+            switch(propertyList[i].propertyType)
+            {
+                case PLY_CHAR:
+                case PLY_UCHAR:
+                    layout.attributeScaleList[i] = 1.0 / 255.0;
+                    break;
+                case PLY_SHORT:
+                case PLY_USHORT:
+                    layout.attributeScaleList[i] = 1.0 / 65535.0;
+                    break;
+                case PLY_INT:
+                case PLY_UINT:
+                    layout.attributeScaleList[i] = 1.0 / 4294967295.0;
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    if(!attributeFound[PLY_VERTEX_X] || !attributeFound[PLY_VERTEX_Y] || !attributeFound[PLY_VERTEX_Z])
+    {
+        throw runtime_error("Elemento de vértice PLY não suportado");
+    }
+
+    layout.hasNormal = attributeFound[PLY_VERTEX_NX] && attributeFound[PLY_VERTEX_NY] && attributeFound[PLY_VERTEX_NZ];
+    layout.hasColor = attributeFound[PLY_VERTEX_RED] && attributeFound[PLY_VERTEX_GREEN] && attributeFound[PLY_VERTEX_BLUE];
+    layout.hasTexCoord = attributeFound[PLY_VERTEX_U] && attributeFound[PLY_VERTEX_V];
+
+    // Grupos incompletos são ignorados
+    for(unsigned int i = 0; i < propertyList.size(); i++)
+    {
+        int attribute = layout.attributeIndexList[i];
+
+        if(((attribute >= PLY_VERTEX_NX) && (attribute <= PLY_VERTEX_NZ) && !layout.hasNormal) ||
+           ((attribute >= PLY_VERTEX_RED) && (attribute <= PLY_VERTEX_BLUE) && !layout.hasColor) ||
+           ((attribute >= PLY_VERTEX_U) && !layout.hasTexCoord))
+        {
+            layout.attributeIndexList[i] = -1;
+        }
+    }
+
+    return layout;
+}
+
+int PLYReader::getFloatTripleOffset(const vector<PLYProperty> &propertyList, const PLYVertexLayout &layout, const vector<int> &propertyOffsetList, int firstAttribute)
+{
+    for(unsigned int i = 0; i + 2 < propertyList.size(); i++)
+    {
+        if(layout.attributeIndexList[i] != firstAttribute)
+        {
+            continue;
+        }
+
+        for(int j = 0; j < 3; j++)
+        {
+            if((layout.attributeIndexList[i + j] != firstAttribute + j) || (propertyList[i + j].propertyType != PLY_FLOAT))
+            {
+                return -1;
+            }
+        }
+
+        return propertyOffsetList[i];
+    }
+
+    return -1;
+}
+
+void PLYReader::prepareVertexAttributes(PLYObject *plyObject, int vertexCount, const PLYVertexLayout &layout)
+{
+    if(layout.hasNormal)
+    {
+        plyObject->getVertexNormalList()->resize(3 * (size_t)vertexCount);
+    }
+
+    if(layout.hasColor)
+    {
+        plyObject->getVertexColorList()->resize(3 * (size_t)vertexCount);
+    }
+
+    if(layout.hasTexCoord)
+    {
+        plyObject->getVertexTexCoordList()->resize(2 * (size_t)vertexCount);
+    }
+}
+
+void PLYReader::storeVertexAttributes(PLYObject *plyObject, int idVertex, const double *record, const PLYVertexLayout &layout)
+{
+    if(layout.hasNormal)
+    {
+        float *normal = &(*plyObject->getVertexNormalList())[3 * (size_t)idVertex];
+        normal[0] = record[PLY_VERTEX_NX];
+        normal[1] = record[PLY_VERTEX_NY];
+        normal[2] = record[PLY_VERTEX_NZ];
+    }
+
+    if(layout.hasColor)
+    {
+        float *color = &(*plyObject->getVertexColorList())[3 * (size_t)idVertex];
+        color[0] = record[PLY_VERTEX_RED];
+        color[1] = record[PLY_VERTEX_GREEN];
+        color[2] = record[PLY_VERTEX_BLUE];
+    }
+
+    if(layout.hasTexCoord)
+    {
+        float *texCoord = &(*plyObject->getVertexTexCoordList())[2 * (size_t)idVertex];
+        texCoord[0] = record[PLY_VERTEX_U];
+        texCoord[1] = record[PLY_VERTEX_V];
+    }
+}
+
+int PLYReader::getIndexListIndex(const vector<PLYProperty> &propertyList)
+{
+    for(unsigned int i = 0; i < propertyList.size(); i++)
+    {
+        if(propertyList[i].isList && ((propertyList[i].propertyName == "vertex_indices") || (propertyList[i].propertyName == "vertex_index")))
+        {
+            return i;
+        }
+    }
+
+    throw runtime_error("Elemento de face PLY não suportado");
+}
+
+const char* PLYReader::skipWhitespace(const char *data, const char *end)
+{
+    while((data < end) && ((*data == ' ') || (*data == '\t') || (*data == '\n') || (*data == '\r')))
+    {
+        data++;
+    }
+
+    if(data == end)
+    {
+        throw runtime_error("Arquivo PLY incompleto");
+    }
+
+    return data;
+}
+
+const char* PLYReader::skipToken(const char *data, const char *end)
+{
+    data = skipWhitespace(data, end);
+
+    while((data < end) && (*data != ' ') && (*data != '\t') && (*data != '\n') && (*data != '\r'))
+    {
+        data++;
+    }
+
+    return data;
+}
+
+const char* PLYReader::parseDouble(const char *data, const char *end, double &value)
+{
+    data = NumberParser::parseDouble(skipWhitespace(data, end), end, value);
+
+    if(!data)
+    {
+        throw runtime_error("Valor inválido no arquivo PLY");
+    }
+
+    return data;
+}
+
+const char* PLYReader::parseInt(const char *data, const char *end, int &value)
+{
+    data = skipWhitespace(data, end);
+
+    bool negative = false;
+
+    if((*data == '-') || (*data == '+'))
+    {
+        negative = (*data == '-');
+        data++;
+    }
+
+    const char *digitStart = data;
+    long long result = 0;
+
+    while((data < end) && (*data >= '0') && (*data <= '9'))
+    {
+        result = 10 * result + (*data - '0');
+        data++;
+
+        // Índices e tamanhos de lista fora do intervalo de int não podem ser convertidos sem erro
+        if(result > (long long)INT_MAX + 1)
+        {
+            throw runtime_error("Valor inteiro fora do intervalo no arquivo PLY");
+        }
+    }
+
+    if((data == digitStart) || ((data < end) && (*data != ' ') && (*data != '\t') && (*data != '\n') && (*data != '\r')))
+    {
+        throw runtime_error("Valor inteiro inválido no arquivo PLY");
+    }
+
+    result = negative ? -result : result;
+
+    if(result > INT_MAX)
+    {
+        throw runtime_error("Valor inteiro fora do intervalo no arquivo PLY");
+    }
+
+    value = (int)result;
+
+    return data;
+}
+
+const char* PLYReader::parseVertexRecord(const char *data, const char *end, const vector<PLYProperty> &propertyList, const PLYVertexLayout &layout, double *record)
+{
+    for(unsigned int i = 0; i < propertyList.size(); i++)
+    {
+        int attribute = layout.attributeIndexList[i];
+
+        if(attribute >= 0)
+        {
+            data = parseDouble(data, end, record[attribute]);
+            record[attribute] *= layout.attributeScaleList[i];
+        }
+        else if(!propertyList[i].isList)
+        {
+            data = skipToken(data, end);
+        }
+        else
+        {
+            int valueCount;
+            data = parseListCount(data, end, valueCount);
+
+            for(int j = 0; j < valueCount; j++)
+            {
+                data = skipToken(data, end);
+            }
+        }
+    }
+
+    return data;
+}
+
+const char* PLYReader::parseFaceRecord(const char *data, const char *end, const vector<PLYProperty> &propertyList, int indexListIndex, vector<int> &vertexIdList)
+{
+    for(unsigned int i = 0; i < propertyList.size(); i++)
+    {
+        if(!propertyList[i].isList)
+        {
+            data = skipToken(data, end);
+            continue;
+        }
+
+        int valueCount;
+        data = parseListCount(data, end, valueCount);
+
+        for(int j = 0; j < valueCount; j++)
+        {
+            if((int)i == indexListIndex)
+            {
+                int vertexId;
+                data = parseInt(data, end, vertexId);
+                vertexIdList.push_back(vertexId);
+            }
+            else
+            {
+                data = skipToken(data, end);
+            }
+        }
+    }
+
+    return data;
+}
+
+const char* PLYReader::skipRecord(const char *data, const char *end, const vector<PLYProperty> &propertyList)
+{
+    for(unsigned int i = 0; i < propertyList.size(); i++)
+    {
+        int valueCount = 1;
+
+        if(propertyList[i].isList)
+        {
+            data = parseListCount(data, end, valueCount);
+        }
+
+        for(int j = 0; j < valueCount; j++)
+        {
+            data = skipToken(data, end);
+        }
+    }
+
+    return data;
+}
+
+void PLYReader::runParallel(int taskCount, const function<void(int)> &task)
+{
+    // As tarefas são distribuídas entre as threads já criadas do conjunto compartilhado
+    ThreadPool::getSharedPool().run(taskCount, task);
+}
+
+void PLYReader::readAsciiElements(const char *data, size_t dataSize, PLYObject *plyObject, PLYBounds &bounds)
+{
+    // Corpos grandes são lidos em paralelo quando estão no formato de um registro por linha
+    if((threadCount > 1) && (dataSize >= 2 * PLY_PARALLEL_MIN_CHUNK_SIZE) && readAsciiElementsParallel(data, dataSize, plyObject, bounds))
+    {
+        return;
+    }
+
+    const char *begin = data;
+    const char *end = data + dataSize;
+
+    // Obtém a lista de elementos do arquivo PLY
+    list<PLYElement> elementList = plyObject->getElementList();
+
+    // Para cada elemento do arquivo PLY
+    for(auto it = elementList.begin(); it != elementList.end(); it++)
+    {
+        const vector<PLYProperty> &propertyList = (*it).propertyList;
+        int elementCount = (*it).elementCount;
+
+        // Verifica se o elemento é o elemento de vértices do modelo 3D
+        if((*it).elementName == "vertex")
+        {
+            PLYVertexLayout layout = getVertexLayout(propertyList);
+
+            // Os atributos são escritos direto nas listas do objeto, alocadas com a quantidade do cabeçalho
+            prepareVertexAttributes(plyObject, elementCount, layout);
+
+            for(int i = 0; i < elementCount; i++)
+            {
+                if((i % PLY_PROGRESS_STEP) == 0)
+                {
+                    reportParseProgress(data - begin, dataSize);
+                }
+
+                double record[PLY_VERTEX_ATTRIBUTE_COUNT];
+                data = parseVertexRecord(data, end, propertyList, layout, record);
+
+                // Adiciona o vértice na lista de vértices do modelo 3D
+                plyObject->addVertex(new Vertex3D(i, record[PLY_VERTEX_X], record[PLY_VERTEX_Y], record[PLY_VERTEX_Z]));
+                storeVertexAttributes(plyObject, i, record, layout);
+                bounds.add(record[PLY_VERTEX_X], record[PLY_VERTEX_Y], record[PLY_VERTEX_Z]);
+            }
+        }
+        else if((*it).elementName == "face") // Verifica se o elemento é o elemento de faces do modelo 3D
+        {
+            int indexListIndex = getIndexListIndex(propertyList);
+
+            // Índices de todas as faces em sequência (reservados supondo triângulos) e o início de cada face
+            vector<int> vertexIdList;
+            vector<int> faceStartList(elementCount + 1);
+            vertexIdList.reserve(3 * (size_t)elementCount);
+
+            for(int i = 0; i < elementCount; i++)
+            {
+                if((i % PLY_PROGRESS_STEP) == 0)
+                {
+                    reportParseProgress(data - begin, dataSize);
+                }
+
+                faceStartList[i] = vertexIdList.size();
+                data = parseFaceRecord(data, end, propertyList, indexListIndex, vertexIdList);
+            }
+
+            faceStartList[elementCount] = vertexIdList.size();
+
+            // Adiciona as faces ao modelo 3D
+            for(int i = 0; i < elementCount; i++)
+            {
+                addFace(plyObject, &vertexIdList[faceStartList[i]], faceStartList[i + 1] - faceStartList[i]);
+            }
+        }
+        else
+        {
+            // Elementos desconhecidos são pulados valor a valor
+            for(int i = 0; i < elementCount; i++)
+            {
+                data = skipRecord(data, end, propertyList);
+            }
+        }
+    }
+}
+
+bool PLYReader::readAsciiElementsParallel(const char *data, size_t dataSize, PLYObject *plyObject, PLYBounds &bounds)
+{
+    const char *end = data + dataSize;
+
+    list<PLYElement> elementList = plyObject->getElementList();
+    vector<PLYElement> elementVector(elementList.begin(), elementList.end());
+
+    // Linha em que cada elemento começa, supondo um registro por linha
+    vector<int> elementFirstLine(elementVector.size() + 1, 0);
+
+    for(unsigned int i = 0; i < elementVector.size(); i++)
+    {
+        elementFirstLine[i + 1] = elementFirstLine[i] + elementVector[i].elementCount;
+    }
+
+    // Cada elemento é dividido em blocos de linhas com aproximadamente o mesmo tamanho
+    int chunkCount = min((size_t)threadCount, dataSize / PLY_PARALLEL_MIN_CHUNK_SIZE);
+
+    // Primeira linha de cada bloco de cada elemento (elemento i, bloco j na posição i * (chunkCount + 1) + j)
+    vector<int> chunkFirstLine(elementVector.size() * (chunkCount + 1));
+
+    for(unsigned int i = 0; i < elementVector.size(); i++)
+    {
+        for(int j = 0; j <= chunkCount; j++)
+        {
+            chunkFirstLine[i * (chunkCount + 1) + j] = elementFirstLine[i] + (int)((long long)elementVector[i].elementCount * j / chunkCount);
+        }
+    }
+
+    // Primeira etapa da busca paralela de quebras de linha: cada thread conta as quebras de uma faixa de bytes
+    vector<int> rangeLineCount(chunkCount + 1, 0);
+
+    runParallel(chunkCount, [&](int range)
+    {
+        const char *rangeData = data + dataSize * range / chunkCount;
+        const char *rangeEnd = data + dataSize * (range + 1) / chunkCount;
+        int lineCount = 0;
+
+        while((rangeData = (const char*)memchr(rangeData, '\n', rangeEnd - rangeData)) != NULL)
+        {
+            lineCount++;
+            rangeData++;
+        }
+
+        rangeLineCount[range + 1] = lineCount;
+    });
+
+    // Soma de prefixos: quantidade de quebras antes de cada faixa
+    for(int i = 0; i < chunkCount; i++)
+    {
+        rangeLineCount[i + 1] += rangeLineCount[i];
+    }
+
+    // O arquivo pode não terminar com uma quebra de linha
+    int lineCount = rangeLineCount[chunkCount] + ((dataSize > 0) && (end[-1] != '\n'));
+
+    if(lineCount < elementFirstLine[elementVector.size()])
+    {
+        return false;
+    }
+
+    // Segunda etapa: cada thread percorre de novo sua faixa e localiza o início das linhas que iniciam blocos
+    vector<const char*> chunkStart(chunkFirstLine.size(), end);
+
+    runParallel(chunkCount, [&](int range)
+    {
+        const char *rangeData = data + dataSize * range / chunkCount;
+        const char *rangeEnd = data + dataSize * (range + 1) / chunkCount;
+        int line = rangeLineCount[range];
+
+        // A linha 0 começa no início do corpo e a linha n começa após a n-ésima quebra. Como as
+        // primeiras linhas dos blocos estão em ordem, basta acompanhar a próxima a ser encontrada
+        unsigned int next = lower_bound(chunkFirstLine.begin(), chunkFirstLine.end(), (range == 0) ? 0 : line + 1) - chunkFirstLine.begin();
+
+        while((next < chunkFirstLine.size()) && (chunkFirstLine[next] == 0))
+        {
+            chunkStart[next++] = data;
+        }
+
+        while((next < chunkFirstLine.size()) && ((rangeData = (const char*)memchr(rangeData, '\n', rangeEnd - rangeData)) != NULL))
+        {
+            line++;
+            rangeData++;
+
+            while((next < chunkFirstLine.size()) && (chunkFirstLine[next] == line))
+            {
+                chunkStart[next++] = rangeData;
+            }
+        }
+    });
+
+    // Localização das propriedades usadas e buffers de cada bloco de faces
+    PLYVertexLayout layout;
+    vector<int> indexListIndex(elementVector.size(), -1);
+    vector<double> recordList;
+    vector< vector<int> > chunkVertexIdList(chunkCount);
+    vector< vector<int> > chunkFaceStartList(chunkCount);
+    int vertexElement = -1, faceElement = -1;
+
+    for(unsigned int i = 0; i < elementVector.size(); i++)
+    {
+        if((elementVector[i].elementName == "vertex") && (vertexElement < 0))
+        {
+            vertexElement = i;
+            layout = getVertexLayout(elementVector[i].propertyList);
+            recordList.resize(PLY_VERTEX_ATTRIBUTE_COUNT * (size_t)elementVector[i].elementCount);
+        }
+        else if((elementVector[i].elementName == "face") && (faceElement < 0))
+        {
+            faceElement = i;
+            indexListIndex[i] = getIndexListIndex(elementVector[i].propertyList);
+        }
+    }
+
+    // Cada thread lê seu bloco de cada elemento. Se um registro ultrapassar o fim do bloco ou sobrar
+    // conteúdo no bloco, o corpo não está no formato de um registro por linha
+    vector<char> chunkValid(chunkCount, 1);
+
+    runParallel(chunkCount, [&](int chunk)
+    {
+        try
+        {
+            for(unsigned int i = 0; i < elementVector.size(); i++)
+            {
+                const vector<PLYProperty> &propertyList = elementVector[i].propertyList;
+                const char *chunkData = chunkStart[i * (chunkCount + 1) + chunk];
+                const char *chunkEnd = chunkStart[i * (chunkCount + 1) + chunk + 1];
+                int firstRecord = chunkFirstLine[i * (chunkCount + 1) + chunk] - elementFirstLine[i];
+                int lastRecord = chunkFirstLine[i * (chunkCount + 1) + chunk + 1] - elementFirstLine[i];
+
+                for(int j = firstRecord; j < lastRecord; j++)
+                {
+                    if((int)i == vertexElement)
+                    {
+                        chunkData = parseVertexRecord(chunkData, chunkEnd, propertyList, layout, &recordList[PLY_VERTEX_ATTRIBUTE_COUNT * (size_t)j]);
+                    }
+                    else if((int)i == faceElement)
+                    {
+                        chunkFaceStartList[chunk].push_back(chunkVertexIdList[chunk].size());
+                        chunkData = parseFaceRecord(chunkData, chunkEnd, propertyList, indexListIndex[i], chunkVertexIdList[chunk]);
+                    }
+                    else
+                    {
+                        chunkData = skipRecord(chunkData, chunkEnd, propertyList);
+                    }
+                }
+
+                while((chunkData < chunkEnd) && ((*chunkData == ' ') || (*chunkData == '\t') || (*chunkData == '\n') || (*chunkData == '\r')))
+                {
+                    chunkData++;
+                }
+
+                if(chunkData != chunkEnd)
+                {
+                    chunkValid[chunk] = 0;
+                    return;
+                }
+            }
+
+            chunkFaceStartList[chunk].push_back(chunkVertexIdList[chunk].size());
+        }
+        catch(runtime_error &e)
+        {
+            chunkValid[chunk] = 0;
+        }
+    });
+
+    for(int i = 0; i < chunkCount; i++)
+    {
+        if(!chunkValid[i])
+        {
+            return false;
+        }
+    }
+
+    // Os registros já foram lidos; resta criar os vértices e as faces
+    reportProgress(0.6 * PLY_PROGRESS_PARSE);
+
+    // Cria os vértices e as faces em paralelo, cada bloco em suas posições da lista
+    int vertexCount = (vertexElement >= 0) ? elementVector[vertexElement].elementCount : 0;
+    vector<Vertex3D*> vertexList(vertexCount);
+    // Triângulos de cada bloco (polígonos maiores geram mais de um triângulo por face)
+    vector< vector<Primitive*> > chunkFaceList(chunkCount);
+    // Limites dos vértices de cada bloco
+    vector<PLYBounds> chunkBoundsList(chunkCount);
+
+    if(vertexElement >= 0)
+    {
+        prepareVertexAttributes(plyObject, vertexCount, layout);
+    }
+
+    runParallel(chunkCount, [&](int chunk)
+    {
+        for(int i = (long long)vertexCount * chunk / chunkCount; i < (long long)vertexCount * (chunk + 1) / chunkCount; i++)
+        {
+            const double *record = &recordList[PLY_VERTEX_ATTRIBUTE_COUNT * (size_t)i];
+
+            vertexList[i] = new Vertex3D(i, record[PLY_VERTEX_X], record[PLY_VERTEX_Y], record[PLY_VERTEX_Z]);
+            storeVertexAttributes(plyObject, i, record, layout);
+            chunkBoundsList[chunk].add(record[PLY_VERTEX_X], record[PLY_VERTEX_Y], record[PLY_VERTEX_Z]);
+        }
+    });
+
+    runParallel(chunkCount, [&](int chunk)
+    {
+        if(faceElement < 0)
+        {
+            return;
+        }
+
+        const vector<int> &faceStartList = chunkFaceStartList[chunk];
+        chunkFaceList[chunk].reserve(faceStartList.size());
+
+        for(unsigned int i = 0; i + 1 < faceStartList.size(); i++)
+        {
+            createFaces(&vertexList, &chunkVertexIdList[chunk][faceStartList[i]], faceStartList[i + 1] - faceStartList[i], chunkFaceList[chunk]);
+        }
+    });
+
+    reportProgress(0.9 * PLY_PROGRESS_PARSE);
+
+    // Adiciona os vértices e as faces ao modelo 3D na ordem do arquivo
+    for(int i = 0; i < vertexCount; i++)
+    {
+        plyObject->addVertex(vertexList[i]);
+    }
+
+    for(int i = 0; i < chunkCount; i++)
+    {
+        for(unsigned int j = 0; j < chunkFaceList[i].size(); j++)
+        {
+            plyObject->addFace(chunkFaceList[i][j]);
+        }
+
+        bounds.merge(chunkBoundsList[i]);
+    }
+
+    return true;
+}
+
+void PLYReader::readBinaryElements(const char *data, size_t dataSize, PLYObject *plyObject, bool swapBytes, PLYBounds &bounds)
+{
+    size_t offset = 0;
+
+    // Obtém a lista de elementos do arquivo PLY
+    list<PLYElement> elementList = plyObject->getElementList();
+
+    // Para cada elemento do arquivo PLY
+    for(auto it = elementList.begin(); it != elementList.end(); it++)
+    {
+        const vector<PLYProperty> &propertyList = (*it).propertyList;
+        int elementCount = (*it).elementCount;
+
+        // Posição (em bytes) de cada propriedade escalar dentro do registro e tamanho do registro,
+        // válidos apenas quando o elemento não possui listas
+        vector<int> propertyOffsetList(propertyList.size());
+        bool hasList = false;
+        int recordSize = 0;
+
+        for(unsigned int i = 0; i < propertyList.size(); i++)
+        {
+            propertyOffsetList[i] = recordSize;
+
+            if(propertyList[i].isList)
+            {
+                hasList = true;
+            }
+            else
+            {
+                recordSize += getPropertyTypeSize(propertyList[i].propertyType);
+            }
+        }
+
+        if((*it).elementName == "vertex")
+        {
+            // Localiza as propriedades das coordenadas
+            PLYVertexLayout layout = getVertexLayout(propertyList);
+
+            if(hasList)
+            {
+                throw runtime_error("Elemento de vértice PLY não suportado");
+            }
+
+            checkBinarySize(offset, (size_t)recordSize * elementCount, dataSize);
+            prepareVertexAttributes(plyObject, elementCount, layout);
+
+            // Posição das coordenadas e das normais no registro quando cada grupo é formado por três floats seguidos
+            int coordOffset = getFloatTripleOffset(propertyList, layout, propertyOffsetList, PLY_VERTEX_X);
+            int normalOffset = layout.hasNormal ? getFloatTripleOffset(propertyList, layout, propertyOffsetList, PLY_VERTEX_NX) : -1;
+
+            // Caminho rápido: coordenadas (e normais) em float são copiadas em bloco direto para as listas da malha
+            if((coordOffset >= 0) && (!layout.hasNormal || (normalOffset >= 0)) && !layout.hasColor && !layout.hasTexCoord)
+            {
+                vector<float> coordList(3 * (size_t)elementCount);
+                float *normalList = layout.hasNormal ? plyObject->getVertexNormalList()->data() : NULL;
+
+                if((recordSize == 12) && (coordOffset == 0))
+                {
+                    memcpy(coordList.data(), data + offset, 12 * (size_t)elementCount);
+                }
+                else
+                {
+                    for(int i = 0; i < elementCount; i++)
+                    {
+                        const char *record = data + offset + (size_t)recordSize * i;
+
+                        memcpy(&coordList[3 * i], record + coordOffset, 12);
+
+                        if(normalList)
+                        {
+                            memcpy(&normalList[3 * i], record + normalOffset, 12);
+                        }
+                    }
+                }
+
+                if(swapBytes)
+                {
+                    swapBytes4((char*)coordList.data(), 3 * elementCount);
+
+                    if(normalList)
+                    {
+                        swapBytes4((char*)normalList, 3 * elementCount);
+                    }
+                }
+
+                for(int i = 0; i < elementCount; i++)
+                {
+                    plyObject->addVertex(new Vertex3D(i, coordList[3 * i], coordList[3 * i + 1], coordList[3 * i + 2]));
+                    bounds.add(coordList[3 * i], coordList[3 * i + 1], coordList[3 * i + 2]);
+                }
+            }
+            else
+            {
+                for(int i = 0; i < elementCount; i++)
+                {
+                    if((i % PLY_PROGRESS_STEP) == 0)
+                    {
+                        reportParseProgress(offset + (size_t)recordSize * i, dataSize);
+                    }
+
+                    const char *record = data + offset + (size_t)recordSize * i;
+                    double attributeRecord[PLY_VERTEX_ATTRIBUTE_COUNT];
+
+                    for(unsigned int j = 0; j < propertyList.size(); j++)
+                    {
+                        int attribute = layout.attributeIndexList[j];
+
+                        if(attribute >= 0)
+                        {
+                            attributeRecord[attribute] = layout.attributeScaleList[j] * readBinaryValue(record + propertyOffsetList[j], propertyList[j].propertyType, swapBytes);
+                        }
+                    }
+
+                    plyObject->addVertex(new Vertex3D(i, attributeRecord[PLY_VERTEX_X], attributeRecord[PLY_VERTEX_Y], attributeRecord[PLY_VERTEX_Z]));
+                    storeVertexAttributes(plyObject, i, attributeRecord, layout);
+                    bounds.add(attributeRecord[PLY_VERTEX_X], attributeRecord[PLY_VERTEX_Y], attributeRecord[PLY_VERTEX_Z]);
+                }
+            }
+
+            offset += (size_t)recordSize * elementCount;
+        }
+        else if((*it).elementName == "face")
+        {
+            // Localiza a lista de índices dos vértices
+            int indexListIndex = getIndexListIndex(propertyList);
+
+            const PLYProperty &indexProperty = propertyList[indexListIndex];
+            int indexSize = getPropertyTypeSize(indexProperty.propertyType);
+            vector<int> vertexIdList;
+
+            // Caminho rápido: face composta apenas por uma lista uchar de índices int/uint,
+            // cujos índices são copiados em bloco
+            bool fastPath = (propertyList.size() == 1) && (indexProperty.countType == PLY_UCHAR) &&
+                            ((indexProperty.propertyType == PLY_INT) || (indexProperty.propertyType == PLY_UINT));
+
+            for(int i = 0; i < elementCount; i++)
+            {
+                if((i % PLY_PROGRESS_STEP) == 0)
+                {
+                    reportParseProgress(offset, dataSize);
+                }
+
+                if(fastPath)
+                {
+                    checkBinarySize(offset, 1, dataSize);
+                    int vertexCount = (unsigned char)data[offset++];
+
+                    checkBinarySize(offset, 4 * (size_t)vertexCount, dataSize);
+                    vertexIdList.resize(vertexCount);
+                    memcpy(vertexIdList.data(), data + offset, 4 * (size_t)vertexCount);
+                    offset += 4 * (size_t)vertexCount;
+
+                    if(swapBytes)
+                    {
+                        swapBytes4((char*)vertexIdList.data(), vertexCount);
+                    }
+
+                    addFace(plyObject, vertexIdList.data(), vertexCount);
+                    continue;
+                }
+
+                for(unsigned int j = 0; j < propertyList.size(); j++)
+                {
+                    const PLYProperty &property = propertyList[j];
+                    int valueSize = getPropertyTypeSize(property.propertyType);
+
+                    if(!property.isList)
+                    {
+                        checkBinarySize(offset, valueSize, dataSize);
+                        offset += valueSize;
+                        continue;
+                    }
+
+                    int countSize = getPropertyTypeSize(property.countType);
+                    checkBinarySize(offset, countSize, dataSize);
+                    int vertexCount = readListCount(data + offset, property.countType, swapBytes);
+                    offset += countSize;
+
+                    checkBinarySize(offset, (size_t)valueSize * vertexCount, dataSize);
+
+                    if((int)j == indexListIndex)
+                    {
+                        vertexIdList.resize(vertexCount);
+
+                        for(int k = 0; k < vertexCount; k++)
+                        {
+                            vertexIdList[k] = (int)readBinaryValue(data + offset + indexSize * k, property.propertyType, swapBytes);
+                        }
+
+                        addFace(plyObject, vertexIdList.data(), vertexCount);
+                    }
+
+                    offset += (size_t)valueSize * vertexCount;
+                }
+            }
+        }
+        else if(!hasList)
+        {
+            // Elementos desconhecidos sem listas são pulados em bloco
+            checkBinarySize(offset, (size_t)recordSize * elementCount, dataSize);
+            offset += (size_t)recordSize * elementCount;
+        }
+        else
+        {
+            // Elementos desconhecidos com listas são pulados registro a registro
+            for(int i = 0; i < elementCount; i++)
+            {
+                for(unsigned int j = 0; j < propertyList.size(); j++)
+                {
+                    const PLYProperty &property = propertyList[j];
+                    int valueSize = getPropertyTypeSize(property.propertyType);
+                    int valueCount = 1;
+
+                    if(property.isList)
+                    {
+                        int countSize = getPropertyTypeSize(property.countType);
+                        checkBinarySize(offset, countSize, dataSize);
+                        valueCount = readListCount(data + offset, property.countType, swapBytes);
+                        offset += countSize;
+                    }
+
+                    checkBinarySize(offset, (size_t)valueSize * valueCount, dataSize);
+                    offset += (size_t)valueSize * valueCount;
+                }
+            }
+        }
+    }
+}
+
+PLYObject* PLYReader::readHeader(istream &plyStream)
+{
+    // Variáveis temporárias para leitura do arquivo
+    string tmpFileLine;
+    string tmpLineValue;
+    stringstream strStream;
+
+    // Lê a primeira linha do arquivo
+    getline(plyStream, tmpFileLine);
+    strStream.str(tmpFileLine);
+    strStream >> tmpLineValue;
+
+    // Verifica se o arquivo não começa com a linha do "ply"
+    if(tmpLineValue != "ply")
+    {
+        // Lança exceção
+        throw runtime_error("Arquivo PLY inválido");
+    }
+
+    // Lê o formato e a versão do arquivo PLY
+    string fileType, fileVersion;
+    getline(plyStream, tmpFileLine);
+    strStream.clear();
+    strStream.str(tmpFileLine);
+    strStream >> tmpLineValue >> fileType >> fileVersion;
+
+    PLYType plyType;
+
+    // Verifica se o formato é ASCII ou binário
+    if(fileType == "ascii")
+    {
+        plyType = ASCII;
+    }
+    else if(fileType == "binary_little_endian")
+    {
+        plyType = BINARY_LITTLE_ENDIAN;
+    }
+    else if(fileType == "binary_big_endian")
+    {
+        plyType = BINARY_BIG_ENDIAN;
+    }
+    else
+    {
+        // Caso contrário, lança exceção
+        throw runtime_error("Formato de arquivo PLY não suportado");
+    }
+
+    // Cria um novo objeto PLYFile e define o formato e a versão do arquivo PLY
+    // (liberado se o restante do cabeçalho for inválido)
+    unique_ptr<PLYObject> plyObject(new PLYObject());
+    plyObject->setFileFormat(PLYFormatVersion(plyType, fileVersion));
+
+    // Elementos do cabeçalho (as propriedades são associadas ao último elemento declarado)
+    list<PLYElement> elementList;
+
+    // Faz a leitura linha a linha do cabeçalho do arquivo PLY
+    while(getline(plyStream, tmpFileLine))
+    {
+        strStream.clear();
+        strStream.str(tmpFileLine);
+        strStream >> tmpLineValue;
+
+        // Verifica se a linha é de comentário
+        if(tmpLineValue == "comment")
+        {
+            // Caso seja, obtém o comentário
+            getline(strStream, tmpLineValue);
+            tmpLineValue.erase(tmpLineValue.begin());
+
+            // Adiciona o comentário na lista de comentários do arquivo PLY
+            plyObject->addComment(tmpLineValue);
+        }
+        else if(tmpLineValue == "element") // Verifica se a linha é de elemento
+        {
+            // Faz a leitura do elemento e da quantidade de elementos no arquivo PLY
+            string elementName;
+            int elementCount;
+            strStream >> elementName >> elementCount;
+
+            if(strStream.fail() || (elementCount < 0))
+            {
+                throw runtime_error("Quantidade de elementos inválida no arquivo PLY");
+            }
+
+            elementList.push_back(PLYElement(elementName, elementCount));
+        }
+        else if(tmpLineValue == "property") // Verifica se a linha é de propriedade
+        {
+            if(elementList.empty())
+            {
+                throw runtime_error("Propriedade PLY fora de um elemento");
+            }
+
+            // Faz a leitura do tipo e do nome da propriedade (ou dos tipos do contador e dos itens, no caso de lista)
+            string propertyType, propertyName;
+            strStream >> propertyType;
+
+            if(propertyType == "list")
+            {
+                string countType;
+                strStream >> countType >> propertyType >> propertyName;
+
+                elementList.back().propertyList.push_back(PLYProperty(propertyName, parsePropertyType(countType), parsePropertyType(propertyType)));
+            }
+            else
+            {
+                strStream >> propertyName;
+
+                elementList.back().propertyList.push_back(PLYProperty(propertyName, parsePropertyType(propertyType)));
+            }
+        }
+        else if(tmpLineValue == "end_header") // Verifica se a linha é de fim de comentário
+        {
+            // Termina a leitura do cabeçalho do arquivo PLY
+            break;
+        }
+    }
+
+    // Adiciona os elementos na lista de elementos do arquivo PLY e reserva espaço para a malha
+    int vertexCount = 0, faceCount = 0;
+
+    for(auto it = elementList.begin(); it != elementList.end(); it++)
+    {
+        plyObject->addElement(*it);
+
+        if((*it).elementName == "vertex")
+        {
+            vertexCount = (*it).elementCount;
+        }
+        else if((*it).elementName == "face")
+        {
+            faceCount = (*it).elementCount;
+        }
+    }
+
+    plyObject->reserve(vertexCount, faceCount);
+
+    return plyObject.release();
+}
+
+string PLYReader::getCacheSettings()
+{
+    string settings = "ply hulls=" + to_string(hullMaxVertices > 0 ? hullMaxVertices : 0) + "x" + to_string(hullCount);
+
+    if(weldEnabled)
+    {
+        char weldSettings[32];
+        snprintf(weldSettings, sizeof(weldSettings), " weld=%.9g/attr", weldEpsilon);
+        settings += weldSettings;
+    }
+
+    return settings;
+}
+
+PLYObject* PLYReader::readCachedObject(MeshCache &meshCache)
+{
+    size_t headerSize, positionCount, indexCount, normalCount, colorCount, texCoordCount, boundsCount, hullSizeCount, hullVertexCount, acmrCount, weldCount;
+
+    const char *headerData = meshCache.getBlock<char>(MESH_CACHE_HEADER, headerSize);
+    const double *positionList = meshCache.getBlock<double>(MESH_CACHE_POSITION, positionCount);
+    const uint32_t *indexList = meshCache.getBlock<uint32_t>(MESH_CACHE_INDEX, indexCount);
+    const float *normalList = meshCache.getBlock<float>(MESH_CACHE_NORMAL, normalCount);
+    const float *colorList = meshCache.getBlock<float>(MESH_CACHE_COLOR, colorCount);
+    const float *texCoordList = meshCache.getBlock<float>(MESH_CACHE_TEXCOORD, texCoordCount);
+    const double *bounds = meshCache.getBlock<double>(MESH_CACHE_BOUNDS, boundsCount);
+    const uint32_t *hullSizeList = meshCache.getBlock<uint32_t>(MESH_CACHE_HULL_SIZE, hullSizeCount);
+    const double *hullVertexList = meshCache.getBlock<double>(MESH_CACHE_HULL_VERTEX, hullVertexCount);
+    const double *acmr = meshCache.getBlock<double>(MESH_CACHE_ACMR, acmrCount);
+    const uint32_t *weldedVertexCount = meshCache.getBlock<uint32_t>(MESH_CACHE_WELD, weldCount);
+
+    // Verifica a consistência dos blocos antes de criar o objeto
+    size_t vertexCount = positionCount / 3;
+
+    if(!headerData || (positionCount % 3 != 0) || (indexCount % 3 != 0) || (boundsCount != 6) || (acmrCount != 2) || (weldCount != 1) ||
+       ((normalCount != 0) && (normalCount != 3 * vertexCount)) ||
+       ((colorCount != 0) && (colorCount != 3 * vertexCount)) ||
+       ((texCoordCount != 0) && (texCoordCount != 2 * vertexCount)))
+    {
+        return NULL;
+    }
+
+    for(size_t i = 0; i < indexCount; i++)
+    {
+        if(indexList[i] >= vertexCount)
+        {
+            return NULL;
+        }
+    }
+
+    size_t hullVertexTotal = 0;
+
+    for(size_t i = 0; i < hullSizeCount; i++)
+    {
+        hullVertexTotal += hullSizeList[i];
+    }
+
+    if(3 * hullVertexTotal != hullVertexCount)
+    {
+        return NULL;
+    }
+
+    // O cabeçalho original (algumas linhas) é lido de novo para restaurar os elementos do arquivo
+    istringstream headerStream(string(headerData, headerSize));
+    unique_ptr<PLYObject> plyObject(readHeader(headerStream));
+
+    plyObject->reserve(vertexCount, indexCount / 3);
+
+    for(size_t i = 0; i < vertexCount; i++)
+    {
+        plyObject->addVertex(new Vertex3D(i, positionList[3 * i], positionList[3 * i + 1], positionList[3 * i + 2]));
+    }
+
+    vector<Vertex3D*> *vertexList = plyObject->getVertexList();
+
+    for(size_t i = 0; i < indexCount; i += 3)
+    {
+        plyObject->addFace(new Triangle(vertexList->at(indexList[i]), vertexList->at(indexList[i + 1]), vertexList->at(indexList[i + 2])));
+    }
+
+    plyObject->getVertexNormalList()->assign(normalList, normalList + normalCount);
+    plyObject->getVertexColorList()->assign(colorList, colorList + colorCount);
+    plyObject->getVertexTexCoordList()->assign(texCoordList, texCoordList + texCoordCount);
+
+    plyObject->setExtents(bounds, bounds + 3);
+    plyObject->setVertexCacheStats(acmr[0], acmr[1]);
+    plyObject->setWeldedVertexCount(*weldedVertexCount);
+
+    for(size_t i = 0; i < hullSizeCount; i++)
+    {
+        plyObject->addConvexHull(vector<double>(hullVertexList, hullVertexList + 3 * hullSizeList[i]));
+        hullVertexList += 3 * hullSizeList[i];
+    }
+
+    return plyObject.release();
+}
+
+void PLYReader::saveCachedObject(MeshCache &meshCache, PLYObject *plyObject, const char *headerData, size_t headerSize)
+{
+    vector<Vertex3D*> *vertexList = plyObject->getVertexList();
+    vector<Primitive*> *faceList = plyObject->getFaceList();
+
+    vector<double> positionList(3 * vertexList->size());
+    vector<uint32_t> indexList(3 * faceList->size());
+
+    for(unsigned int i = 0; i < vertexList->size(); i++)
+    {
+        positionList[3 * i] = vertexList->at(i)->getX();
+        positionList[3 * i + 1] = vertexList->at(i)->getY();
+        positionList[3 * i + 2] = vertexList->at(i)->getZ();
+    }
+
+    for(unsigned int i = 0; i < faceList->size(); i++)
+    {
+        vector<Vertex3D*> *faceVertexList = faceList->at(i)->getVertexList();
+
+        // Todas as faces importadas são triângulos; outra malha não é guardada no cache
+        if(faceVertexList->size() != 3)
+        {
+            return;
+        }
+
+        for(int j = 0; j < 3; j++)
+        {
+            indexList[3 * i + j] = faceVertexList->at(j)->getId();
+        }
+    }
+
+    double bounds[6];
+    plyObject->getExtents(bounds, bounds + 3);
+
+    double acmr[2];
+    plyObject->getVertexCacheStats(acmr[0], acmr[1]);
+
+    uint32_t weldedVertexCount = plyObject->getWeldedVertexCount();
+
+    vector<uint32_t> hullSizeList;
+    vector<double> hullVertexList;
+
+    for(int i = 0; i < plyObject->getConvexHullCount(); i++)
+    {
+        vector<double> vertexList;
+        plyObject->getConvexHullVertexList(i, vertexList);
+
+        hullSizeList.push_back(vertexList.size() / 3);
+        hullVertexList.insert(hullVertexList.end(), vertexList.begin(), vertexList.end());
+    }
+
+    meshCache.addBlock(MESH_CACHE_HEADER, headerData, headerSize);
+    meshCache.addBlock(MESH_CACHE_POSITION, positionList);
+    meshCache.addBlock(MESH_CACHE_INDEX, indexList);
+    meshCache.addBlock(MESH_CACHE_NORMAL, *plyObject->getVertexNormalList());
+    meshCache.addBlock(MESH_CACHE_COLOR, *plyObject->getVertexColorList());
+    meshCache.addBlock(MESH_CACHE_TEXCOORD, *plyObject->getVertexTexCoordList());
+    meshCache.addBlock(MESH_CACHE_BOUNDS, bounds, sizeof(bounds));
+    meshCache.addBlock(MESH_CACHE_HULL_SIZE, hullSizeList);
+    meshCache.addBlock(MESH_CACHE_HULL_VERTEX, hullVertexList);
+    meshCache.addBlock(MESH_CACHE_ACMR, acmr, sizeof(acmr));
+    meshCache.addBlock(MESH_CACHE_WELD, &weldedVertexCount, sizeof(weldedVertexCount));
+
+    meshCache.save();
+}
+
 PLYObject* PLYReader::read_ply_file(string ply_filepath)
 {
-    // Abre o arquivo PLY
-    ifstream plyFileStream(ply_filepath.c_str());
+    MeshCache meshCache(ply_filepath, getCacheSettings());
+
+    reportProgress(0.0);
+
+    // Usa a malha já processada se o cache estiver atualizado
+    if(cacheEnabled && meshCache.load())
+    {
+        PLYObject *plyObject = readCachedObject(meshCache);
+
+        if(plyObject)
+        {
+            reportProgress(1.0);
+            return plyObject;
+        }
+    }
+
+    // Abre o arquivo PLY (em modo binário, pois o corpo pode não ser texto)
+    ifstream plyFileStream(ply_filepath.c_str(), ios::in | ios::binary);
 
     // Verifica se o arquivo não foi aberto
     if(!plyFileStream.is_open())
@@ -14,186 +1542,380 @@ PLYObject* PLYReader::read_ply_file(string ply_filepath)
         throw runtime_error("Não foi possível abrir o arquivo PLY");
     }
 
-    // Variáveis temporárias para leitura do arquivo
-    string tmpFileLine;
-    string tmpLineValue;
-    stringstream strStream;
+    // O objeto é liberado se a leitura ou o processamento falharem
+    unique_ptr<PLYObject> plyObject(readHeader(plyFileStream));
 
-    // Lê a primeira linha do arquivo
-    getline(plyFileStream, tmpFileLine);
-    strStream.str(tmpFileLine);
-    strStream >> tmpLineValue;
+    // Posição do corpo do arquivo, logo após o cabeçalho
+    size_t bodyOffset = (size_t)plyFileStream.tellg();
 
-    // Verifica se o arquivo não começa com a linha do "ply"
-    if(tmpLineValue != "ply")
+    // Fecha o arquivo PLY, cujo corpo é lido diretamente do arquivo mapeado em memória
+    plyFileStream.close();
+
+    MappedFile mappedFile(ply_filepath);
+
+    if(bodyOffset > mappedFile.getSize())
     {
-        // Lança exceção
-        throw runtime_error("Arquivo PLY inválido");
+        throw runtime_error("Arquivo PLY incompleto");
     }
 
-    // Cria um novo objeto PLYFile
-    PLYObject *plyObject = new PLYObject();
+    const char *body = mappedFile.getData() + bodyOffset;
+    size_t bodySize = mappedFile.getSize() - bodyOffset;
 
-    // Lê o formato e a versão do arquivo PLY
-    string fileType, fileVersion;
-    getline(plyFileStream, tmpFileLine);
-    strStream.clear();
-    strStream.str(tmpFileLine);
-    strStream >> tmpLineValue >> fileType >> fileVersion;
+    PLYType plyType = plyObject->getFileFormat().plyType;
+    // Limites dos vértices, acumulados durante a leitura
+    PLYBounds bounds;
 
-    // Verifica se o formato é ASCII
-    if(fileType == "ascii")
+    if(plyType == ASCII)
     {
-        // Caso seja, define o formato como ASCII e a versão do arquivo PLY
-        plyObject->setFileFormat(PLYFormatVersion(ASCII, fileVersion));
+        readAsciiElements(body, bodySize, plyObject.get(), bounds);
     }
     else
     {
-        // Caso contrário, lança exceção
-        throw runtime_error("Formato de arquivo PLY não suportado");
+        readBinaryElements(body, bodySize, plyObject.get(), isByteSwapped(plyType), bounds);
     }
 
-    // Faz a leitura linha a linha do cabeçalho do arquivo PLY
-    while(getline(plyFileStream, tmpFileLine))
+    // Reescala o objeto para o intervalo [-1.0, 1.0] em todos os eixos com os limites já conhecidos,
+    // sem percorrer os vértices para obtê-los de novo
+    plyObject->rescaling(bounds.min, bounds.max);
+
+    reportProgress(PLY_PROGRESS_PARSE);
+
+    // Solda os vértices repetidos (ex.: gravados uma vez por face) antes das etapas que dependem da topologia
+    if(weldEnabled)
     {
-        strStream.clear();
-        strStream.str(tmpFileLine);
-        strStream >> tmpLineValue;
+        plyObject->setWeldedVertexCount(plyObject->weldVertices(weldEpsilon));
+    }
 
-        // Verifica se a linha é de comentário
-        if(tmpLineValue == "comment")
-        {
-            // Caso seja, obtém o comentário
-            getline(strStream, tmpLineValue);
-            tmpLineValue.erase(tmpLineValue.begin());
+    // Reordena os triângulos e os vértices para aproveitar a cache de vértices transformados
+    double acmrBefore, acmrAfter;
 
-            // Adiciona o comentário na lista de comentários do arquivo PLY
-            plyObject->addComment(tmpLineValue);
-        }
-        else if(tmpLineValue == "element") // Verifica se a linha é de elemento
-        {
-            // Faz a leitura do elemento e da quantidade de elementos no arquivo PLY
-            string elementName;
-            int elementCount;
-            strStream >> elementName >> elementCount;
+    if(plyObject->optimizeVertexCache(acmrBefore, acmrAfter))
+    {
+        plyObject->setVertexCacheStats(acmrBefore, acmrAfter);
+    }
 
-            // Adiciona o elemento na lista de elementos do arquivo PLY
-            plyObject->addElement(PLYElement(elementName, elementCount));
-        }
-        else if(tmpLineValue == "end_header") // Verifica se a linha é de fim de comentário
-        {
-            // Termina a leitura do cabeçalho do arquivo PLY
-            break;
-        }
+    // Gera as envoltórias convexas usadas como aproximação de colisão
+    if(hullMaxVertices > 0)
+    {
+        plyObject->buildConvexHulls(hullMaxVertices, hullCount);
     }
 
-    // Obtém a lista de elementos do arquivo PLY
+    // Guarda a malha processada para as próximas leituras do mesmo arquivo
+    if(cacheEnabled)
+    {
+        saveCachedObject(meshCache, plyObject.get(), mappedFile.getData(), bodyOffset);
+    }
+
+    reportProgress(1.0);
+
+    // Retorna o arquivo PLY lido
+    return plyObject.release();
+}
+
+void PLYReader::streamElements(FileWindow &window, PLYObject *plyObject, bool verticesOnly,
+                               const function<void(const double*)> &vertexCallback,
+                               const function<void(const int*, int)> &faceCallback)
+{
+    bool ascii = (plyObject->getFileFormat().plyType == ASCII);
+    bool swapBytes = isByteSwapped(plyObject->getFileFormat().plyType);
+
     list<PLYElement> elementList = plyObject->getElementList();
 
-    // Para cada elemento do arquivo PLY
-    for(auto  it = elementList.begin(); it != elementList.end(); it++)
+    for(auto it = elementList.begin(); it != elementList.end(); it++)
     {
-        // Verifica se o elemento é o elemento de vértices do modelo 3D
-        if((*it).elementName == "vertex")
-        {
-            // Obtém a quantidade de elementos de vértices do arquivo PLY
-            int elementCount = (*it).elementCount;
+        const vector<PLYProperty> &propertyList = (*it).propertyList;
+        int elementCount = (*it).elementCount;
 
-            // Para cada elemento de vértice
-            for(int i = 0; i < elementCount; i++)
-            {
-                // Faz a leitura da linha de um vértice
-                getline(plyFileStream, tmpFileLine);
+        bool isVertex = ((*it).elementName == "vertex");
+        bool isFace = ((*it).elementName == "face");
 
-                // Faz a leitura das coordenadas x, y e z do vértice
-                double x, y, z;
-                strStream.clear();
-                strStream.str(tmpFileLine);
-                strStream >> x >> y >> z;
+        PLYVertexLayout layout;
+        int indexListIndex = -1;
 
-                // Adiciona o vértice na lista de vértices do modelo 3D
-                plyObject->addVertex(new Vertex3D(i, x, y, z));
-            }
+        if(isVertex)
+        {
+            layout = getVertexLayout(propertyList);
         }
-        else if((*it).elementName == "face") // Verifica se o elemento é o elemento de faces do modelo 3D
+        else if(isFace)
         {
-            // Obtém a lista de vértices do modelo 3D
-            vector<Vertex3D*>* vertexList = plyObject->getVertexList();
-            // Obtém a quantidade de elementos de face do arquivo PLY
-            int elementCount = (*it).elementCount;
+            indexListIndex = getIndexListIndex(propertyList);
+        }
 
-            // Para cada elemento de face do arquivo PLY
-            for(int i = 0; i < elementCount; i++)
-            {
-                // Faz a leitura da linha do elemento de face do arquivo PLY
-                getline(plyFileStream, tmpFileLine);
+        double record[PLY_VERTEX_ATTRIBUTE_COUNT];
+        vector<int> vertexIdList;
 
-                // Faz a leitura da quantidade de vértices que compõe a face
-                int v_Count;
-                strStream.clear();
-                strStream.str(tmpFileLine);
-                strStream >> v_Count;
+        for(int i = 0; i < elementCount; i++)
+        {
+            vertexIdList.clear();
 
-                // Instancia um vetor de identificadores de vértices
-                int v_Id_arr[v_Count];
-                int v_Id;
+            if(ascii)
+            {
+                const char *line, *lineEnd;
 
-                // Faz a leitura de cada identificador de vértice
-                for(int j = 0; j < v_Count; j++)
+                // Obtém a próxima linha não vazia, que contém o registro inteiro
+                do
                 {
-                    strStream >> v_Id;
-                    v_Id_arr[j] = v_Id;
+                    if(!window.nextLine(line, lineEnd))
+                    {
+                        throw runtime_error("Arquivo PLY incompleto");
+                    }
+
+                    while((line < lineEnd) && ((*line == ' ') || (*line == '\t') || (*line == '\r')))
+                    {
+                        line++;
+                    }
                 }
+                while(line == lineEnd);
 
-                // Verifica se a quantidade de vértices é a de um triângulo
-                if(v_Count == 3)
+                if(isVertex)
                 {
-                    // Obtém os vértices a partir dos índices
-                    Vertex3D *v0 = vertexList->at(v_Id_arr[0]);
-                    Vertex3D *v1 = vertexList->at(v_Id_arr[1]);
-                    Vertex3D *v2 = vertexList->at(v_Id_arr[2]);
-
-                    // Adiciona uma face triângular
-                    plyObject->addFace(new Triangle(v0, v1, v2));
+                    parseVertexRecord(line, lineEnd, propertyList, layout, record);
                 }
-                else if(v_Count == 4) // Verifica se a quantidade de vértices é a de um quadrado
+                else if(isFace)
                 {
-                    // Obtém os vértices a partir dos índices
-                    Vertex3D *v0 = vertexList->at(v_Id_arr[0]);
-                    Vertex3D *v1 = vertexList->at(v_Id_arr[1]);
-                    Vertex3D *v2 = vertexList->at(v_Id_arr[2]);
-                    Vertex3D *v3 = vertexList->at(v_Id_arr[3]);
-
-                    // Adiciona uma face quadrada
-                    plyObject->addFace(new Quad(v0, v1, v2, v3));
+                    parseFaceRecord(line, lineEnd, propertyList, indexListIndex, vertexIdList);
                 }
-                else if(v_Count == 5) // Verifica se a quantidade de vértices é a de um quadrado
+            }
+            else
+            {
+                for(unsigned int j = 0; j < propertyList.size(); j++)
                 {
-                    // Obtém os vértices a partir dos índices
-                    Primitive *primitive = new Primitive();
-                    primitive->addVertex(vertexList->at(v_Id_arr[0]));
-                    primitive->addVertex(vertexList->at(v_Id_arr[1]));
-                    primitive->addVertex(vertexList->at(v_Id_arr[2]));
-                    primitive->addVertex(vertexList->at(v_Id_arr[3]));
-                    primitive->addVertex(vertexList->at(v_Id_arr[4]));
+                    const PLYProperty &property = propertyList[j];
+                    int valueSize = getPropertyTypeSize(property.propertyType);
 
-                    plyObject->addFace(primitive);
-                }
-                else
-                {
-                    // Caso contrário, lança exceção
-                    throw runtime_error("Primitiva não suportada");
+                    if(!property.isList)
+                    {
+                        if(!window.require(valueSize))
+                        {
+                            throw runtime_error("Arquivo PLY incompleto");
+                        }
+
+                        if(isVertex && (layout.attributeIndexList[j] >= 0))
+                        {
+                            record[layout.attributeIndexList[j]] = layout.attributeScaleList[j] * readBinaryValue(window.getData(), property.propertyType, swapBytes);
+                        }
+
+                        window.consume(valueSize);
+                        continue;
+                    }
+
+                    int countSize = getPropertyTypeSize(property.countType);
+
+                    if(!window.require(countSize))
+                    {
+                        throw runtime_error("Arquivo PLY incompleto");
+                    }
+
+                    int valueCount = readListCount(window.getData(), property.countType, swapBytes);
+                    window.consume(countSize);
+
+                    // Os itens da lista são lidos um a um, pois a lista inteira pode não caber na janela
+                    for(int k = 0; k < valueCount; k++)
+                    {
+                        if(!window.require(valueSize))
+                        {
+                            throw runtime_error("Arquivo PLY incompleto");
+                        }
+
+                        if(isFace && ((int)j == indexListIndex))
+                        {
+                            vertexIdList.push_back((int)readBinaryValue(window.getData(), property.propertyType, swapBytes));
+                        }
+
+                        window.consume(valueSize);
+                    }
                 }
             }
+
+            if(isVertex && vertexCallback)
+            {
+                vertexCallback(record);
+            }
+            else if(isFace && faceCallback)
+            {
+                faceCallback(vertexIdList.data(), vertexIdList.size());
+            }
+        }
+
+        if(isVertex && verticesOnly)
+        {
+            return;
+        }
+    }
+}
+
+size_t PLYReader::estimateMemorySize(string ply_filepath, bool compact)
+{
+    ifstream plyFileStream(ply_filepath.c_str(), ios::in | ios::binary);
+
+    if(!plyFileStream.is_open())
+    {
+        throw runtime_error("Não foi possível abrir o arquivo PLY");
+    }
+
+    unique_ptr<PLYObject> headerObject(readHeader(plyFileStream));
+    list<PLYElement> elementList = headerObject->getElementList();
+    size_t memorySize = 0;
+
+    for(auto it = elementList.begin(); it != elementList.end(); it++)
+    {
+        if((*it).elementName == "vertex")
+        {
+            memorySize += (size_t)(*it).elementCount * (compact ? PLY_COMPACT_VERTEX_MEMORY_SIZE : PLY_VERTEX_MEMORY_SIZE);
+        }
+        else if((*it).elementName == "face")
+        {
+            memorySize += (size_t)(*it).elementCount * (compact ? PLY_COMPACT_FACE_MEMORY_SIZE : PLY_FACE_MEMORY_SIZE);
         }
     }
 
-    // Fecha o arquivo PLY
+    return memorySize;
+}
+
+void PLYReader::stream_ply_file(string ply_filepath, PLYStreamHandler *handler)
+{
+    ifstream plyFileStream(ply_filepath.c_str(), ios::in | ios::binary);
+
+    if(!plyFileStream.is_open())
+    {
+        throw runtime_error("Não foi possível abrir o arquivo PLY");
+    }
+
+    // O objeto lido do cabeçalho guarda apenas a descrição dos elementos
+    unique_ptr<PLYObject> headerObject(readHeader(plyFileStream));
+    size_t bodyOffset = (size_t)plyFileStream.tellg();
+
     plyFileStream.close();
 
-    // Reescala o objeto para o intervalo [-1.0, 1.0] em todos os eixos
-    plyObject->rescaling();
+    int vertexCount = 0, faceCount = 0;
+    list<PLYElement> elementList = headerObject->getElementList();
 
-    // Retorna o arquivo PLY lido
-    return plyObject;
+    for(auto it = elementList.begin(); it != elementList.end(); it++)
+    {
+        if((*it).elementName == "vertex")
+        {
+            vertexCount = (*it).elementCount;
+        }
+        else if((*it).elementName == "face")
+        {
+            faceCount = (*it).elementCount;
+        }
+    }
+
+    FileWindow window(ply_filepath, streamWindowSize);
+
+    // Primeira passada: limites dos vértices
+    PLYBounds bounds;
+
+    window.seek(bodyOffset);
+    streamElements(window, headerObject.get(), true, [&](const double *record)
+    {
+        bounds.add(record[PLY_VERTEX_X], record[PLY_VERTEX_Y], record[PLY_VERTEX_Z]);
+    }, function<void(const int*, int)>());
+
+    reportProgress(0.5 * PLY_PROGRESS_PARSE);
+
+    // Normalização igual à de Object::rescaling: centraliza na origem e leva o maior eixo para [-1, 1]
+    double center[3], extent = 0.0;
+
+    for(int k = 0; k < 3; k++)
+    {
+        center[k] = (bounds.min[k] + bounds.max[k]) / 2.0;
+        extent = std::max(extent, bounds.max[k] - bounds.min[k]);
+    }
+
+    double normalizeScale = (extent > 0.0) ? (2.0 / extent) : 1.0;
+
+    handler->beginMesh(vertexCount, faceCount, bounds.min, bounds.max);
+
+    // Segunda passada: vértices e triângulos entregues em lotes
+    vector<short> positionBatch;
+    vector<unsigned int> triangleBatch;
+
+    positionBatch.reserve(3 * PLY_STREAM_BATCH_SIZE);
+    triangleBatch.reserve(3 * PLY_STREAM_BATCH_SIZE + 3);
+
+    window.seek(bodyOffset);
+    streamElements(window, headerObject.get(), false, [&](const double *record)
+    {
+        for(int k = 0; k < 3; k++)
+        {
+            double value = (record[k] - center[k]) * normalizeScale;
+            value = std::min(1.0, std::max(-1.0, value));
+
+            positionBatch.push_back((short)lround(value * VERTEX_QUANTIZATION_SCALE));
+        }
+
+        if(positionBatch.size() >= 3 * PLY_STREAM_BATCH_SIZE)
+        {
+            handler->addVertexBatch(positionBatch.data(), positionBatch.size() / 3);
+            positionBatch.clear();
+        }
+    }, [&](const int *vertexIdList, int faceVertexCount)
+    {
+        if(faceVertexCount < 3)
+        {
+            throw runtime_error("Primitiva não suportada");
+        }
+
+        for(int k = 0; k < faceVertexCount; k++)
+        {
+            if((vertexIdList[k] < 0) || (vertexIdList[k] >= vertexCount))
+            {
+                throw runtime_error("Índice de vértice PLY inválido");
+            }
+        }
+
+        // Sem as posições dos vértices em memória, as faces maiores são divididas em leque
+        for(int k = 2; k < faceVertexCount; k++)
+        {
+            triangleBatch.push_back(vertexIdList[0]);
+            triangleBatch.push_back(vertexIdList[k - 1]);
+            triangleBatch.push_back(vertexIdList[k]);
+
+            if(triangleBatch.size() >= 3 * PLY_STREAM_BATCH_SIZE)
+            {
+                handler->addTriangleBatch(triangleBatch.data(), triangleBatch.size() / 3);
+                triangleBatch.clear();
+            }
+        }
+    });
+
+    if(!positionBatch.empty())
+    {
+        handler->addVertexBatch(positionBatch.data(), positionBatch.size() / 3);
+    }
+
+    if(!triangleBatch.empty())
+    {
+        handler->addTriangleBatch(triangleBatch.data(), triangleBatch.size() / 3);
+    }
+
+    reportProgress(PLY_PROGRESS_PARSE);
+
+    handler->endMesh();
+}
+
+PLYObject* PLYReader::stream_ply_object(string ply_filepath)
+{
+    PLYMeshBuffer meshBuffer;
+    stream_ply_file(ply_filepath, &meshBuffer);
+
+    // O objeto não tem vértices próprios: desenho, limites e envoltórias usam a malha compacta
+    unique_ptr<PLYObject> plyObject(new PLYObject());
+    plyObject->setQuantizedMesh(meshBuffer.getQuantizedMesh());
+
+    double acmrBefore, acmrAfter;
+    meshBuffer.getVertexCacheStats(acmrBefore, acmrAfter);
+    plyObject->setVertexCacheStats(acmrBefore, acmrAfter);
+
+    // Gera as envoltórias convexas usadas como aproximação de colisão
+    if(hullMaxVertices > 0)
+    {
+        plyObject->buildConvexHulls(hullMaxVertices, hullCount);
+    }
+
+    reportProgress(1.0);
+
+    return plyObject.release();
 }
@@ -37,6 +37,11 @@ int Primitive::getVertexCount()
     return this->vertexList.size();
 }
 
+Vertex3D* Primitive::getNormalVector()
+{
+    return &this->normalVector;
+}
+
 void Primitive::addTextureVertex(Vertex3D* vertex)
 {
     this->textureVertexList.push_back(vertex);
@@ -246,7 +251,7 @@ void Primitive::drawPrimitive(bool wireframe)
             }
             else
             {
-                glPrimitive = GL_POLYGON;
+                glPrimitive = GL_TRIANGLES;
                 RGBColor color = getColor();
                 glColor3d(color.r, color.g, color.b);
             }
@@ -254,9 +259,22 @@ void Primitive::drawPrimitive(bool wireframe)
             glNormal3d(normalVector.getX(), normalVector.getY(), normalVector.getZ());
 
             glBegin(glPrimitive);
-                for(unsigned int i = 0; i < vertexList.size(); i++)
+                if(wireframe)
+                {
+                    for(unsigned int i = 0; i < vertexList.size(); i++)
+                    {
+                        glVertex3d(vertexList[i]->getX(), vertexList[i]->getY(), vertexList[i]->getZ());
+                    }
+                }
+                else
                 {
-                    glVertex3d(vertexList[i]->getX(), vertexList[i]->getY(), vertexList[i]->getZ());
+                    // Polígono convexo dividido em leque a partir do primeiro vértice
+                    for(unsigned int i = 2; i < vertexList.size(); i++)
+                    {
+                        glVertex3d(vertexList[0]->getX(), vertexList[0]->getY(), vertexList[0]->getZ());
+                        glVertex3d(vertexList[i - 1]->getX(), vertexList[i - 1]->getY(), vertexList[i - 1]->getZ());
+                        glVertex3d(vertexList[i]->getX(), vertexList[i]->getY(), vertexList[i]->getZ());
+                    }
                 }
             glEnd();
             break;
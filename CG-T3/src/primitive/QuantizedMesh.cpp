@@ -0,0 +1,382 @@
+#include "primitive/QuantizedMesh.h"
+#include "collision/MeshBVH.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+QuantizedMesh::QuantizedMesh()
+{
+    for(int k = 0; k < 3; k++)
+    {
+        this->positionOffset[k] = 0.0f;
+        this->positionScale[k] = 1.0f / VERTEX_QUANTIZATION_SCALE;
+        this->min[k] = 0.0;
+        this->max[k] = 0.0;
+    }
+
+    for(int k = 0; k < 2; k++)
+    {
+        this->texCoordOffset[k] = 0.0f;
+        this->texCoordScale[k] = 1.0f / VERTEX_QUANTIZATION_SCALE;
+    }
+}
+
+void QuantizedMesh::updateBounds()
+{
+    for(int k = 0; k < 3; k++)
+    {
+        short minValue = 0, maxValue = 0;
+
+        for(size_t i = 0; i < positionList.size(); i += 3)
+        {
+            minValue = (i == 0) ? positionList[k] : std::min(minValue, positionList[i + k]);
+            maxValue = (i == 0) ? positionList[k] : std::max(maxValue, positionList[i + k]);
+        }
+
+        min[k] = positionOffset[k] + minValue * (double)positionScale[k];
+        max[k] = positionOffset[k] + maxValue * (double)positionScale[k];
+    }
+}
+
+void QuantizedMesh::getTriangleNormal(int idTriangle, float normal[3])
+{
+    const short *p0 = &positionList[3 * (size_t)indexList[3 * (size_t)idTriangle]];
+    const short *p1 = &positionList[3 * (size_t)indexList[3 * (size_t)idTriangle + 1]];
+    const short *p2 = &positionList[3 * (size_t)indexList[3 * (size_t)idTriangle + 2]];
+
+    float u[3], v[3];
+
+    for(int k = 0; k < 3; k++)
+    {
+        u[k] = ((float)p1[k] - p0[k]) * positionScale[k];
+        v[k] = ((float)p2[k] - p0[k]) * positionScale[k];
+    }
+
+    normal[0] = u[1] * v[2] - u[2] * v[1];
+    normal[1] = u[2] * v[0] - u[0] * v[2];
+    normal[2] = u[0] * v[1] - u[1] * v[0];
+}
+
+void QuantizedMesh::clearAttributes()
+{
+    normalList.clear();
+    faceNormalList.clear();
+    colorList.clear();
+    texCoordList.clear();
+}
+
+void QuantizedMesh::setGeometry(const float *positionList, size_t vertexCount, const vector<unsigned int> &indexList)
+{
+    // A escala uniforme preserva as proporções e, portanto, as normais da malha
+    this->positionList.resize(3 * vertexCount);
+    VertexQuantizer::quantize(positionList, vertexCount, 3, true, this->positionList.data(), positionOffset, positionScale);
+
+    this->indexList = indexList;
+    clearAttributes();
+
+    updateBounds();
+}
+
+void QuantizedMesh::setQuantizedGeometry(vector<short> &positionList, const float offset[3], const float scale[3], vector<unsigned int> &indexList)
+{
+    this->positionList.clear();
+    this->positionList.swap(positionList);
+    this->positionList.shrink_to_fit();
+
+    this->indexList.clear();
+    this->indexList.swap(indexList);
+    this->indexList.shrink_to_fit();
+
+    clearAttributes();
+
+    for(int k = 0; k < 3; k++)
+    {
+        positionOffset[k] = offset[k];
+        positionScale[k] = scale[k];
+    }
+
+    updateBounds();
+}
+
+void QuantizedMesh::setNormals(const float *normalList)
+{
+    int vertexCount = getVertexCount();
+
+    this->faceNormalList.clear();
+    this->normalList.resize(2 * (size_t)vertexCount);
+
+    for(int i = 0; i < vertexCount; i++)
+    {
+        VertexQuantizer::encodeOctahedral(&normalList[3 * (size_t)i], &this->normalList[2 * (size_t)i]);
+    }
+}
+
+void QuantizedMesh::computeNormals()
+{
+    int vertexCount = getVertexCount();
+
+    // Soma das normais (ponderadas pela área) dos triângulos de cada vértice. As posições
+    // quantizadas bastam, pois a escala é a mesma nos três eixos
+    vector<float> normalSumList(3 * (size_t)vertexCount, 0.0f);
+
+    for(size_t i = 0; i + 2 < indexList.size(); i += 3)
+    {
+        float normal[3];
+        getTriangleNormal(i / 3, normal);
+
+        for(int j = 0; j < 3; j++)
+        {
+            float *sum = &normalSumList[3 * (size_t)indexList[i + j]];
+
+            sum[0] += normal[0];
+            sum[1] += normal[1];
+            sum[2] += normal[2];
+        }
+    }
+
+    // A codificação octaédrica normaliza as somas (vértices sem triângulos ficam com a normal (0, 0, 1))
+    setNormals(normalSumList.data());
+}
+
+void QuantizedMesh::setFaceNormals(const float *faceNormalList)
+{
+    int triangleCount = getTriangleCount();
+
+    this->normalList.clear();
+    this->faceNormalList.resize(2 * (size_t)triangleCount);
+
+    for(int i = 0; i < triangleCount; i++)
+    {
+        VertexQuantizer::encodeOctahedral(&faceNormalList[3 * (size_t)i], &this->faceNormalList[2 * (size_t)i]);
+    }
+}
+
+void QuantizedMesh::setColors(const float *colorList)
+{
+    size_t valueCount = 3 * (size_t)getVertexCount();
+
+    this->colorList.resize(valueCount);
+
+    for(size_t i = 0; i < valueCount; i++)
+    {
+        float value = std::min(std::max(colorList[i], 0.0f), 1.0f);
+        this->colorList[i] = (unsigned char)(value * 255.0f + 0.5f);
+    }
+}
+
+void QuantizedMesh::setTexCoords(const float *texCoordList)
+{
+    size_t vertexCount = getVertexCount();
+
+    // Escala por eixo, pois as coordenadas de textura não precisam manter proporções
+    this->texCoordList.resize(2 * vertexCount);
+    VertexQuantizer::quantize(texCoordList, vertexCount, 2, false, this->texCoordList.data(), texCoordOffset, texCoordScale);
+}
+
+int QuantizedMesh::getVertexCount()
+{
+    return positionList.size() / 3;
+}
+
+int QuantizedMesh::getTriangleCount()
+{
+    return indexList.size() / 3;
+}
+
+void QuantizedMesh::getVertex(int idVertex, double vertex[3])
+{
+    const short *position = &positionList[3 * (size_t)idVertex];
+
+    for(int k = 0; k < 3; k++)
+    {
+        vertex[k] = positionOffset[k] + position[k] * (double)positionScale[k];
+    }
+}
+
+const unsigned int* QuantizedMesh::getTriangle(int idTriangle)
+{
+    return &indexList[3 * (size_t)idTriangle];
+}
+
+void QuantizedMesh::getBounds(const AffineTransform &transform, double min[3], double max[3])
+{
+    for(int axis = 0; axis < 3; axis++)
+    {
+        min[axis] = 1e30;
+        max[axis] = -1e30;
+    }
+
+    // Transforma os 8 cantos da caixa local
+    for(int corner = 0; corner < 8; corner++)
+    {
+        double local[3], world[3];
+        local[0] = (corner & 1) ? this->max[0] : this->min[0];
+        local[1] = (corner & 2) ? this->max[1] : this->min[1];
+        local[2] = (corner & 4) ? this->max[2] : this->min[2];
+
+        transform.transformPoint(local, world);
+
+        for(int axis = 0; axis < 3; axis++)
+        {
+            min[axis] = (world[axis] < min[axis]) ? world[axis] : min[axis];
+            max[axis] = (world[axis] > max[axis]) ? world[axis] : max[axis];
+        }
+    }
+}
+
+bool QuantizedMesh::raycast(const double origin[3], const double direction[3], const AffineTransform &transform, double &distance, int &triangleIndex)
+{
+    AffineTransform inverse;
+
+    if(indexList.empty() || !transform.inverse(inverse))
+    {
+        return false;
+    }
+
+    // Raio no espaço local da malha (a distância ao longo do raio é a mesma nos dois espaços)
+    double localOrigin[3], localDirection[3];
+    inverse.transformPoint(origin, localOrigin);
+    inverse.transformVector(direction, localDirection);
+
+    // Teste das placas (slabs) com a caixa da malha antes dos triângulos
+    double tmin = 0.0, tmax = distance;
+
+    for(int axis = 0; axis < 3; axis++)
+    {
+        double t0 = (min[axis] - localOrigin[axis]) / localDirection[axis];
+        double t1 = (max[axis] - localOrigin[axis]) / localDirection[axis];
+
+        if(t0 > t1)
+        {
+            swap(t0, t1);
+        }
+
+        tmin = std::max(tmin, t0);
+        tmax = std::min(tmax, t1);
+    }
+
+    if(tmin > tmax)
+    {
+        return false;
+    }
+
+    bool hasHit = false;
+
+    for(size_t i = 0; i + 2 < indexList.size(); i += 3)
+    {
+        double v[3][3];
+
+        for(int j = 0; j < 3; j++)
+        {
+            getVertex(indexList[i + j], v[j]);
+        }
+
+        if(MeshBVH::intersectRayTriangle(localOrigin, localDirection, v, distance))
+        {
+            triangleIndex = i / 3;
+            hasHit = true;
+        }
+    }
+
+    return hasHit;
+}
+
+size_t QuantizedMesh::getMemorySize()
+{
+    return (positionList.capacity() + normalList.capacity() + faceNormalList.capacity() + texCoordList.capacity()) * sizeof(short) +
+           colorList.capacity() * sizeof(unsigned char) + indexList.capacity() * sizeof(unsigned int);
+}
+
+void QuantizedMesh::draw()
+{
+    if(indexList.empty())
+    {
+        return;
+    }
+
+    // As posições voltam aos valores originais pela matriz de modelo; as normais são
+    // renormalizadas depois da escala
+    glPushMatrix();
+    glTranslatef(positionOffset[0], positionOffset[1], positionOffset[2]);
+    glScalef(positionScale[0], positionScale[1], positionScale[2]);
+
+    GLboolean normalize = glIsEnabled(GL_NORMALIZE);
+    glEnable(GL_NORMALIZE);
+
+    bool hasNormals = !normalList.empty();
+    bool hasFaceNormals = !faceNormalList.empty();
+    bool hasColors = !colorList.empty();
+    bool hasTexCoords = !texCoordList.empty();
+    float normal[3];
+
+    // As coordenadas de textura voltam aos valores originais pela matriz de textura
+    if(hasTexCoords)
+    {
+        glMatrixMode(GL_TEXTURE);
+        glPushMatrix();
+        glTranslatef(texCoordOffset[0], texCoordOffset[1], 0.0f);
+        glScalef(texCoordScale[0], texCoordScale[1], 1.0f);
+        glMatrixMode(GL_MODELVIEW);
+    }
+
+    // As cores dos vértices substituem a componente ambiente e difusa do material
+    if(hasColors)
+    {
+        glColorMaterial(GL_FRONT, GL_AMBIENT_AND_DIFFUSE);
+        glEnable(GL_COLOR_MATERIAL);
+    }
+
+    // As normais octaédricas são decodificadas no envio, pois o pipeline fixo não as interpreta
+    glBegin(GL_TRIANGLES);
+
+    for(size_t i = 0; i < indexList.size(); i++)
+    {
+        size_t idVertex = indexList[i];
+
+        if(hasNormals)
+        {
+            VertexQuantizer::decodeOctahedral(&normalList[2 * idVertex], normal);
+            glNormal3fv(normal);
+        }
+        else if(hasFaceNormals && (i % 3 == 0))
+        {
+            VertexQuantizer::decodeOctahedral(&faceNormalList[2 * (i / 3)], normal);
+            glNormal3fv(normal);
+        }
+
+        if(hasColors)
+        {
+            glColor3ubv(&colorList[3 * idVertex]);
+        }
+
+        if(hasTexCoords)
+        {
+            glTexCoord2sv(&texCoordList[2 * idVertex]);
+        }
+
+        glVertex3sv(&positionList[3 * idVertex]);
+    }
+
+    glEnd();
+
+    if(hasColors)
+    {
+        glDisable(GL_COLOR_MATERIAL);
+    }
+
+    if(hasTexCoords)
+    {
+        glMatrixMode(GL_TEXTURE);
+        glPopMatrix();
+        glMatrixMode(GL_MODELVIEW);
+    }
+
+    if(!normalize)
+    {
+        glDisable(GL_NORMALIZE);
+    }
+
+    glPopMatrix();
+}
@@ -0,0 +1,152 @@
+#include "primitive/Triangulator.h"
+
+using namespace std;
+
+double Triangulator::cross2D(const double *a, const double *b, const double *c)
+{
+    return (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+}
+
+bool Triangulator::pointInTriangle(const double *p, const double *a, const double *b, const double *c)
+{
+    return (cross2D(a, b, p) >= 0.0) && (cross2D(b, c, p) >= 0.0) && (cross2D(c, a, p) >= 0.0);
+}
+
+void Triangulator::triangulate(const double *positionList, int vertexCount, vector<int> &triangleList)
+{
+    if(vertexCount < 3)
+    {
+        return;
+    }
+
+    if(vertexCount == 3)
+    {
+        triangleList.push_back(0);
+        triangleList.push_back(1);
+        triangleList.push_back(2);
+        return;
+    }
+
+    // Normal do polígono pelo método de Newell (robusto para polígonos côncavos e quase planares)
+    double normal[3] = { 0.0, 0.0, 0.0 };
+
+    for(int i = 0; i < vertexCount; i++)
+    {
+        const double *curr = &positionList[3 * i];
+        const double *next = &positionList[3 * ((i + 1) % vertexCount)];
+
+        normal[0] += (curr[1] - next[1]) * (curr[2] + next[2]);
+        normal[1] += (curr[2] - next[2]) * (curr[0] + next[0]);
+        normal[2] += (curr[0] - next[0]) * (curr[1] + next[1]);
+    }
+
+    // Verifica se o polígono é convexo: todas as curvas têm o mesmo sentido da normal
+    bool convex = true;
+
+    for(int i = 0; (i < vertexCount) && convex; i++)
+    {
+        const double *prev = &positionList[3 * ((i + vertexCount - 1) % vertexCount)];
+        const double *curr = &positionList[3 * i];
+        const double *next = &positionList[3 * ((i + 1) % vertexCount)];
+
+        double e0[3] = { curr[0] - prev[0], curr[1] - prev[1], curr[2] - prev[2] };
+        double e1[3] = { next[0] - curr[0], next[1] - curr[1], next[2] - curr[2] };
+
+        double turn = normal[0] * (e0[1] * e1[2] - e0[2] * e1[1]) +
+                      normal[1] * (e0[2] * e1[0] - e0[0] * e1[2]) +
+                      normal[2] * (e0[0] * e1[1] - e0[1] * e1[0]);
+
+        convex = (turn >= 0.0);
+    }
+
+    if(convex)
+    {
+        // Divisão em leque a partir do primeiro vértice
+        for(int i = 2; i < vertexCount; i++)
+        {
+            triangleList.push_back(0);
+            triangleList.push_back(i - 1);
+            triangleList.push_back(i);
+        }
+
+        return;
+    }
+
+    // Projeta o polígono no plano dos dois eixos em que a normal tem menor componente,
+    // mantendo a orientação anti-horária
+    int dropAxis = 2;
+
+    if((fabs(normal[0]) > fabs(normal[1])) && (fabs(normal[0]) > fabs(normal[2])))
+    {
+        dropAxis = 0;
+    }
+    else if(fabs(normal[1]) > fabs(normal[2]))
+    {
+        dropAxis = 1;
+    }
+
+    int axisU = (dropAxis + 1) % 3;
+    int axisV = (dropAxis + 2) % 3;
+    double orientation = (normal[dropAxis] < 0.0) ? -1.0 : 1.0;
+
+    vector<double> projectedList(2 * vertexCount);
+    vector<int> remainingList(vertexCount);
+
+    for(int i = 0; i < vertexCount; i++)
+    {
+        projectedList[2 * i] = positionList[3 * i + axisU];
+        projectedList[2 * i + 1] = orientation * positionList[3 * i + axisV];
+        remainingList[i] = i;
+    }
+
+    // Remoção de orelhas: um vértice convexo cujo triângulo com os vizinhos não contém
+    // nenhum outro vértice restante é cortado do polígono
+    int current = 0;
+    int attempts = 0;
+
+    while(remainingList.size() > 3)
+    {
+        int count = remainingList.size();
+        int prevIndex = remainingList[(current + count - 1) % count];
+        int currIndex = remainingList[current % count];
+        int nextIndex = remainingList[(current + 1) % count];
+
+        const double *a = &projectedList[2 * prevIndex];
+        const double *b = &projectedList[2 * currIndex];
+        const double *c = &projectedList[2 * nextIndex];
+
+        bool isEar = (cross2D(a, b, c) > 0.0);
+
+        for(int i = 0; (i < count) && isEar; i++)
+        {
+            int other = remainingList[i];
+
+            if((other != prevIndex) && (other != currIndex) && (other != nextIndex))
+            {
+                isEar = !pointInTriangle(&projectedList[2 * other], a, b, c);
+            }
+        }
+
+        // Polígonos degenerados (auto-interseções, vértices repetidos) podem não ter orelhas;
+        // nesse caso o vértice atual é cortado mesmo assim para garantir o término
+        if(isEar || (attempts >= count))
+        {
+            triangleList.push_back(prevIndex);
+            triangleList.push_back(currIndex);
+            triangleList.push_back(nextIndex);
+
+            remainingList.erase(remainingList.begin() + (current % count));
+            current = (current % count) % (count - 1);
+            attempts = 0;
+        }
+        else
+        {
+            current = (current + 1) % count;
+            attempts++;
+        }
+    }
+
+    triangleList.push_back(remainingList[0]);
+    triangleList.push_back(remainingList[1]);
+    triangleList.push_back(remainingList[2]);
+}
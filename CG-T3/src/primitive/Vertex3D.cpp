@@ -23,6 +23,11 @@ int Vertex3D::getId()
     return this->id;
 }
 
+void Vertex3D::setId(int id)
+{
+    this->id = id;
+}
+
 double Vertex3D::getX()
 {
     return this->x;
@@ -0,0 +1,265 @@
+#include "primitive/VertexCacheOptimizer.h"
+
+#include <cmath>
+
+using namespace std;
+
+// Tamanho da cache LRU simulada na reordenação dos triângulos
+#define VERTEX_CACHE_SIZE 32
+// Parâmetros da pontuação dos vértices sugeridos por Forsyth
+#define VERTEX_CACHE_DECAY_POWER 1.5f
+#define VERTEX_CACHE_LAST_TRIANGLE_SCORE 0.75f
+#define VERTEX_CACHE_VALENCE_BOOST_SCALE 2.0f
+#define VERTEX_CACHE_VALENCE_BOOST_POWER 0.5f
+// Tamanho da cache FIFO usada no cálculo do ACMR
+#define VERTEX_CACHE_FIFO_SIZE 16
+
+// Índice que marca a ausência de um triângulo ou de um vértice
+#define NO_INDEX 0xFFFFFFFF
+
+float VertexCacheOptimizer::getVertexScore(int cachePosition, unsigned int remainingTriangles)
+{
+    // Um vértice sem triângulos restantes não deve atrair nenhum triângulo
+    if(remainingTriangles == 0)
+    {
+        return -1.0f;
+    }
+
+    float score = 0.0f;
+
+    if(cachePosition >= 0)
+    {
+        // Os vértices do último triângulo têm a mesma pontuação, para que a ordem em que
+        // foram emitidos não favoreça nenhum deles
+        if(cachePosition < 3)
+        {
+            score = VERTEX_CACHE_LAST_TRIANGLE_SCORE;
+        }
+        else
+        {
+            score = pow(1.0f - (cachePosition - 3) / (float)(VERTEX_CACHE_SIZE - 3), VERTEX_CACHE_DECAY_POWER);
+        }
+    }
+
+    // Vértices com poucos triângulos restantes são priorizados, evitando que fiquem isolados
+    return score + VERTEX_CACHE_VALENCE_BOOST_SCALE * pow((float)remainingTriangles, -VERTEX_CACHE_VALENCE_BOOST_POWER);
+}
+
+void VertexCacheOptimizer::optimizeTriangleOrder(unsigned int *indexList, size_t indexCount, unsigned int vertexCount, vector<unsigned int> &triangleOrderList)
+{
+    size_t triangleCount = indexCount / 3;
+
+    triangleOrderList.resize(triangleCount);
+
+    if(triangleCount == 0)
+    {
+        return;
+    }
+
+    // Triângulos de cada vértice em um único vetor (o trecho de cada vértice começa em firstList).
+    // Os triângulos ainda não emitidos ficam nas primeiras remainingList posições do trecho
+    vector<unsigned int> firstList(vertexCount + 1, 0);
+    vector<unsigned int> remainingList(vertexCount, 0);
+
+    for(size_t i = 0; i < 3 * triangleCount; i++)
+    {
+        remainingList[indexList[i]]++;
+    }
+
+    for(unsigned int v = 0; v < vertexCount; v++)
+    {
+        firstList[v + 1] = firstList[v] + remainingList[v];
+    }
+
+    vector<unsigned int> adjacencyList(firstList[vertexCount]);
+    vector<unsigned int> fillList(firstList.begin(), firstList.end() - 1);
+
+    for(size_t i = 0; i < 3 * triangleCount; i++)
+    {
+        adjacencyList[fillList[indexList[i]]++] = i / 3;
+    }
+
+    // Pontuações iniciais (nenhum vértice na cache)
+    vector<float> vertexScoreList(vertexCount);
+    vector<float> triangleScoreList(triangleCount, 0.0f);
+    vector<bool> emittedList(triangleCount, false);
+
+    for(unsigned int v = 0; v < vertexCount; v++)
+    {
+        vertexScoreList[v] = getVertexScore(-1, remainingList[v]);
+    }
+
+    for(size_t i = 0; i < 3 * triangleCount; i++)
+    {
+        triangleScoreList[i / 3] += vertexScoreList[indexList[i]];
+    }
+
+    unsigned int bestTriangle = 0;
+
+    for(size_t t = 1; t < triangleCount; t++)
+    {
+        if(triangleScoreList[t] > triangleScoreList[bestTriangle])
+        {
+            bestTriangle = t;
+        }
+    }
+
+    vector<unsigned int> orderedList(3 * triangleCount);
+    vector<unsigned int> cacheList, newCacheList;
+    size_t nextUnemitted = 0;
+
+    cacheList.reserve(VERTEX_CACHE_SIZE + 3);
+    newCacheList.reserve(VERTEX_CACHE_SIZE + 3);
+
+    for(size_t out = 0; out < triangleCount; out++)
+    {
+        // Sem candidatos na cache, continua pelo primeiro triângulo ainda não emitido
+        if(bestTriangle == NO_INDEX)
+        {
+            while(emittedList[nextUnemitted])
+            {
+                nextUnemitted++;
+            }
+
+            bestTriangle = nextUnemitted;
+        }
+
+        const unsigned int *triangle = &indexList[3 * (size_t)bestTriangle];
+
+        emittedList[bestTriangle] = true;
+        triangleOrderList[out] = bestTriangle;
+        newCacheList.clear();
+
+        for(int j = 0; j < 3; j++)
+        {
+            unsigned int v = triangle[j];
+            orderedList[3 * out + j] = v;
+
+            // Retira o triângulo dos triângulos restantes do vértice
+            unsigned int *adjacency = &adjacencyList[firstList[v]];
+
+            for(unsigned int k = 0; k < remainingList[v]; k++)
+            {
+                if(adjacency[k] == bestTriangle)
+                {
+                    adjacency[k] = adjacency[remainingList[v] - 1];
+                    remainingList[v]--;
+                    break;
+                }
+            }
+
+            // Os vértices do triângulo vão para o início da cache
+            bool cached = false;
+
+            for(unsigned int k = 0; k < newCacheList.size(); k++)
+            {
+                cached = cached || (newCacheList[k] == v);
+            }
+
+            if(!cached)
+            {
+                newCacheList.push_back(v);
+            }
+        }
+
+        for(unsigned int k = 0; k < cacheList.size(); k++)
+        {
+            unsigned int v = cacheList[k];
+
+            if((v != triangle[0]) && (v != triangle[1]) && (v != triangle[2]))
+            {
+                newCacheList.push_back(v);
+            }
+        }
+
+        // Atualiza as pontuações dos vértices que mudaram de posição (ou saíram da cache) e dos
+        // seus triângulos restantes, escolhendo entre eles o próximo triângulo
+        bestTriangle = NO_INDEX;
+        float bestScore = -1.0f;
+
+        for(unsigned int k = 0; k < newCacheList.size(); k++)
+        {
+            unsigned int v = newCacheList[k];
+            int cachePosition = (k < VERTEX_CACHE_SIZE) ? (int)k : -1;
+
+            float score = getVertexScore(cachePosition, remainingList[v]);
+            float delta = score - vertexScoreList[v];
+            vertexScoreList[v] = score;
+
+            const unsigned int *adjacency = &adjacencyList[firstList[v]];
+
+            for(unsigned int i = 0; i < remainingList[v]; i++)
+            {
+                triangleScoreList[adjacency[i]] += delta;
+
+                if((cachePosition >= 0) && (triangleScoreList[adjacency[i]] > bestScore))
+                {
+                    bestScore = triangleScoreList[adjacency[i]];
+                    bestTriangle = adjacency[i];
+                }
+            }
+        }
+
+        if(newCacheList.size() > VERTEX_CACHE_SIZE)
+        {
+            newCacheList.resize(VERTEX_CACHE_SIZE);
+        }
+
+        cacheList.swap(newCacheList);
+    }
+
+    for(size_t i = 0; i < 3 * triangleCount; i++)
+    {
+        indexList[i] = orderedList[i];
+    }
+}
+
+void VertexCacheOptimizer::optimizeVertexOrder(unsigned int *indexList, size_t indexCount, unsigned int vertexCount, vector<unsigned int> &remapList)
+{
+    unsigned int nextVertex = 0;
+
+    remapList.assign(vertexCount, NO_INDEX);
+
+    for(size_t i = 0; i < indexCount; i++)
+    {
+        if(remapList[indexList[i]] == NO_INDEX)
+        {
+            remapList[indexList[i]] = nextVertex++;
+        }
+
+        indexList[i] = remapList[indexList[i]];
+    }
+
+    for(unsigned int v = 0; v < vertexCount; v++)
+    {
+        if(remapList[v] == NO_INDEX)
+        {
+            remapList[v] = nextVertex++;
+        }
+    }
+}
+
+double VertexCacheOptimizer::getACMR(const unsigned int *indexList, size_t indexCount, unsigned int vertexCount)
+{
+    if(indexCount < 3)
+    {
+        return 0.0;
+    }
+
+    // Um vértice está na cache FIFO se entrou nela há menos de VERTEX_CACHE_FIFO_SIZE faltas
+    vector<size_t> entryList(vertexCount, 0);
+    size_t missCount = 0;
+
+    for(size_t i = 0; i < indexCount; i++)
+    {
+        size_t &entry = entryList[indexList[i]];
+
+        if((entry == 0) || (missCount + 1 - entry > VERTEX_CACHE_FIFO_SIZE))
+        {
+            missCount++;
+            entry = missCount;
+        }
+    }
+
+    return (double)missCount / (indexCount / 3);
+}
@@ -0,0 +1,117 @@
+#include "primitive/VertexQuantizer.h"
+
+#include <algorithm>
+
+using namespace std;
+
+// Quantiza um valor em [-1, 1]
+static short quantizeUnit(float value)
+{
+    return (short)lroundf(max(-1.0f, min(1.0f, value)) * VERTEX_QUANTIZATION_SCALE);
+}
+
+void VertexQuantizer::quantize(const float *valueList, size_t count, int components, bool uniform, short *quantizedList, float *offset, float *scale)
+{
+    float minList[4], maxList[4], extent = 0.0f;
+
+    for(int k = 0; k < components; k++)
+    {
+        minList[k] = (count > 0) ? valueList[k] : 0.0f;
+        maxList[k] = minList[k];
+    }
+
+    for(size_t i = 0; i < count; i++)
+    {
+        for(int k = 0; k < components; k++)
+        {
+            minList[k] = min(minList[k], valueList[i * components + k]);
+            maxList[k] = max(maxList[k], valueList[i * components + k]);
+        }
+    }
+
+    for(int k = 0; k < components; k++)
+    {
+        offset[k] = (minList[k] + maxList[k]) / 2.0f;
+        scale[k] = (maxList[k] - minList[k]) / 2.0f;
+        extent = max(extent, scale[k]);
+    }
+
+    // Uma componente constante ainda precisa de uma escala válida
+    for(int k = 0; k < components; k++)
+    {
+        scale[k] = (uniform ? extent : scale[k]) / VERTEX_QUANTIZATION_SCALE;
+
+        if(!(scale[k] > 0.0f))
+        {
+            scale[k] = 1.0f / VERTEX_QUANTIZATION_SCALE;
+        }
+    }
+
+    for(size_t i = 0; i < count; i++)
+    {
+        for(int k = 0; k < components; k++)
+        {
+            quantizedList[i * components + k] = quantizeUnit((valueList[i * components + k] - offset[k]) / (scale[k] * VERTEX_QUANTIZATION_SCALE));
+        }
+    }
+}
+
+void VertexQuantizer::dequantize(const short *quantizedList, size_t count, int components, const float *offset, const float *scale, float *valueList)
+{
+    for(size_t i = 0; i < count; i++)
+    {
+        for(int k = 0; k < components; k++)
+        {
+            valueList[i * components + k] = offset[k] + quantizedList[i * components + k] * scale[k];
+        }
+    }
+}
+
+void VertexQuantizer::encodeOctahedral(const float *normal, short *encoded)
+{
+    float sum = fabsf(normal[0]) + fabsf(normal[1]) + fabsf(normal[2]);
+
+    if(!(sum > 0.0f))
+    {
+        encoded[0] = 0;
+        encoded[1] = 0;
+        return;
+    }
+
+    float x = normal[0] / sum;
+    float y = normal[1] / sum;
+
+    // O hemisfério negativo é dobrado sobre os cantos do quadrado
+    if(normal[2] < 0.0f)
+    {
+        float foldedX = (1.0f - fabsf(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        float foldedY = (1.0f - fabsf(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+
+        x = foldedX;
+        y = foldedY;
+    }
+
+    // Entre os quatro valores vizinhos de (x, y), escolhe o que reconstrói a direção mais próxima
+    float length = sqrtf(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+    float bestDot = -2.0f;
+
+    for(int i = 0; i < 4; i++)
+    {
+        float scaledX = x * VERTEX_QUANTIZATION_SCALE;
+        float scaledY = y * VERTEX_QUANTIZATION_SCALE;
+        short candidate[2] = { (short)max(-VERTEX_QUANTIZATION_SCALE, min(VERTEX_QUANTIZATION_SCALE, (i & 1) ? ceilf(scaledX) : floorf(scaledX))),
+                               (short)max(-VERTEX_QUANTIZATION_SCALE, min(VERTEX_QUANTIZATION_SCALE, (i & 2) ? ceilf(scaledY) : floorf(scaledY))) };
+        float decoded[3];
+
+        decodeOctahedral(candidate, decoded);
+
+        float dot = (decoded[0] * normal[0] + decoded[1] * normal[1] + decoded[2] * normal[2]) / length;
+
+        if(dot > bestDot)
+        {
+            bestDot = dot;
+            encoded[0] = candidate[0];
+            encoded[1] = candidate[1];
+        }
+    }
+}
@@ -0,0 +1,190 @@
+#include "primitive/VertexWelder.h"
+
+#include <cmath>
+#include <cstring>
+#include <stdint.h>
+
+using namespace std;
+
+// Índice que marca uma posição vazia da tabela ou o fim da lista de vértices de uma célula
+#define NO_INDEX 0xFFFFFFFF
+
+// Mistura os bits de uma chave (finalizador do MurmurHash3), espalhando células vizinhas pela tabela
+static uint64_t mixKey(uint64_t key)
+{
+    key ^= key >> 33;
+    key *= 0xFF51AFD7ED558CCDULL;
+    key ^= key >> 33;
+    key *= 0xC4CEB9FE1A85EC53ULL;
+    key ^= key >> 33;
+
+    return key;
+}
+
+// Chave da célula (ix, iy, iz) do hash espacial. Células diferentes podem ter a mesma chave,
+// o que apenas aumenta as comparações, já que as posições são sempre verificadas
+static uint64_t getCellKey(int64_t ix, int64_t iy, int64_t iz)
+{
+    return mixKey((uint64_t)ix * 73856093ULL ^ mixKey((uint64_t)iy * 19349663ULL ^ mixKey((uint64_t)iz)));
+}
+
+// Chave de uma posição exata (o zero negativo é levado para o positivo)
+static uint64_t getPositionKey(double x, double y, double z)
+{
+    double position[3] = { x + 0.0, y + 0.0, z + 0.0 };
+    uint64_t bits[3];
+
+    memcpy(bits, position, sizeof(bits));
+
+    return getCellKey(bits[0], bits[1], bits[2]);
+}
+
+// Tabela de endereçamento aberto com o primeiro vértice mantido de cada chave
+struct WeldTable
+{
+    std::vector<uint64_t> keyList;
+    std::vector<unsigned int> headList;
+    uint64_t mask;
+
+    WeldTable(unsigned int vertexCount)
+    {
+        size_t size = 16;
+
+        while(size < 2 * (size_t)vertexCount)
+        {
+            size *= 2;
+        }
+
+        this->keyList.resize(size);
+        this->headList.assign(size, NO_INDEX);
+        this->mask = size - 1;
+    }
+
+    // Obtém a posição da chave na tabela (a posição vazia onde ela entraria, se não estiver na tabela)
+    size_t find(uint64_t key)
+    {
+        size_t slot = key & mask;
+
+        while((headList[slot] != NO_INDEX) && (keyList[slot] != key))
+        {
+            slot = (slot + 1) & mask;
+        }
+
+        keyList[slot] = key;
+        return slot;
+    }
+};
+
+template<typename T>
+unsigned int VertexWelder::weldPositions(const T *positionList, unsigned int vertexCount, double epsilon,
+                                         const function<bool(unsigned int, unsigned int)> *compatible, vector<unsigned int> &remapList)
+{
+    // Próximo vértice mantido com a mesma chave
+    WeldTable table(vertexCount);
+    vector<unsigned int> nextList(vertexCount, NO_INDEX);
+    unsigned int keptCount = 0;
+
+    remapList.resize(vertexCount);
+
+    bool exact = !(epsilon > 0.0);
+    double epsilon2 = epsilon * epsilon;
+    // Com células de lado 2 * epsilon, a vizinhança de um vértice alcança no máximo duas células por eixo
+    double cellSize = 2.0 * epsilon;
+
+    for(unsigned int i = 0; i < vertexCount; i++)
+    {
+        const T *p = &positionList[3 * (size_t)i];
+        unsigned int match = NO_INDEX;
+        uint64_t key;
+
+        if(exact)
+        {
+            key = getPositionKey(p[0], p[1], p[2]);
+
+            for(unsigned int j = table.headList[table.find(key)]; (j != NO_INDEX) && (match == NO_INDEX); j = nextList[j])
+            {
+                const T *q = &positionList[3 * (size_t)j];
+
+                if((p[0] == q[0]) && (p[1] == q[1]) && (p[2] == q[2]) && (!compatible || (*compatible)(i, j)))
+                {
+                    match = j;
+                }
+            }
+        }
+        else
+        {
+            int64_t cell[3];
+            int side[3];
+            bool finite = true;
+
+            for(int k = 0; k < 3; k++)
+            {
+                double c = floor(p[k] / cellSize);
+
+                // Posições inválidas ou fora do alcance das células nunca são soldadas
+                finite = finite && (fabs(c) < 1e18);
+                cell[k] = finite ? (int64_t)c : 0;
+                // Célula vizinha mais próxima do vértice no eixo
+                side[k] = (p[k] / cellSize - c < 0.5) ? -1 : 1;
+            }
+
+            if(!finite)
+            {
+                remapList[i] = keptCount++;
+                continue;
+            }
+
+            key = getCellKey(cell[0], cell[1], cell[2]);
+
+            for(int n = 0; (n < 8) && (match == NO_INDEX); n++)
+            {
+                uint64_t neighborKey = (n == 0) ? key : getCellKey(cell[0] + ((n & 1) ? side[0] : 0),
+                                                                   cell[1] + ((n & 2) ? side[1] : 0),
+                                                                   cell[2] + ((n & 4) ? side[2] : 0));
+
+                for(unsigned int j = table.headList[table.find(neighborKey)]; (j != NO_INDEX) && (match == NO_INDEX); j = nextList[j])
+                {
+                    const T *q = &positionList[3 * (size_t)j];
+                    double d[3] = { (double)p[0] - q[0], (double)p[1] - q[1], (double)p[2] - q[2] };
+
+                    if((d[0] * d[0] + d[1] * d[1] + d[2] * d[2] <= epsilon2) && (!compatible || (*compatible)(i, j)))
+                    {
+                        match = j;
+                    }
+                }
+            }
+        }
+
+        if(match != NO_INDEX)
+        {
+            remapList[i] = remapList[match];
+            continue;
+        }
+
+        // Vértice mantido: entra no início da lista da sua chave
+        size_t slot = table.find(key);
+
+        nextList[i] = table.headList[slot];
+        table.headList[slot] = i;
+
+        remapList[i] = keptCount++;
+    }
+
+    return keptCount;
+}
+
+unsigned int VertexWelder::weld(const double *positionList, unsigned int vertexCount, double epsilon, vector<unsigned int> &remapList)
+{
+    return weldPositions(positionList, vertexCount, epsilon, NULL, remapList);
+}
+
+unsigned int VertexWelder::weld(const float *positionList, unsigned int vertexCount, double epsilon, vector<unsigned int> &remapList)
+{
+    return weldPositions(positionList, vertexCount, epsilon, NULL, remapList);
+}
+
+unsigned int VertexWelder::weld(const double *positionList, unsigned int vertexCount, double epsilon,
+                                const function<bool(unsigned int, unsigned int)> &compatible, vector<unsigned int> &remapList)
+{
+    return weldPositions(positionList, vertexCount, epsilon, &compatible, remapList);
+}
@@ -1,20 +1,36 @@
 #include "scene/Scene.h"
 
+#include <cmath>
+
 using namespace std;
 
+Scene::Scene()
+{
+    this->sceneBVH = NULL;
+    this->sceneBVHRevision = 0;
+}
+
+Scene::~Scene()
+{
+    delete sceneBVH;
+}
+
 void Scene::addNewObjectGroup(string groupName)
 {
     objectGroupList.push_back(new ObjectGroup(groupName));
+    Object::notifyChange();
 }
 
 void Scene::addObjectGroup(ObjectGroup *group)
 {
     objectGroupList.push_back(group);
+    Object::notifyChange();
 }
 
 void Scene::removeObjectGroup(int index)
 {
     objectGroupList.erase(objectGroupList.begin() + index);
+    Object::notifyChange();
 }
 
 ObjectGroup* Scene::getObjectGroup(int index)
@@ -32,6 +48,47 @@ int Scene::objectGroupListSize()
     return objectGroupList.size();
 }
 
+SceneBVH* Scene::getSceneBVH()
+{
+    if((sceneBVH == NULL) || (sceneBVHRevision != Object::getRevision()))
+    {
+        delete sceneBVH;
+
+        sceneBVH = new SceneBVH(&objectGroupList);
+        sceneBVHRevision = Object::getRevision();
+    }
+
+    return sceneBVH;
+}
+
+bool Scene::raycast(const double origin[3], const double direction[3], SceneRayHit &hit)
+{
+    double length = sqrt(direction[0] * direction[0] + direction[1] * direction[1] + direction[2] * direction[2]);
+
+    if(length == 0.0)
+    {
+        return false;
+    }
+
+    // Normaliza a direo para que a distncia do resultado esteja nas unidades da cena
+    double unitDirection[3] = { direction[0] / length, direction[1] / length, direction[2] / length };
+
+    return getSceneBVH()->raycast(origin, unitDirection, hit);
+}
+
+bool Scene::nearestObject(const double point[3], SceneObjectRef &objectRef)
+{
+    return getSceneBVH()->nearestObject(point, objectRef);
+}
+
+vector<SceneObjectRef> Scene::objectsWithinRadius(const double point[3], double radius)
+{
+    vector<SceneObjectRef> objectRefList;
+    getSceneBVH()->objectsWithinRadius(point, radius, objectRefList);
+
+    return objectRefList;
+}
+
 void Scene::saveScene(string filePath)
 {
     ofstream sceneFile(filePath.c_str());
@@ -95,6 +152,32 @@ void Scene::saveScene(string filePath)
             Vertex3D objCenter = tmpObject->getCenter();
             sceneFile << objCenter.getX() << " " << objCenter.getY() << " " << objCenter.getZ() << endl;
 
+            // Objetos lidos em fluxo s tm a malha compacta, gravada com os vrtices no espao atual do objeto
+            QuantizedMesh *tmpQuantizedMesh = tmpObject->getQuantizedMesh();
+
+            if(tmpVertexList->empty() && tmpQuantizedMesh)
+            {
+                vector<double> meshVertexList;
+                tmpObject->getQuantizedVertexList(meshVertexList);
+
+                sceneFile << tmpQuantizedMesh->getVertexCount() << endl;
+
+                for(int k = 0; k < tmpQuantizedMesh->getVertexCount(); k++)
+                {
+                    sceneFile << k << " " << meshVertexList[3 * k] << " " << meshVertexList[3 * k + 1] << " " << meshVertexList[3 * k + 2] << endl;
+                }
+
+                sceneFile << tmpQuantizedMesh->getTriangleCount() << endl;
+
+                for(int k = 0; k < tmpQuantizedMesh->getTriangleCount(); k++)
+                {
+                    const unsigned int *triangle = tmpQuantizedMesh->getTriangle(k);
+                    sceneFile << 3 << " " << triangle[0] << " " << triangle[1] << " " << triangle[2] << endl;
+                }
+
+                continue;
+            }
+
             // Escreve a quantidade de vrtices do objeto
             sceneFile << tmpVertexList->size() << endl;
 
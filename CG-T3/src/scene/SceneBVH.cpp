@@ -0,0 +1,341 @@
+#include "scene/SceneBVH.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+// Quantidade máxima de objetos em uma folha da BVH da cena
+#define SCENE_BVH_LEAF_SIZE 2
+
+SceneBVH::SceneBVH(vector<ObjectGroup*> *objectGroupList)
+{
+    for(unsigned int i = 0; i < objectGroupList->size(); i++)
+    {
+        ObjectGroup *objectGroup = objectGroupList->at(i);
+
+        // O objeto 0 de cada grupo é a parede
+        for(int j = 1; j < objectGroup->objectListSize(); j++)
+        {
+            SceneObjectRef objectRef;
+            objectRef.groupIndex = i;
+            objectRef.objectIndex = j;
+            objectRef.object = objectGroup->getObject(j);
+
+            double min[3], max[3];
+            objectRef.object->getBounds(min, max);
+
+            // Objeto sem vértices
+            if(min[0] > max[0])
+            {
+                continue;
+            }
+
+            objectRefList.push_back(objectRef);
+            boundsList.insert(boundsList.end(), min, min + 3);
+            boundsList.insert(boundsList.end(), max, max + 3);
+        }
+    }
+
+    int objectCount = objectRefList.size();
+
+    for(int i = 0; i < objectCount; i++)
+    {
+        objectIndexList.push_back(i);
+    }
+
+    nodeList.reserve(max(1, 2 * objectCount - 1));
+
+    SceneBVHNode root;
+    root.leftFirst = 0;
+    root.objectCount = objectCount;
+    nodeList.push_back(root);
+
+    updateNodeBounds(0);
+    subdivide(0);
+}
+
+void SceneBVH::updateNodeBounds(int nodeIndex)
+{
+    SceneBVHNode &node = nodeList[nodeIndex];
+
+    for(int axis = 0; axis < 3; axis++)
+    {
+        node.bmin[axis] = 1e30;
+        node.bmax[axis] = -1e30;
+    }
+
+    for(int i = 0; i < node.objectCount; i++)
+    {
+        const double *bounds = &boundsList[6 * objectIndexList[node.leftFirst + i]];
+
+        for(int axis = 0; axis < 3; axis++)
+        {
+            node.bmin[axis] = min(node.bmin[axis], bounds[axis]);
+            node.bmax[axis] = max(node.bmax[axis], bounds[3 + axis]);
+        }
+    }
+}
+
+void SceneBVH::subdivide(int nodeIndex)
+{
+    if(nodeList[nodeIndex].objectCount <= SCENE_BVH_LEAF_SIZE)
+    {
+        return;
+    }
+
+    int first = nodeList[nodeIndex].leftFirst;
+    int count = nodeList[nodeIndex].objectCount;
+
+    // Divide no eixo de maior extensão da caixa do nó, pela mediana dos centros
+    int axis = 0;
+    const SceneBVHNode &node = nodeList[nodeIndex];
+
+    if((node.bmax[1] - node.bmin[1]) > (node.bmax[axis] - node.bmin[axis]))
+    {
+        axis = 1;
+    }
+
+    if((node.bmax[2] - node.bmin[2]) > (node.bmax[axis] - node.bmin[axis]))
+    {
+        axis = 2;
+    }
+
+    int middle = first + (count / 2);
+    const vector<double> &bounds = boundsList;
+
+    nth_element(objectIndexList.begin() + first, objectIndexList.begin() + middle, objectIndexList.begin() + first + count,
+                [&bounds, axis](int a, int b) { return (bounds[6 * a + axis] + bounds[6 * a + 3 + axis]) < (bounds[6 * b + axis] + bounds[6 * b + 3 + axis]); });
+
+    int leftIndex = nodeList.size();
+
+    SceneBVHNode left, right;
+    left.leftFirst = first;
+    left.objectCount = middle - first;
+    right.leftFirst = middle;
+    right.objectCount = first + count - middle;
+
+    nodeList.push_back(left);
+    nodeList.push_back(right);
+
+    nodeList[nodeIndex].leftFirst = leftIndex;
+    nodeList[nodeIndex].objectCount = 0;
+
+    updateNodeBounds(leftIndex);
+    updateNodeBounds(leftIndex + 1);
+
+    subdivide(leftIndex);
+    subdivide(leftIndex + 1);
+}
+
+double SceneBVH::squaredDistance(const double point[3], const double bmin[3], const double bmax[3])
+{
+    double distance = 0.0;
+
+    for(int axis = 0; axis < 3; axis++)
+    {
+        double d = 0.0;
+
+        if(point[axis] < bmin[axis])
+        {
+            d = bmin[axis] - point[axis];
+        }
+        else if(point[axis] > bmax[axis])
+        {
+            d = point[axis] - bmax[axis];
+        }
+
+        distance += d * d;
+    }
+
+    return distance;
+}
+
+int SceneBVH::getObjectCount()
+{
+    return objectRefList.size();
+}
+
+bool SceneBVH::raycast(const double origin[3], const double direction[3], SceneRayHit &hit)
+{
+    if(objectRefList.empty())
+    {
+        return false;
+    }
+
+    double invDirection[3];
+
+    for(int axis = 0; axis < 3; axis++)
+    {
+        invDirection[axis] = 1.0 / direction[axis];
+    }
+
+    double distance = 1e30;
+    bool hasHit = false;
+
+    int stack[64];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while(stackSize > 0)
+    {
+        const SceneBVHNode &node = nodeList[stack[--stackSize]];
+
+        // Descarta os nós que o raio não atinge antes da interseção mais próxima já encontrada
+        double tmin = 0.0, tmax = distance;
+
+        for(int axis = 0; axis < 3; axis++)
+        {
+            double t0 = (node.bmin[axis] - origin[axis]) * invDirection[axis];
+            double t1 = (node.bmax[axis] - origin[axis]) * invDirection[axis];
+
+            if(t0 > t1)
+            {
+                swap(t0, t1);
+            }
+
+            tmin = max(tmin, t0);
+            tmax = min(tmax, t1);
+        }
+
+        if(tmin > tmax)
+        {
+            continue;
+        }
+
+        if(node.objectCount > 0)
+        {
+            for(int i = 0; i < node.objectCount; i++)
+            {
+                const SceneObjectRef &objectRef = objectRefList[objectIndexList[node.leftFirst + i]];
+                int faceIndex;
+
+                if(objectRef.object->raycast(origin, direction, distance, faceIndex))
+                {
+                    hit.objectRef = objectRef;
+                    hit.faceIndex = faceIndex;
+                    hasHit = true;
+                }
+            }
+        }
+        else if(stackSize < 63)
+        {
+            stack[stackSize++] = node.leftFirst;
+            stack[stackSize++] = node.leftFirst + 1;
+        }
+    }
+
+    if(hasHit)
+    {
+        hit.distance = distance;
+
+        for(int axis = 0; axis < 3; axis++)
+        {
+            hit.point[axis] = origin[axis] + distance * direction[axis];
+        }
+    }
+
+    return hasHit;
+}
+
+bool SceneBVH::nearestObject(const double point[3], SceneObjectRef &objectRef)
+{
+    if(objectRefList.empty())
+    {
+        return false;
+    }
+
+    double bestDistance = 1e300;
+
+    int stack[64];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while(stackSize > 0)
+    {
+        const SceneBVHNode &node = nodeList[stack[--stackSize]];
+
+        if(squaredDistance(point, node.bmin, node.bmax) >= bestDistance)
+        {
+            continue;
+        }
+
+        if(node.objectCount > 0)
+        {
+            for(int i = 0; i < node.objectCount; i++)
+            {
+                int objectIndex = objectIndexList[node.leftFirst + i];
+                const double *bounds = &boundsList[6 * objectIndex];
+                double distance = squaredDistance(point, bounds, bounds + 3);
+
+                if(distance < bestDistance)
+                {
+                    bestDistance = distance;
+                    objectRef = objectRefList[objectIndex];
+                }
+            }
+        }
+        else if(stackSize < 63)
+        {
+            // Visita primeiro o filho mais próximo (empilhado por último)
+            const SceneBVHNode &left = nodeList[node.leftFirst];
+            const SceneBVHNode &right = nodeList[node.leftFirst + 1];
+
+            if(squaredDistance(point, left.bmin, left.bmax) < squaredDistance(point, right.bmin, right.bmax))
+            {
+                stack[stackSize++] = node.leftFirst + 1;
+                stack[stackSize++] = node.leftFirst;
+            }
+            else
+            {
+                stack[stackSize++] = node.leftFirst;
+                stack[stackSize++] = node.leftFirst + 1;
+            }
+        }
+    }
+
+    return true;
+}
+
+void SceneBVH::objectsWithinRadius(const double point[3], double radius, vector<SceneObjectRef> &objectRefList)
+{
+    if(this->objectRefList.empty())
+    {
+        return;
+    }
+
+    double squaredRadius = radius * radius;
+
+    int stack[64];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while(stackSize > 0)
+    {
+        const SceneBVHNode &node = nodeList[stack[--stackSize]];
+
+        if(squaredDistance(point, node.bmin, node.bmax) > squaredRadius)
+        {
+            continue;
+        }
+
+        if(node.objectCount > 0)
+        {
+            for(int i = 0; i < node.objectCount; i++)
+            {
+                int objectIndex = objectIndexList[node.leftFirst + i];
+                const double *bounds = &boundsList[6 * objectIndex];
+
+                if(squaredDistance(point, bounds, bounds + 3) <= squaredRadius)
+                {
+                    objectRefList.push_back(this->objectRefList[objectIndex]);
+                }
+            }
+        }
+        else if(stackSize < 63)
+        {
+            stack[stackSize++] = node.leftFirst;
+            stack[stackSize++] = node.leftFirst + 1;
+        }
+    }
+}
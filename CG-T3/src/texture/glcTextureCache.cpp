@@ -0,0 +1,97 @@
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "texture/glcTextureCache.h"
+
+//-----------------------------------------------------------
+glcTextureCache::glcTextureCache()
+{
+    // The texture objects are created as the images are requested
+    this->numberOfTextures = 0;
+}
+
+//-----------------------------------------------------------
+glcTextureCache* glcTextureCache::GetSharedCache()
+{
+    static glcTextureCache sharedCache;
+
+    return &sharedCache;
+}
+
+//-----------------------------------------------------------
+int glcTextureCache::GetNumberOfLoadedTextures()
+{
+    return this->numberOfTextures;
+}
+
+//-----------------------------------------------------------
+GLuint glcTextureCache::GetTexture(const std::string& path)
+{
+    std::map<std::string, GLuint>::iterator it = textureMap.find(path);
+    if(it != textureMap.end())
+        return it->second;
+
+    std::string resolved = ResolvePath(path);
+    if(resolved.empty())
+    {
+        printf("glcTextureCache::GetTexture() warning: can't load texture \"%s\" (only PNG images are supported).\n", path.c_str());
+        textureMap[path] = 0;
+        return 0;
+    }
+
+    // Different names may lead to the same image (e.g. "statue.jpg" and "statue.png")
+    it = textureMap.find(resolved);
+    if(it != textureMap.end())
+    {
+        textureMap[path] = it->second;
+        return it->second;
+    }
+
+    // Grow the texture arrays by one and load the image in the new texture object
+    int     id     = this->numberOfTextures;
+    GLuint* ids    = new GLuint[id + 1];
+    float*  ratios = new float[id + 1];
+
+    memcpy(ids, this->textureID, sizeof(GLuint) * id);
+    memcpy(ratios, this->aspectRatio, sizeof(float) * id);
+    delete [] this->textureID;
+    delete [] this->aspectRatio;
+    this->textureID   = ids;
+    this->aspectRatio = ratios;
+    this->numberOfTextures++;
+
+    glGenTextures(1, &this->textureID[id]);
+    this->aspectRatio[id] = 1.0;
+    CreateTextureFromPNG(resolved, id);
+
+    textureMap[path] = this->textureID[id];
+    textureMap[resolved] = this->textureID[id];
+
+    return this->textureID[id];
+}
+
+//-----------------------------------------------------------
+std::string glcTextureCache::ResolvePath(const std::string& path)
+{
+    size_t dot = path.find_last_of('.');
+    size_t slash = path.find_last_of('/');
+    std::string base = path;
+
+    if(dot != std::string::npos && (slash == std::string::npos || dot > slash))
+    {
+        std::string extension = path.substr(dot);
+
+        if(strcasecmp(extension.c_str(), ".png") == 0 && access(path.c_str(), R_OK) == 0)
+            return path;
+
+        base = path.substr(0, dot);
+    }
+
+    if(access((base + ".png").c_str(), R_OK) == 0)
+        return base + ".png";
+    if(access((base + ".PNG").c_str(), R_OK) == 0)
+        return base + ".PNG";
+
+    return "";
+}
@@ -0,0 +1,162 @@
+#include "thread/ThreadPool.h"
+
+#include <algorithm>
+
+using namespace std;
+
+ThreadPool::ThreadPool(int threadCount)
+{
+    this->stopWorkers = false;
+
+    for(int i = 0; i < threadCount; i++)
+    {
+        workerList.push_back(thread(&ThreadPool::workerLoop, this));
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        lock_guard<mutex> lock(poolMutex);
+        stopWorkers = true;
+    }
+
+    taskCondition.notify_all();
+
+    for(unsigned int i = 0; i < workerList.size(); i++)
+    {
+        workerList[i].join();
+    }
+}
+
+ThreadPool& ThreadPool::getSharedPool()
+{
+    static ThreadPool sharedPool(max(0, (int)thread::hardware_concurrency() - 1));
+
+    return sharedPool;
+}
+
+int ThreadPool::getConcurrency()
+{
+    return workerList.size() + 1;
+}
+
+int ThreadPool::takeTask(ThreadPoolBatch *batch)
+{
+    int taskIndex = batch->nextTask++;
+
+    if(batch->nextTask == batch->taskCount)
+    {
+        batchQueue.erase(find(batchQueue.begin(), batchQueue.end(), batch));
+    }
+
+    return taskIndex;
+}
+
+void ThreadPool::executeTask(ThreadPoolBatch *batch, int taskIndex)
+{
+    exception_ptr error;
+
+    try
+    {
+        (*batch->task)(taskIndex);
+    }
+    catch(...)
+    {
+        error = current_exception();
+    }
+
+    // O aviso é feito com o bloqueio, pois quem submeteu o conjunto o destrói assim que todas as tarefas terminam
+    lock_guard<mutex> lock(batch->batchMutex);
+
+    if(error && !batch->error)
+    {
+        batch->error = error;
+    }
+
+    if(++batch->finishedCount == batch->taskCount)
+    {
+        batch->finishedCondition.notify_all();
+    }
+}
+
+void ThreadPool::workerLoop()
+{
+    while(true)
+    {
+        ThreadPoolBatch *batch;
+        int taskIndex;
+
+        {
+            unique_lock<mutex> lock(poolMutex);
+
+            taskCondition.wait(lock, [this]() { return stopWorkers || !batchQueue.empty(); });
+
+            if(batchQueue.empty())
+            {
+                return;
+            }
+
+            batch = batchQueue.front();
+            taskIndex = takeTask(batch);
+        }
+
+        executeTask(batch, taskIndex);
+    }
+}
+
+void ThreadPool::run(int taskCount, const function<void(int)> &task)
+{
+    if(taskCount <= 0)
+    {
+        return;
+    }
+
+    // Sem outras threads ou com uma única tarefa, as tarefas são executadas diretamente
+    if(workerList.empty() || (taskCount == 1))
+    {
+        for(int i = 0; i < taskCount; i++)
+        {
+            task(i);
+        }
+
+        return;
+    }
+
+    ThreadPoolBatch batch(&task, taskCount);
+
+    {
+        lock_guard<mutex> lock(poolMutex);
+        batchQueue.push_back(&batch);
+    }
+
+    taskCondition.notify_all();
+
+    // Executa tarefas do próprio conjunto enquanto houver alguma não iniciada
+    while(true)
+    {
+        int taskIndex;
+
+        {
+            lock_guard<mutex> lock(poolMutex);
+
+            if(batch.nextTask == batch.taskCount)
+            {
+                break;
+            }
+
+            taskIndex = takeTask(&batch);
+        }
+
+        executeTask(&batch, taskIndex);
+    }
+
+    unique_lock<mutex> lock(batch.batchMutex);
+
+    batch.finishedCondition.wait(lock, [&batch]() { return batch.finishedCount == batch.taskCount; });
+
+    if(batch.error)
+    {
+        rethrow_exception(batch.error);
+    }
+}
@@ -0,0 +1,260 @@
+/*
+*   Medição da leitura de arquivos PLY
+*
+*   Compara o tempo de PLYReader::read_ply_file (sem o cache binário, com uma thread e com
+*   todos os núcleos) com o da leitura original do projeto, que lia o corpo linha a linha
+*   com getline e stringstream. As malhas lidas pelos dois caminhos são comparadas pela
+*   quantidade de vértices e de triângulos e pela soma das coordenadas reescaladas
+*
+*   Uso, a partir do diretório CG-T3: PLYReadBenchmark [repetições] [arquivo.ply ...]
+*   (padrão: 5 repetições de data/ply/bunny.ply e data/ply/street.ply, com o melhor tempo
+*   de cada caminho). A ferramenta é compilada pelo alvo PLYBenchmark do projeto ou por
+*
+*   g++ -std=gnu++11 -O2 -pthread -Iinclude tools/PLYReadBenchmark.cpp \
+*       $(find src -name '*.cpp' ! -name main.cpp) -o PLYReadBenchmark -lGL -lglut -lGLU -lpng
+*/
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <functional>
+#include <stdexcept>
+
+#include "ply/PLYReader.h"
+#include "primitive/Quad.h"
+
+using namespace std;
+
+// Leitura original: apenas arquivos ASCII, com as coordenadas nos três primeiros valores do vértice
+static PLYObject* readLegacy(string ply_filepath)
+{
+    ifstream plyFileStream(ply_filepath.c_str());
+
+    if(!plyFileStream.is_open())
+    {
+        throw runtime_error("Não foi possível abrir o arquivo PLY");
+    }
+
+    string tmpFileLine;
+    string tmpLineValue;
+    stringstream strStream;
+
+    getline(plyFileStream, tmpFileLine);
+    strStream.str(tmpFileLine);
+    strStream >> tmpLineValue;
+
+    if(tmpLineValue != "ply")
+    {
+        throw runtime_error("Arquivo PLY inválido");
+    }
+
+    unique_ptr<PLYObject> plyObject(new PLYObject());
+
+    string fileType, fileVersion;
+    getline(plyFileStream, tmpFileLine);
+    strStream.clear();
+    strStream.str(tmpFileLine);
+    strStream >> tmpLineValue >> fileType >> fileVersion;
+
+    if(fileType != "ascii")
+    {
+        throw runtime_error("Formato de arquivo PLY não suportado");
+    }
+
+    plyObject->setFileFormat(PLYFormatVersion(ASCII, fileVersion));
+
+    while(getline(plyFileStream, tmpFileLine))
+    {
+        strStream.clear();
+        strStream.str(tmpFileLine);
+        strStream >> tmpLineValue;
+
+        if(tmpLineValue == "element")
+        {
+            string elementName;
+            int elementCount;
+            strStream >> elementName >> elementCount;
+
+            plyObject->addElement(PLYElement(elementName, elementCount));
+        }
+        else if(tmpLineValue == "end_header")
+        {
+            break;
+        }
+    }
+
+    list<PLYElement> elementList = plyObject->getElementList();
+
+    for(auto it = elementList.begin(); it != elementList.end(); it++)
+    {
+        if((*it).elementName == "vertex")
+        {
+            for(int i = 0; i < (*it).elementCount; i++)
+            {
+                getline(plyFileStream, tmpFileLine);
+
+                double x, y, z;
+                strStream.clear();
+                strStream.str(tmpFileLine);
+                strStream >> x >> y >> z;
+
+                plyObject->addVertex(new Vertex3D(i, x, y, z));
+            }
+        }
+        else if((*it).elementName == "face")
+        {
+            vector<Vertex3D*>* vertexList = plyObject->getVertexList();
+
+            for(int i = 0; i < (*it).elementCount; i++)
+            {
+                getline(plyFileStream, tmpFileLine);
+
+                int v_Count;
+                strStream.clear();
+                strStream.str(tmpFileLine);
+                strStream >> v_Count;
+
+                vector<int> v_Id_arr(max(v_Count, 0));
+
+                for(int j = 0; j < v_Count; j++)
+                {
+                    strStream >> v_Id_arr[j];
+                }
+
+                if(v_Count == 3)
+                {
+                    plyObject->addFace(new Triangle(vertexList->at(v_Id_arr[0]), vertexList->at(v_Id_arr[1]), vertexList->at(v_Id_arr[2])));
+                }
+                else if(v_Count == 4)
+                {
+                    plyObject->addFace(new Quad(vertexList->at(v_Id_arr[0]), vertexList->at(v_Id_arr[1]),
+                                                vertexList->at(v_Id_arr[2]), vertexList->at(v_Id_arr[3])));
+                }
+                else
+                {
+                    throw runtime_error("Primitiva não suportada");
+                }
+            }
+        }
+    }
+
+    plyObject->rescaling();
+
+    return plyObject.release();
+}
+
+// Resumo de uma malha lida, usado para conferir que os dois caminhos leem o mesmo conteúdo
+struct MeshSummary
+{
+    size_t vertexCount;
+    size_t triangleCount;
+    double coordinateSum;
+};
+
+static MeshSummary summarize(PLYObject *plyObject)
+{
+    MeshSummary summary = { 0, 0, 0.0 };
+    vector<Vertex3D*> *vertexList = plyObject->getVertexList();
+    vector<Primitive*> *faceList = plyObject->getFaceList();
+
+    summary.vertexCount = vertexList->size();
+
+    for(unsigned int i = 0; i < vertexList->size(); i++)
+    {
+        summary.coordinateSum += vertexList->at(i)->getX() + vertexList->at(i)->getY() + vertexList->at(i)->getZ();
+    }
+
+    for(unsigned int i = 0; i < faceList->size(); i++)
+    {
+        summary.triangleCount += faceList->at(i)->getVertexList()->size() - 2;
+    }
+
+    return summary;
+}
+
+// Obtém o melhor tempo (em milissegundos) de repetitionCount leituras, guardando o resumo da última
+static double measure(int repetitionCount, const function<PLYObject*()> &read, MeshSummary &summary)
+{
+    double bestTime = HUGE_VAL;
+
+    for(int i = 0; i < repetitionCount; i++)
+    {
+        auto start = chrono::steady_clock::now();
+        PLYObject *plyObject = read();
+        double time = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+        bestTime = min(bestTime, time);
+        summary = summarize(plyObject);
+        delete plyObject;
+    }
+
+    return bestTime;
+}
+
+int main(int argc, char **argv)
+{
+    int repetitionCount = (argc > 1) ? max(1, atoi(argv[1])) : 5;
+    vector<string> pathList;
+
+    for(int i = 2; i < argc; i++)
+    {
+        pathList.push_back(argv[i]);
+    }
+
+    if(pathList.empty())
+    {
+        pathList.push_back("data/ply/bunny.ply");
+        pathList.push_back("data/ply/street.ply");
+    }
+
+    printf("%-28s %12s %12s %12s %9s  %s\n", "arquivo", "original", "1 thread", "N threads", "ganho", "malhas");
+
+    bool allMatch = true;
+
+    for(unsigned int i = 0; i < pathList.size(); i++)
+    {
+        const string &path = pathList[i];
+        MeshSummary legacySummary, serialSummary, parallelSummary;
+
+        try
+        {
+            PLYReader serialReader, parallelReader;
+
+            serialReader.setCacheEnabled(false);
+            serialReader.setThreadCount(1);
+            parallelReader.setCacheEnabled(false);
+
+            double legacyTime = measure(repetitionCount, [&]() { return readLegacy(path); }, legacySummary);
+            double serialTime = measure(repetitionCount, [&]() { return serialReader.read_ply_file(path); }, serialSummary);
+            double parallelTime = measure(repetitionCount, [&]() { return parallelReader.read_ply_file(path); }, parallelSummary);
+
+            // A soma das coordenadas independe da ordem dos vértices, que a leitura atual otimiza para a cache
+            double tolerance = 1e-9 * max<size_t>(1, legacySummary.vertexCount);
+            bool match = (legacySummary.vertexCount == serialSummary.vertexCount) &&
+                         (legacySummary.triangleCount == serialSummary.triangleCount) &&
+                         (fabs(legacySummary.coordinateSum - serialSummary.coordinateSum) <= tolerance) &&
+                         (serialSummary.vertexCount == parallelSummary.vertexCount) &&
+                         (serialSummary.triangleCount == parallelSummary.triangleCount) &&
+                         (fabs(serialSummary.coordinateSum - parallelSummary.coordinateSum) <= tolerance);
+
+            printf("%-28s %9.1f ms %9.1f ms %9.1f ms %8.1fx  %s (%zu vértices, %zu triângulos)\n",
+                   path.c_str(), legacyTime, serialTime, parallelTime, legacyTime / parallelTime,
+                   match ? "iguais" : "DIFERENTES", legacySummary.vertexCount, legacySummary.triangleCount);
+
+            allMatch = allMatch && match;
+        }
+        catch(exception &e)
+        {
+            printf("%-28s erro: %s\n", path.c_str(), e.what());
+            allMatch = false;
+        }
+    }
+
+    return allMatch ? 0 : 1;
+}